@@ -291,15 +291,6 @@ bool AdaTagScanner::isSpecialChar(char c) const
         return false;
 }
 
-bool AdaTagScanner::isSpecialChar(TextField *field) const
-{
-    if(field->m_text.size() == 1)
-    {
-        return isSpecialChar(field->m_text[0].toLatin1());
-    }
-    return false;
-}
-
 
 
 
@@ -1,4 +1,3 @@
-
 //#define ENABLE_DEBUGMSG
 
 /*
@@ -19,16 +18,14 @@
 
 enum
 {
-    COLUMN_NAME = 0,
-    COLUMN_VALUE = 1,
-    COLUMN_TYPE = 2
+    COLUMN_NAME = VarWatchModel::COLUMN_NAME,
+    COLUMN_VALUE = VarWatchModel::COLUMN_VALUE,
+    COLUMN_TYPE = VarWatchModel::COLUMN_TYPE
 };
-#define DATA_COLUMN         (COLUMN_NAME) 
 
 
 AutoVarCtl::AutoVarCtl()
     : m_autoWidget(0)
-    ,m_textColor(Qt::black)
 {
 
 
@@ -44,39 +41,23 @@ void AutoVarCtl::ICore_onStateChanged(ICore::TargetState state)
     
 }
     
-QString AutoVarCtl::getTreeWidgetItemPath(QTreeWidgetItem *item)
-{
-    QTreeWidgetItem *parent = item->parent();
-    if(parent)
-        return getTreeWidgetItemPath(parent) + "/" + item->text(COLUMN_NAME);
-    else
-        return item->text(COLUMN_NAME);
-}
-
 
-void AutoVarCtl::setWidget(QTreeWidget *autoWidget)
+void AutoVarCtl::setWidget(QTreeView *autoWidget)
 {
     m_autoWidget = autoWidget;
 
-    m_textColor = autoWidget->palette().color(QPalette::WindowText);
-    
-        //
-    m_autoWidget->setColumnCount(3);
+    m_autoWidget->setModel(&m_model);
     m_autoWidget->setColumnWidth(COLUMN_NAME, 120);
     m_autoWidget->setColumnWidth(COLUMN_VALUE, 140);
-    QStringList names;
-    names += "Name";
-    names += "Value";
-    names += "Type";
-    m_autoWidget->setHeaderLabels(names);
-    connect(m_autoWidget, SIGNAL(itemChanged ( QTreeWidgetItem * ,int)), this, 
-                            SLOT(onAutoWidgetCurrentItemChanged(QTreeWidgetItem * ,int)));
-    connect(m_autoWidget, SIGNAL(itemDoubleClicked ( QTreeWidgetItem * , int  )), this,
-                            SLOT(onAutoWidgetItemDoubleClicked(QTreeWidgetItem *, int )));
-    connect(m_autoWidget, SIGNAL(itemExpanded ( QTreeWidgetItem * )), this,
-                            SLOT(onAutoWidgetItemExpanded(QTreeWidgetItem * )));
-    connect(m_autoWidget, SIGNAL(itemCollapsed ( QTreeWidgetItem *  )), this,
-                            SLOT(onAutoWidgetItemCollapsed(QTreeWidgetItem * )));
+
+    connect(&m_model, SIGNAL(valueEdited(const QModelIndex &, QString)), this,
+                            SLOT(onAutoWidgetValueEdited(const QModelIndex &, QString)));
+    connect(m_autoWidget, SIGNAL(doubleClicked(const QModelIndex &)), this,
+                            SLOT(onAutoWidgetItemDoubleClicked(const QModelIndex &)));
+    connect(m_autoWidget, SIGNAL(expanded(const QModelIndex &)), this,
+                            SLOT(onAutoWidgetItemExpanded(const QModelIndex &)));
+    connect(m_autoWidget, SIGNAL(collapsed(const QModelIndex &)), this,
+                            SLOT(onAutoWidgetItemCollapsed(const QModelIndex &)));
 
     m_autoWidget->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(m_autoWidget, SIGNAL(customContextMenuRequested(const QPoint &)), this, SLOT(onContextMenu(const QPoint&)));
@@ -137,13 +118,11 @@ quint64 AutoVarCtl::getAddress(VarWatch &w)
 
 void AutoVarCtl::onShowMemory()
 {
-    QList<QTreeWidgetItem *> selectedItems = m_autoWidget->selectedItems();
+    QModelIndexList indexList = m_autoWidget->selectionModel()->selectedRows();
     Core &core = Core::getInstance();
-    if(!selectedItems.empty())
+    if(!indexList.empty())
     {
-        QTreeWidgetItem *item = selectedItems[0];
-
-        QString watchId = getWatchId(item);
+        QString watchId = m_model.getWatchId(indexList[0]);
         VarWatch *watch = NULL;
         if(!watchId.isEmpty())
             watch = core.getVarWatchInfo(watchId);
@@ -160,9 +139,9 @@ void AutoVarCtl::onShowMemory()
 }
 
 
-void AutoVarCtl::onAutoWidgetItemCollapsed(QTreeWidgetItem *item)
+void AutoVarCtl::onAutoWidgetItemCollapsed(const QModelIndex &index)
 {
-    QString varPath = getTreeWidgetItemPath(item);
+    QString varPath = m_model.getPath(index);
     if(m_autoVarDispInfo.contains(varPath))
     {
         VarCtl::DispInfo &dispInfo = m_autoVarDispInfo[varPath];
@@ -172,9 +151,9 @@ void AutoVarCtl::onAutoWidgetItemCollapsed(QTreeWidgetItem *item)
 }
 
 
-void AutoVarCtl::onAutoWidgetItemExpanded(QTreeWidgetItem *item)
+void AutoVarCtl::onAutoWidgetItemExpanded(const QModelIndex &index)
 {
-    QString varPath = getTreeWidgetItemPath(item);
+    QString varPath = m_model.getPath(index);
     debugMsg("%s(varPath:'%s')", __func__, stringToCStr(varPath));
     if(m_autoVarDispInfo.contains(varPath))
     {
@@ -186,60 +165,33 @@ void AutoVarCtl::onAutoWidgetItemExpanded(QTreeWidgetItem *item)
     assert(0);
 
     Core &core = Core::getInstance();
-    //QTreeWidget *varWidget = m_autoWidget;
 
     // Get watchid of the item
-    QString watchId = getWatchId(item);
+    QString watchId = m_model.getWatchId(index);
     
 
     // Get the children
-    //if(!watchId.isEmpty())
-    core.gdbExpandVarWatchChildren(watchId);
+    if(!watchId.isEmpty() && m_model.rowCount(index) == 0)
+        core.gdbExpandVarWatchChildren(watchId);
     
 
 }
 
 
-void AutoVarCtl::onAutoWidgetItemDoubleClicked(QTreeWidgetItem *item, int column)
+void AutoVarCtl::onAutoWidgetItemDoubleClicked(const QModelIndex &index)
 {
-    QTreeWidget *varWidget = m_autoWidget;
-
-    if(column == COLUMN_VALUE)
-        varWidget->editItem(item,column);
+    if(index.column() == COLUMN_VALUE)
+        m_autoWidget->edit(index);
     else
     {
-        AutoSignalBlocker autoBlocker(m_autoWidget);
-
-        QString varName = item->text(COLUMN_NAME);
-        QString watchId = getWatchId(item);
-        QString varPath = getTreeWidgetItemPath(item);
+        QString varPath = m_model.getPath(index);
              
         if(m_autoVarDispInfo.contains(varPath))
         {
             VarCtl::DispInfo &dispInfo = m_autoVarDispInfo[varPath];
-            {
-                
-                if(dispInfo.dispFormat == VarCtl::DISP_DEC)
-                {
-                    dispInfo.dispFormat = VarCtl::DISP_HEX;
-                }
-                else if(dispInfo.dispFormat == VarCtl::DISP_HEX)
-                {
-                    dispInfo.dispFormat = VarCtl::DISP_BIN;
-                }
-                else if(dispInfo.dispFormat == VarCtl::DISP_BIN)
-                {
-                    dispInfo.dispFormat = VarCtl::DISP_CHAR;
-                }
-                else if(dispInfo.dispFormat == VarCtl::DISP_CHAR)
-                {
-                    dispInfo.dispFormat = VarCtl::DISP_DEC;
-                }
-
-                QString valueText = getDisplayString(watchId, varPath);
-                
-                item->setText(1, valueText);
-            }
+            dispInfo.dispFormat = VarCtl::nextDispFormat(dispInfo.dispFormat);
+
+            m_model.setDispFormat(index, dispInfo.dispFormat);
         }
     }
 }
@@ -247,202 +199,66 @@ void AutoVarCtl::onAutoWidgetItemDoubleClicked(QTreeWidgetItem *item, int column
 
 void AutoVarCtl::ICore_onWatchVarChanged(VarWatch &watch)
 {
-    Q_UNUSED(watch);
-}
-
-QString AutoVarCtl::getWatchId(QTreeWidgetItem* item)
-{
-    return item->data(DATA_COLUMN, Qt::UserRole).toString();
+    m_model.updateWatch(watch.getWatchId());
 }
 
 
 /**
-* @brief Locates a treeitem based on a watchid.
-* @param watchId    The id.
-* @return The found item or NULL if no was found.
-*/
-QTreeWidgetItem* AutoVarCtl::priv_findItemByWatchId(QString watchId)
+ * @brief Applies the display state that the variable had at the last stop.
+ */
+void AutoVarCtl::restoreDispInfo(const QModelIndex &index)
 {
-    QTreeWidgetItem *item = NULL;
-    QTreeWidget *varWidget = m_autoWidget;
+    QString varPath = m_model.getPath(index);
+    if(m_autoVarDispInfo.contains(varPath) == false)
+    {
+        VarCtl::DispInfo dispInfo;
+        dispInfo.dispFormat = DISP_NATIVE;
+        dispInfo.isExpanded = false;
 
+        debugMsg("Adding '%s'", stringToCStr(varPath));
 
-    //
-    QTreeWidgetItem * rootItem = varWidget->invisibleRootItem();
-    QString thisWatchId;
-    QStringList watchIdParts = watchId.split('.');
-    for(int partIdx = 0; partIdx < watchIdParts.size();partIdx++)
-    {
-        // Get the watchid to look for
-        if(thisWatchId != "")
-            thisWatchId += ".";
-        thisWatchId += watchIdParts[partIdx];
-
-        // Look for the item with the specified watchId
-        QTreeWidgetItem* foundItem = NULL;
-        for(int i = 0;foundItem == NULL && i < rootItem->childCount();i++)
-        {
-            QTreeWidgetItem* item =  rootItem->child(i);
-            QString itemKey = item->data(DATA_COLUMN, Qt::UserRole).toString();
+        m_autoVarDispInfo[varPath] = dispInfo;
+    }
+    VarCtl::DispInfo &dispInfo = m_autoVarDispInfo[varPath];
+    m_model.setDispFormat(index, dispInfo.dispFormat);
 
-            if(thisWatchId == itemKey)
-            {
-                foundItem = item;
-            }
-        }
+    // Color the text based on if the value is different
+    QString valueString = m_model.getDisplayString(index);
+    m_model.setChanged(index, dispInfo.lastData != valueString);
+    dispInfo.lastData = valueString;
 
-        // This watch belonged to the AutoWidget?
-        if(partIdx == 0 && foundItem == NULL)
-        {
-            return NULL;
-        }
+    // Expanding adds more entries to the map so do not use dispInfo after this
+    if(dispInfo.isExpanded && m_model.hasChildren(index))
+    {
+        Core &core = Core::getInstance();
 
-        if(foundItem == NULL)
-            return NULL;
-            
-        item = foundItem;
-        rootItem = foundItem;
+        // Get the children
+        core.gdbExpandVarWatchChildren(m_model.getWatchId(index));
+
+        AutoSignalBlocker autoBlocker(m_autoWidget);
+        m_autoWidget->expand(index);
     }
-    
-    return item;
-    
 }
 
 
-
 void AutoVarCtl::ICore_onWatchVarChildAdded(VarWatch &watch)
 {
-    Core &core = Core::getInstance();
-    QTreeWidget *varWidget = m_autoWidget;
-    QString watchId = watch.getWatchId();
-    QString name = watch.getName();
-    QString varType = watch.getVarType();
-    bool hasChildren  = watch.hasChildren();
-    bool inScope = watch.inScope();
-    
-    debugMsg("%s(name:'%s')",__func__, stringToCStr(name));
-
+    debugMsg("%s(name:'%s')",__func__, stringToCStr(watch.getName()));
 
-    AutoSignalBlocker autoBlocker(m_autoWidget);
-
-    //
-    QTreeWidgetItem * rootItem = varWidget->invisibleRootItem();
-    QStringList watchIdParts = watchId.split('.');
-    QString thisWatchId;
-
-
-    for(int partIdx = 0; partIdx < watchIdParts.size();partIdx++)
+    // Already shown?
+    QModelIndex index = m_model.findIndex(watch.getWatchId());
+    if(index.isValid())
     {
-        // Get the watchid to look for
-        if(thisWatchId != "")
-            thisWatchId += ".";
-        thisWatchId += watchIdParts[partIdx];
-
-        // Look for the item with the specified watchId
-        QTreeWidgetItem* foundItem = NULL;
-        for(int i = 0;foundItem == NULL && i < rootItem->childCount();i++)
-        {
-            QTreeWidgetItem* item =  rootItem->child(i);
-            QString itemKey = getWatchId(item);
-
-            if(thisWatchId == itemKey)
-            {
-                foundItem = item;
-            }
-        }
-
-        // This watch belonged to the WatchWidget?
-        if(partIdx == 0 && foundItem == NULL)
-        {
-            return;
-        }
-        
-        // Did not find one?
-        QTreeWidgetItem *item;
-        if(foundItem == NULL)
-        {
-            debugMsg("Adding '%s'", stringToCStr(name));
-
-            // Create the item
-            QStringList nameList;
-            nameList += name;
-            nameList += "";
-            nameList += varType;
-            item = new QTreeWidgetItem(nameList);
-            item->setData(DATA_COLUMN, Qt::UserRole, thisWatchId);
-            item->setFlags(Qt::ItemIsEditable | Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-            rootItem->addChild(item);
-            rootItem = item;
-
-
-            if(hasChildren)
-                rootItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
-
-            
-        
-        }
-        else
-        {
-            item = foundItem;
-            rootItem = foundItem;
-        }
-
-        // The last part of the id?
-        if(partIdx+1 == watchIdParts.size())
-        {
-            // Update the text
-            QString varPath = getTreeWidgetItemPath(item);
-            VarCtl::DispInfo dispInfo;
-            if(m_autoVarDispInfo.contains(varPath) == false)
-            {
-                dispInfo.dispFormat = DISP_NATIVE;
-                dispInfo.isExpanded = false;
-
-                debugMsg("Adding '%s'", stringToCStr(varPath));
-
-
-                m_autoVarDispInfo[varPath] = dispInfo;
-            }
-            else
-            {
-                dispInfo = m_autoVarDispInfo[varPath];
-            }
-            QString valueString = getDisplayString(watchId, varPath);
-  
-            bool enable = inScope;
-
-            if(!enable)
-                item->setDisabled(true);
-            else
-                item->setDisabled(false);
-            
-
-            item->setText(COLUMN_VALUE, valueString);
-
-            // Color the text based on if the value is different
-            VarCtl::DispInfo &newDispInfo = m_autoVarDispInfo[varPath];
-            QBrush b;
-            if(newDispInfo.lastData != valueString)
-                b = QBrush(Qt::red);
-            else
-                b = m_textColor;
-            item->setForeground(COLUMN_VALUE,b);
-            newDispInfo.lastData = valueString;
-
-
-            if(dispInfo.isExpanded && hasChildren)
-            {
-                
-
-
-                // Get the children
-                core.gdbExpandVarWatchChildren(watchId);
-                varWidget->expandItem(item);
-            }
-        }
+        m_model.updateWatch(watch.getWatchId());
+        return;
     }
 
-    
+    // This watch belonged to the WatchWidget?
+    index = m_model.addChild(watch);
+    if(!index.isValid())
+        return;
+
+    restoreDispInfo(index);
 }
 
 
@@ -459,77 +275,16 @@ void AutoVarCtl::ICore_onLocalVarChanged(QStringList varNames)
 }
 
 
-/**
- * @brief Returns the value text to show for an item.
- * @param varPath    The path to the variable (Eg: "myStruct/var2")   
- */
-QString AutoVarCtl::getDisplayString(QString watchId, QString varPath)
-{
-    QString displayValue;
-    Core &core = Core::getInstance();
-
-    //debugMsg("%s(watchId:'%s' varPath:'%s')", __func__, qPrintable(watchId), qPrintable(varPath));
-
-    // Create value if not exist
-    if(!m_autoVarDispInfo.contains(varPath))
-    {
-        VarCtl::DispInfo dispInfo;
-        dispInfo.dispFormat = DISP_NATIVE;
-        dispInfo.isExpanded = false;
-        m_autoVarDispInfo[varPath] = dispInfo;
-    }
-
-    VarWatch *watch = NULL;
-    if(!watchId.isEmpty())
-        watch = core.getVarWatchInfo(watchId);
-    if(watch)
-    {
-        VarCtl::DispInfo &dispInfo = m_autoVarDispInfo[varPath];
-
-        switch(dispInfo.dispFormat)
-        {
-            default:
-            case DISP_NATIVE:
-                displayValue = watch->getValue(CoreVar::FMT_NATIVE);break;
-            case DISP_DEC:
-                displayValue = watch->getValue(CoreVar::FMT_DEC);break;
-            case DISP_BIN:
-                displayValue = watch->getValue(CoreVar::FMT_BIN);break;
-            case DISP_HEX:
-                displayValue = watch->getValue(CoreVar::FMT_HEX);break;
-            case DISP_CHAR:
-                displayValue = watch->getValue(CoreVar::FMT_CHAR);break;
-        }
-
-    }
-    return displayValue;
-}
-
 void AutoVarCtl::clear()
 {
-    QTreeWidget *autoWidget = m_autoWidget;
-    QTreeWidgetItem *rootItem = m_autoWidget->invisibleRootItem();
+    Core &core = Core::getInstance();
 
     debugMsg("%s()", __func__);
 
-    // Get all items
-    QList<QTreeWidgetItem *>items;
-    for(int i =0;i < rootItem->childCount();i++)
-    {
-        QTreeWidgetItem *item = rootItem->child(i);
-
-        items.push_back(item);
-    }
-    
-
-    // Loop through the items
-    while(!items.isEmpty())
+    // Remove the watches of all items
+    for(int i =0;i < m_model.rowCount();i++)
     {
-        QTreeWidgetItem *item = items.takeFirst();
-    
-        // Delete the item
-        Core &core = Core::getInstance();
-        QString watchId = getWatchId(item);
+        QString watchId = m_model.getWatchId(m_model.index(i, COLUMN_NAME));
         if(watchId != "")
         {
             //debugMsg("calling gdbRemoveVarWatch('%s')", stringToCStr(watchId));
@@ -537,7 +292,7 @@ void AutoVarCtl::clear()
         }
     }
 
-    autoWidget->clear();
+    m_model.clear();
 
 }
 
@@ -572,40 +327,24 @@ void AutoVarCtl::onDisplayAsChar()
 
 
 
-
-
-
-void 
-AutoVarCtl::onAutoWidgetCurrentItemChanged( QTreeWidgetItem * current, int column )
+/**
+ * @brief Called when the user has changed the value of an item.
+ */
+void AutoVarCtl::onAutoWidgetValueEdited(const QModelIndex &index, QString newValue)
 {
-    //QTreeWidget *varWidget = m_autoWidget;
     Core &core = Core::getInstance();
-    QString oldKey = getWatchId(current);
-    
-    if(column != COLUMN_VALUE)
+    QString watchId = m_model.getWatchId(index);
+    if(watchId.isEmpty())
         return;
-        
-    AutoSignalBlocker autoBlocker(m_autoWidget);
 
-    //debugMsg("%s(key:'%s')", __func__, qPrintable(oldKey));
-    
-    
-    VarWatch *watch = NULL;
-    watch = core.getVarWatchInfo(oldKey);
+    VarWatch *watch = core.getVarWatchInfo(watchId);
     if(watch)
     {
-        QString oldValue  = watch->getValue();
-        QString varPath = getTreeWidgetItemPath(current);
-        QString oldValueText = getDisplayString(oldKey, varPath);
-        QString newValue = current->text(COLUMN_VALUE);
+        QString oldValueText = m_model.getDisplayString(index);
 
+        // The model shows the value from Core so a failed change needs no undo
         if (oldValueText != newValue)
-        {
-            if(core.changeWatchVariable(oldKey, newValue))
-            {
-                current->setText(COLUMN_VALUE, oldValue);
-            }
-        }
+            core.changeWatchVariable(watchId, newValue);
     }
 
 
@@ -619,29 +358,19 @@ AutoVarCtl::onAutoWidgetCurrentItemChanged( QTreeWidgetItem * current, int colum
  */
 void AutoVarCtl::selectedChangeDisplayFormat(VarCtl::DispFormat fmt)
 {
-    AutoSignalBlocker autoBlocker(m_autoWidget);
-
     // Loop through the selected items.
-    QList<QTreeWidgetItem *> items = m_autoWidget->selectedItems();
-    for(int i =0;i < items.size();i++)
+    QModelIndexList indexList = m_autoWidget->selectionModel()->selectedRows();
+    for(int i =0;i < indexList.size();i++)
     {
-        QTreeWidgetItem *item = items[i];
-    
-        QString varPath = getTreeWidgetItemPath(item);
-        QString varName = item->text(COLUMN_NAME);
-        QString watchId = getWatchId(item);
-        
+        QModelIndex index = indexList[i];
+        QString varPath = m_model.getPath(index);
         
         if(m_autoVarDispInfo.contains(varPath))
         {
             VarCtl::DispInfo &dispInfo = m_autoVarDispInfo[varPath];
-            {
-                dispInfo.dispFormat = fmt;
-           
-                QString valueText = getDisplayString(watchId, varPath);
+            dispInfo.dispFormat = fmt;
 
-                item->setText(COLUMN_VALUE, valueText);
-            }
+            m_model.setDispFormat(index, fmt);
         }
         else
         {
@@ -662,76 +391,17 @@ void AutoVarCtl::selectedChangeDisplayFormat(VarCtl::DispFormat fmt)
  */
 void AutoVarCtl::addNewWatch(QString varName)
 {
-    QString newName = varName;
     Core &core = Core::getInstance();
     
     //debugMsg("%s('%s')", __func__, stringToCStr(varName));
 
-
-        VarWatch *watch = NULL;
-        if(core.gdbAddVarWatch(newName, &watch) == 0)
-        {
-            QString watchId = watch->getWatchId();
-            QString varType = watch->getVarType();
-
-            bool hasChildren = watch->hasChildren();
-
-    QTreeWidget *varWidget = m_autoWidget;
-
-// Create a new dummy item
-            QTreeWidgetItem *item;
-            QStringList names;
-            names += varName;
-            item = new QTreeWidgetItem(names);
-            item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable);
-            varWidget->addTopLevelItem(item);
-
-
-            QTreeWidgetItem *current = item;
-            
-
-            
-            if(hasChildren)
-                current->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
-
-            QString varPath = getTreeWidgetItemPath(current);
-            QString value  = getDisplayString(watchId, varPath);
-            if(!m_autoVarDispInfo.contains(varPath))
-            {
-                VarCtl::DispInfo newDispInfo;
-                newDispInfo.dispFormat = DISP_NATIVE;
-
-                debugMsg("Adding '%s'", stringToCStr(varPath));
-                m_autoVarDispInfo[varPath] = newDispInfo;
-            }
-
-            VarCtl::DispInfo &dispInfo = m_autoVarDispInfo[varPath];
-                
-        
-            current->setData(DATA_COLUMN, Qt::UserRole, watchId);
-            current->setText(COLUMN_VALUE, value);
-            current->setText(COLUMN_TYPE, varType);
-
-            // Set color based on if the value has changed
-            QBrush b;
-            if(dispInfo.lastData != value)
-                b = QBrush(Qt::red);
-            else
-                b = m_textColor;
-            current->setForeground(COLUMN_VALUE,b);
-            dispInfo.lastData = value;
-
-            
-
-    //
-    if(m_autoVarDispInfo.contains(varPath))
+    VarWatch *watch = NULL;
+    if(core.gdbAddVarWatch(varName, &watch) == 0)
     {
-        if(m_autoVarDispInfo[varPath].isExpanded)
-        {
-            m_autoWidget->expandItem(current);
-        }
+        QModelIndex index = m_model.appendRoot(watch->getWatchId(), varName);
+
+        restoreDispInfo(index);
     }
-        }
 
 }
 
@@ -742,10 +412,10 @@ void AutoVarCtl::onKeyPress(QKeyEvent *keyEvent)
     if(keyEvent->key() == Qt::Key_Return)
     {
         // Get the active unit
-        QTreeWidgetItem * item = m_autoWidget->currentItem();
-        if(item)
+        QModelIndex index = m_autoWidget->currentIndex();
+        if(index.isValid())
         {
-            m_autoWidget->editItem(item,COLUMN_VALUE);
+            m_autoWidget->edit(m_model.index(index.row(), COLUMN_VALUE, index.parent()));
         }   
     }
 
@@ -757,34 +427,23 @@ void AutoVarCtl::onKeyPress(QKeyEvent *keyEvent)
 */
 void AutoVarCtl::ICore_onWatchVarDeleted(VarWatch &watch)
 {
-    AutoSignalBlocker autoBlocker(m_autoWidget);
-
     //debugMsg("%s('%s')", __func__, stringToCStr(watch.getWatchId()));
 
-    QTreeWidgetItem* item = priv_findItemByWatchId(watch.getWatchId());
-
-    if(!item)
+    QModelIndex index = m_model.findIndex(watch.getWatchId());
+    if(!index.isValid())
     {
         //debugMsg("watch %s is not ours!", stringToCStr(watch.getWatchId()));
         return;
     }
+
     // Get the root item for the item
-    while(item->parent() != NULL)
+    while(index.parent().isValid())
     {
-        item = item->parent();
+        index = index.parent();
     }
 
-
     // Delete the item
-    QString watchId = item->data(DATA_COLUMN, Qt::UserRole).toString();
-    if(watchId != "")
-    {
-        QTreeWidgetItem *rootItem = m_autoWidget->invisibleRootItem();
-        rootItem->removeChild(item);
-    }
-
-
-
+    m_model.removeRoot(index.row());
 
 }
 
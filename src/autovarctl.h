@@ -10,7 +10,7 @@
 #define FILE__AUTO_VAR_CTL_H
 
 #include <QString>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QMenu>
 #include <QKeyEvent>
 
@@ -18,6 +18,7 @@
 #include "core.h"
 #include "varctl.h"
 #include "settings.h"
+#include "varwatchmodel.h"
 
 /**
 * @brief Displays local variables (on the stack).
@@ -29,7 +30,7 @@ class AutoVarCtl : public VarCtl
 public:
     AutoVarCtl();
     
-    void setWidget(QTreeWidget *autoWidget);
+    void setWidget(QTreeView *autoWidget);
 
     void ICore_onWatchVarChanged(VarWatch &watch);
     void ICore_onWatchVarChildAdded(VarWatch &watch);
@@ -45,21 +46,17 @@ public:
 
     void ICore_onStateChanged(ICore::TargetState state);
 private:
-    QTreeWidgetItem* priv_findItemByWatchId(QString watchId);
     quint64 getAddress(VarWatch &w);
-    QString getWatchId(QTreeWidgetItem* item);
 
     void selectedChangeDisplayFormat(VarCtl::DispFormat fmt);
-    QString getTreeWidgetItemPath(QTreeWidgetItem *item);
-
-    QString getDisplayString(QString watchId, QString varPath);
+    void restoreDispInfo(const QModelIndex &index);
     
     
 public slots:
-    void onAutoWidgetItemDoubleClicked(QTreeWidgetItem *item, int column);
-    void onAutoWidgetCurrentItemChanged ( QTreeWidgetItem * current, int column );
-    void onAutoWidgetItemExpanded(QTreeWidgetItem *item );
-    void onAutoWidgetItemCollapsed(QTreeWidgetItem *item);
+    void onAutoWidgetItemDoubleClicked(const QModelIndex &index);
+    void onAutoWidgetValueEdited(const QModelIndex &index, QString newValue);
+    void onAutoWidgetItemExpanded(const QModelIndex &index);
+    void onAutoWidgetItemCollapsed(const QModelIndex &index);
 
     void onContextMenu ( const QPoint &pos);
     void onShowMemory();
@@ -74,12 +71,12 @@ private:
     void clear();
 
 private:
-    QTreeWidget *m_autoWidget;
+    QTreeView *m_autoWidget;
+    VarWatchModel m_model;
     QMenu m_popupMenu;
     
-    VarCtl::DispInfoMap m_autoVarDispInfo;
+    VarCtl::DispInfoMap m_autoVarDispInfo; //!< Display state by variable path (Eg: "myStruct/var2"), kept between stops.
     Settings m_cfg;
-    QColor m_textColor; //!< Color to use for text in the widget
 };
 
 
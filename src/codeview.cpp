@@ -15,7 +15,9 @@
 #include <QPaintEvent>
 #include <QColor>
 #include <assert.h>
+#include <algorithm>
 
+#include "config.h"
 #include "log.h"
 #include "syntaxhighlighter.h"
 #include "util.h"
@@ -37,6 +39,7 @@ CodeView::CodeView()
 #endif
     m_fontInfo = new QFontMetrics(m_font);
     m_cursorY = 0;
+    m_maxLineHits = 0;
 
     m_timer.setSingleShot(true);
     connect(&m_timer, SIGNAL(timeout()), this, SLOT(onTimerTimeout()));
@@ -101,22 +104,23 @@ void CodeView::onTimerTimeout()
     }
    
     // Hover mouse over a text row?
-    TextField *foundField = NULL;
+    const TextField *foundField = NULL;
     int rowHeight = getRowHeight();
     int rowIdx = mousePos.y() / rowHeight;
     if(rowIdx >= 0 && rowIdx < (int)m_highlighter->getRowCount())
     {
         // Get the words in the line
-        QVector<TextField*> cols = m_highlighter->getRow(rowIdx);
+        int fieldCount = 0;
+        const TextField *fields = m_highlighter->getRow(rowIdx, &fieldCount);
         
         // Find the word under the cursor
         int x = getBorderWidth()+10;
         int foundPos = -1;
         int j;
-        for(j = 0;j < cols.size() && foundPos == -1;j++)
+        for(j = 0;j < fieldCount && foundPos == -1;j++)
         {
-            TextField *field = cols[j];            
-            int w = m_fontInfo->horizontalAdvance(field->m_text);
+            const TextField *field = &fields[j];
+            int w = m_fontInfo->horizontalAdvance(m_highlighter->getText(*field));
             if(x <= mousePos.x() && mousePos.x() <= x+w)
             {
                 foundField = field;
@@ -134,7 +138,7 @@ void CodeView::onTimerTimeout()
             foundField = NULL;
         else
         {
-            QString text = foundField->m_text;
+            QString text = m_highlighter->getText(*foundField);
             if(text.isEmpty())
                 foundField = NULL;
             // Variable?
@@ -152,7 +156,7 @@ void CodeView::onTimerTimeout()
         m_infoWindow.move(menuPos);
 
 
-        m_infoWindow.show(foundField->m_text);    
+        m_infoWindow.show(m_highlighter->getText(*foundField));    
 
     }
     else
@@ -183,6 +187,7 @@ void CodeView::setPlainText(QString text, CodeType type)
     m_highlighter->setConfig(m_cfg);
 
     m_highlighter->colorize(text);
+    clearRowCache();
 
 //    m_rows = text.split("\n");
 
@@ -227,10 +232,22 @@ void CodeView::paintEvent ( QPaintEvent * event )
     painter.fillRect(rect, borderColor);
 
 
+    int startRowIdx = std::max(0,(paintRect.top()/rowHeight) - 1);
+    size_t endRowIdx = (size_t)std::min((int)m_highlighter->getRowCount(),(int)(paintRect.bottom()/rowHeight) + 1);
+
+    // Mark the lines that have code
+    QVector<int>::const_iterator codeIt = std::lower_bound(m_codeLines.constBegin(), m_codeLines.constEnd(), startRowIdx+1);
+    for(;codeIt != m_codeLines.constEnd() && *codeIt <= (int)endRowIdx;++codeIt)
+    {
+        int y = rowHeight*(*codeIt-1);
+        painter.fillRect(QRect(0,y+1,2,rowHeight-2), QColor(120,120,120));
+    }
+
     // Show breakpoints
-    for(int j = 0;j < m_breakpointList.size();j++)
+    QVector<int>::const_iterator bkptIt = std::lower_bound(m_breakpointList.constBegin(), m_breakpointList.constEnd(), startRowIdx+1);
+    for(;bkptIt != m_breakpointList.constEnd() && *bkptIt <= (int)endRowIdx;++bkptIt)
     {
-        int lineNo = m_breakpointList[j];
+        int lineNo = *bkptIt;
         int rowIdx = lineNo-1;
         int y = rowHeight*rowIdx;
         QRect rect2(2,y,getBorderWidth()-3,rowHeight);
@@ -240,14 +257,10 @@ void CodeView::paintEvent ( QPaintEvent * event )
     
     // Draw content
     painter.setFont(m_font);
-    int maxLineDigits = QString::number(m_highlighter->getRowCount()).length();
-    int startRowIdx = std::max(0,(paintRect.top()/rowHeight) - 1);
-    size_t endRowIdx = (size_t)std::min((int)m_highlighter->getRowCount(),(int)(paintRect.bottom()/rowHeight) + 1);
     for(size_t rowIdx = startRowIdx;rowIdx < endRowIdx;rowIdx++)
     {
         //int x = BORDER_WIDTH+10;
         int y = rowHeight*rowIdx;
-        QString nrText;
 
 
         // Draw current line cursor
@@ -268,29 +281,34 @@ void CodeView::paintEvent ( QPaintEvent * event )
             }
         }
 
+        // Draw the number of profiler samples as a bar in the border
+        if(m_maxLineHits > 0)
+        {
+            int hits = m_lineHits.value(rowIdx+1, 0);
+            if(hits > 0)
+            {
+                int barWidth = std::max(1, ((getBorderWidth()-3) * hits) / m_maxLineHits);
+                QRect rect2(getBorderWidth()-barWidth, y+1, barWidth, rowHeight-2);
+                painter.fillRect(rect2, QColor(200,80,40));
+            }
+        }
+
+        const CachedRow &row = getCachedRow(rowIdx);
+
         // Draw line number
-        int fontY = y+(rowHeight-(m_fontInfo->ascent()+m_fontInfo->descent()))/2+m_fontInfo->ascent();
+        int textY = y+(rowHeight-(m_fontInfo->ascent()+m_fontInfo->descent()))/2;
         if(m_cfg->m_showLineNo)
         {
             painter.setPen(Qt::white);
-            nrText = QString::number(rowIdx+1).rightJustified(maxLineDigits);
-            painter.drawText(4, fontY, nrText);
+            painter.drawStaticText(4, textY, row.m_lineNo);
         }
 
-        // Draw line text
-        QVector<TextField*> cols = m_highlighter->getRow(rowIdx);
-
         int x = getBorderWidth()+10;
 
         // Draw search selection
         if(m_incSearchStartPosRow == (int)rowIdx)
         {
-            QString fullRowText;
-            for(int j = 0;j < cols.size();j++)
-            {
-                TextField *field = cols[j];            
-                fullRowText += field->m_text;
-            }
+            QString fullRowText = m_highlighter->getRowText(rowIdx);
             int selPosX = x + m_fontInfo->horizontalAdvance(fullRowText.left(m_incSearchStartPosColumn));
             int selPosWidth = m_fontInfo->horizontalAdvance(fullRowText.mid(m_incSearchStartPosColumn, m_incSearchText.length()));
             QRect rect2(selPosX, y, selPosWidth, rowHeight);
@@ -299,26 +317,89 @@ void CodeView::paintEvent ( QPaintEvent * event )
         }
 
         // Draw text
-        for(int j = 0;j < cols.size();j++)
+        for(int j = 0;j < row.m_fields.size();j++)
         {
-            TextField *field = cols[j];            
+            const CachedField &field = row.m_fields[j];
+            painter.setPen(field.m_color);
+            painter.drawStaticText(x + field.m_x, textY, field.m_text);
+        }
+    }
+
 
-            painter.setPen(field->m_color);
-            painter.drawText(x, fontY, field->m_text);
+}
 
-            x += m_fontInfo->horizontalAdvance(field->m_text);
 
+/**
+ * @brief Returns a row prepared for drawing.
+ *
+ * The layout of the text fields is only done the first time a row is
+ * drawn. The returned row is valid until the next call.
+ */
+const CodeView::CachedRow &CodeView::getCachedRow(int rowIdx)
+{
+    QHash<int, CachedRow>::iterator it = m_rowCache.find(rowIdx);
+    if(it != m_rowCache.end())
+        return it.value();
+
+    if(m_rowCache.size() >= CODEVIEW_ROW_CACHE_SIZE)
+        m_rowCache.clear();
+
+    CachedRow &row = m_rowCache[rowIdx];
+
+    int maxLineDigits = QString::number(m_highlighter->getRowCount()).length();
+    row.m_lineNo.setTextFormat(Qt::PlainText);
+    row.m_lineNo.setText(QString::number(rowIdx+1).rightJustified(maxLineDigits));
+    row.m_lineNo.prepare(QTransform(), m_font);
+
+    int fieldCount = 0;
+    const TextField *fields = m_highlighter->getRow(rowIdx, &fieldCount);
+    int x = 0;
+    for(int j = 0;j < fieldCount;j++)
+    {
+        const TextField &field = fields[j];
+        QString fieldText = m_highlighter->getText(field);
+        if(!field.isSpaces())
+        {
+            CachedField cachedField;
+            cachedField.m_text.setTextFormat(Qt::PlainText);
+            cachedField.m_text.setPerformanceHint(QStaticText::AggressiveCaching);
+            cachedField.m_text.setText(fieldText);
+            cachedField.m_text.prepare(QTransform(), m_font);
+            cachedField.m_x = x;
+            cachedField.m_color = m_highlighter->getColor(field);
+            row.m_fields.append(cachedField);
         }
+        x += m_fontInfo->horizontalAdvance(fieldText);
     }
+    return row;
+}
 
 
+/**
+ * @brief Removes the prepared rows (when the text, colors or font has changed).
+ */
+void CodeView::clearRowCache()
+{
+    m_rowCache.clear();
+}
+
+
+/**
+ * @brief Returns the area of a row including the current line marker.
+ * @param lineNo   The line (1=first).
+ */
+QRect CodeView::getRowRect(int lineNo)
+{
+    int rowHeight = getRowHeight();
+    return QRect(0, rowHeight*(lineNo-1)-2, width(), rowHeight+4);
 }
 
 
 void CodeView::disableCurrentLine()
 {
+    if(m_cursorY > 0)
+        update(getRowRect(m_cursorY));
     m_cursorY = -1;
-    update();
 }
 
 
@@ -328,11 +409,14 @@ void CodeView::disableCurrentLine()
  */
 void CodeView::setCurrentLine(int lineNo)
 {
+    // Only repaint the old and the new line
+    if(m_cursorY > 0)
+        update(getRowRect(m_cursorY));
     m_cursorY = lineNo;
+    if(m_cursorY > 0)
+        update(getRowRect(m_cursorY));
 
     hideInfoWindow();
-    
-    update();
 }
 
 
@@ -364,15 +448,15 @@ void CodeView::mousePressEvent( QMouseEvent * event )
         if(rowIdx >= 0 && rowIdx < (int)m_highlighter->getRowCount())
         {
             // Get the words in the line
-            QVector<TextField*> cols = m_highlighter->getRow(rowIdx);
+            int fieldCount = 0;
+            const TextField *fields = m_highlighter->getRow(rowIdx, &fieldCount);
             
             // Find the word under the cursor
             int x = getBorderWidth()+10;
             int foundPos = -1;
-            for(j = 0;j < cols.size() && foundPos == -1;j++)
+            for(j = 0;j < fieldCount && foundPos == -1;j++)
             {
-                TextField *field = cols[j];            
-                int w = m_fontInfo->horizontalAdvance(field->m_text);
+                int w = m_fontInfo->horizontalAdvance(m_highlighter->getText(fields[j]));
                 if(x <= event->pos().x() && event->pos().x() <= x+w)
                 {
                     foundPos = j;
@@ -386,9 +470,9 @@ void CodeView::mousePressEvent( QMouseEvent * event )
                 
                 while(foundPos >= 0)
                 {
-                    if(cols[foundPos]->isSpaces() ||
-                        m_highlighter->isKeyword(cols[foundPos]->m_text)
-                        || m_highlighter->isSpecialChar(cols[foundPos]))
+                    if(fields[foundPos].isSpaces() ||
+                        m_highlighter->isKeyword(m_highlighter->getText(fields[foundPos]))
+                        || m_highlighter->isSpecialChar(fields[foundPos]))
                     {
                         foundPos--;
                     }
@@ -405,23 +489,23 @@ void CodeView::mousePressEvent( QMouseEvent * event )
             if(foundPos != -1)
             {
                 // Found a include file?
-                if(cols[foundPos]->m_type == TextField::INC_STRING)
+                if(fields[foundPos].m_type == TextField::INC_STRING)
                 {
-                    incFile = cols[foundPos]->m_text.trimmed();
+                    incFile = m_highlighter->getText(fields[foundPos]).trimmed();
                     if(incFile.length() > 2)
                         incFile = incFile.mid(1, incFile.length()-2);
                     else
                         incFile = "";
                 }
                  // or a variable?
-                else if(cols[foundPos]->m_type == TextField::WORD)
+                else if(fields[foundPos].m_type == TextField::WORD)
                 {
-                    QStringList partList = cols[foundPos]->m_text.split('.');
+                    QStringList partList = m_highlighter->getText(fields[foundPos]).split('.');
 
                     // Remove the last word if it is a function
-                    if(foundPos+1 < cols.size())
+                    if(foundPos+1 < fieldCount)
                     {
-                        if(cols[foundPos+1]->m_text == "(" && partList.size() > 1)
+                        if(m_highlighter->getText(fields[foundPos+1]) == "(" && partList.size() > 1)
                             partList.removeLast();
                     }
                     
@@ -433,15 +517,15 @@ void CodeView::mousePressEvent( QMouseEvent * event )
                     }
 
                     // A '[...]' section to the right of the variable?
-                    if(foundPos+1 < cols.size())
+                    if(foundPos+1 < fieldCount)
                     {
-                        if(cols[foundPos+1]->m_text == "[")
+                        if(m_highlighter->getText(fields[foundPos+1]) == "[")
                         {
                             // Add the entire '[...]' section to the variable name
                             QString extraString = "[";
-                            for(int j = foundPos+2;foundPos < cols.size() && cols[j]->m_text != "]";j++)
+                            for(int j = foundPos+2;j < fieldCount && m_highlighter->getText(fields[j]) != "]";j++)
                             {
-                                extraString += cols[j]->m_text;
+                                extraString += m_highlighter->getText(fields[j]);
                             }
                             extraString += ']';
                             list += partList.join(".") + extraString;
@@ -514,9 +598,34 @@ void CodeView::mouseDoubleClickEvent( QMouseEvent * event )
 void CodeView::setBreakpoints(QVector<int> numList)
 {
     m_breakpointList = numList;
+    std::sort(m_breakpointList.begin(), m_breakpointList.end());
     update();
 }   
 
+/**
+ * @brief Sets the lines (1=first) that have code.
+ */
+void CodeView::setCodeLines(QVector<int> lineList)
+{
+    m_codeLines = lineList;
+    std::sort(m_codeLines.begin(), m_codeLines.end());
+    update();
+}
+
+/**
+ * @brief Sets the number of profiler samples for each line (linenumber => count).
+ */
+void CodeView::setLineHits(const QHash<int, int> &lineHits)
+{
+    m_lineHits = lineHits;
+    m_maxLineHits = 0;
+    QHash<int, int>::const_iterator it = m_lineHits.constBegin();
+    for(;it != m_lineHits.constEnd();++it)
+        m_maxLineHits = std::max(m_maxLineHits, it.value());
+    update();
+}
+
+
 void CodeView::setConfig(Settings *cfg)
 {
     m_cfg = cfg;
@@ -534,6 +643,7 @@ void CodeView::setConfig(Settings *cfg)
     m_font = QFont(m_cfg->m_fontFamily, m_cfg->m_fontSize);
     delete m_fontInfo;
     m_fontInfo = new QFontMetrics(m_font);
+    clearRowCache();
 
     if(cfg->m_variablePopupDelay > 0)
         m_timer.start(cfg->m_variablePopupDelay);
@@ -11,6 +11,8 @@
 
 #include <QWidget>
 #include <QStringList>
+#include <QHash>
+#include <QStaticText>
 #include "syntaxhighlightercxx.h"
 #include "syntaxhighlighterbasic.h"
 #include "syntaxhighlighterfortran.h"
@@ -59,6 +61,8 @@ public:
     void setInterface(ICodeView *inf) { m_inf = inf; };
 
     void setBreakpoints(QVector<int> numList);
+    void setLineHits(const QHash<int, int> &lineHits);
+    void setCodeLines(QVector<int> lineList);
 
     int getRowHeight();
 
@@ -69,6 +73,31 @@ public:
     void clearIncSearch();
     
 private:
+    /**
+     * @brief A text field prepared for drawing.
+     */
+    class CachedField
+    {
+    public:
+        QStaticText m_text;
+        int m_x; //!< Offset from the start of the text.
+        QColor m_color;
+    };
+
+    /**
+     * @brief The prepared text of a row.
+     */
+    class CachedRow
+    {
+    public:
+        QVector<CachedField> m_fields; //!< The fields that are not spaces.
+        QStaticText m_lineNo;
+    };
+
+private:
+    const CachedRow &getCachedRow(int rowIdx);
+    void clearRowCache();
+    QRect getRowRect(int lineNo);
     void idxToRowColumn(int idx, int *rowIdx, int *colIdx);
     int doIncSearch(QString pattern, int startPos, bool searchForward);
     void hideInfoWindow();
@@ -91,12 +120,16 @@ public:
     QFontMetrics *m_fontInfo;
     int m_cursorY;
     ICodeView *m_inf;
-    QVector<int> m_breakpointList;
+    QVector<int> m_breakpointList; //!< Sorted line numbers.
+    QVector<int> m_codeLines; //!< Sorted line numbers that have code.
+    QHash<int, int> m_lineHits; //!< Number of profiler samples for each line.
+    int m_maxLineHits;
     SyntaxHighlighter *m_highlighter;
     Settings *m_cfg;
     QString m_text;
     QTimer m_timer;
     VariableInfoWindow m_infoWindow;
+    QHash<int, CachedRow> m_rowCache; //!< Prepared rows (rowIdx => row) for the current highlighting.
 
 
     int m_incSearchStartPosRow;
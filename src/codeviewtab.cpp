@@ -132,6 +132,21 @@ int CodeViewTab::open(QString filename, QList<Tag> tagList)
 }
 
 
+/**
+ * @brief Reads the file again and keeps the scroll position.
+ */
+int CodeViewTab::reload(QList<Tag> tagList)
+{
+    QScrollBar *scrollBar = m_ui.scrollArea_codeView->verticalScrollBar();
+    int scrollPos = scrollBar->value();
+
+    int rc = open(m_filepath, tagList);
+
+    scrollBar->setValue(scrollPos);
+    return rc;
+}
+
+
 /**
  * @brief Ensures that a specific line is visible.
  */
@@ -202,6 +217,18 @@ void CodeViewTab::setBreakpoints(const QVector<int> &numList)
 }
 
 
+void CodeViewTab::setLineHits(const QHash<int, int> &lineHits)
+{
+    m_ui.codeView->setLineHits(lineHits);
+}
+
+
+void CodeViewTab::setCodeLines(QVector<int> lineList)
+{
+    m_ui.codeView->setCodeLines(lineList);
+}
+
+
 void CodeViewTab::setConfig(Settings *cfg)
 {
     m_cfg = cfg;
@@ -36,10 +36,13 @@ public:
     void clearIncSearch() { m_ui.codeView->clearIncSearch(); };
     
     int open(QString filename, QList<Tag> tagList);
+    int reload(QList<Tag> tagList);
 
     void setInterface(ICodeView *inf);
     
     void setBreakpoints(const QVector<int> &numList);
+    void setLineHits(const QHash<int, int> &lineHits);
+    void setCodeLines(QVector<int> lineList);
 
     QString getFilePath() { return m_filepath; };
 
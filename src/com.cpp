@@ -13,11 +13,11 @@
 #include <QDebug>
 #include <unistd.h>
 #include <assert.h>
-#include <sys/time.h>
 
 #include "log.h"
 #include "util.h"
 #include "config.h"
+#include "tracelog.h"
 #include "version.h"
 #include "detectdistro.h"
 
@@ -91,7 +91,6 @@ bool Resp::isResult()
         
 GdbCom::GdbCom()
  : m_listener(NULL)
- ,m_logFile(GDB_LOG_FILE)
  ,m_busy(0)
  ,m_enableLog(false)
  {
@@ -143,11 +142,6 @@ void GdbCom::disconnectGdb()
     }
 
     enableLog(false);
-    if(m_enableLog)
-    {
-        writeLogEntry("#\n");
-        m_logFile.close();
-    }
 }
 
 
@@ -829,16 +823,8 @@ void GdbCom::writeLogEntry(QString logText)
 {
     assert(m_enableLog == true);
 
-    // 
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    QString timeStr;
-    timeStr = QString::asprintf("%02d.%03d", (int)(tv.tv_sec%100), (int)(tv.tv_usec/1000));
-    
-    QString fullText = timeStr + "|" + logText;
-    
-    m_logFile.write(fullText.toUtf8());
-    m_logFile.flush();
+    // Timestamped and written by the log writer thread
+    m_logWriter.write(logText);
 }
                
 /**
@@ -1029,6 +1015,8 @@ GdbResult GdbCom::command(Tree *resultData, QString text)
 {
     Tree resultDataNull;
     int rc = 0;
+    TraceLog &trace = TraceLog::getInstance();
+    qint64 traceStart = trace.getTimestamp();
 
     assert(m_busy == 0);
     
@@ -1090,18 +1078,102 @@ GdbResult GdbCom::command(Tree *resultData, QString text)
 
     onReadyReadStandardOutput();
 
+    // Name the event after the MI command (eg: "-file-exec-and-symbols")
+    if(trace.isEnabled())
+    {
+        QString cmdText = text.trimmed();
+        trace.addComplete("mi", cmdText.section(' ', 0, 0), traceStart, cmdText);
+    }
+
     if(rc)
         return GDB_ERROR;
     return result;
 }
 
 
+/**
+ * @brief Sends several commands to GDB without waiting for a response in between.
+ * @param cmdList          The commands to send.
+ * @param resultDataList   Where to store the result of each command (one for each command).
+ * @return GDB_ERROR if any of the commands failed.
+ */
+GdbResult GdbCom::commandBatch(QStringList cmdList, QList<Tree*> resultDataList)
+{
+    int rc = 0;
+    GdbResult batchResult = GDB_DONE;
+
+    assert(m_busy == 0);
+    assert(cmdList.size() == resultDataList.size());
+
+    if(cmdList.isEmpty())
+        return GDB_DONE;
+
+    m_busy++;
+
+    // Send all commands at once
+    QByteArray wtext;
+    for(int i = 0;i < cmdList.size();i++)
+    {
+        QString text = cmdList[i];
+
+        debugMsg("# Cmd: '%s'", stringToCStr(text));
+
+        PendingCommand cmd;
+        cmd.m_cmdText = text;
+        m_pending.push_back(cmd);
+
+        resultDataList[i]->removeAll();
+
+        text += "\n";
+        wtext += text.toLatin1();
+
+        if(m_enableLog)
+        {
+            writeLogEntry("\n");
+            writeLogEntry("<< " + text);
+        }
+    }
+    m_process.write(wtext);
+
+    // The responses are received in the same order as the commands were sent
+    while(!m_pending.isEmpty() && rc == 0)
+    {
+        int idx = cmdList.size() - m_pending.size();
+        int pendingCount = m_pending.size();
+        GdbResult result = GDB_DONE;
+
+        if(readFromGdb(&result, resultDataList[idx]))
+            rc = -1;
+        else if(m_pending.size() < pendingCount && result == GDB_ERROR)
+            batchResult = GDB_ERROR;
+    }
+
+    Tree resultDataNull;
+    while(!m_list.isEmpty())
+    {
+        readFromGdb(NULL, &resultDataNull);
+    }
+
+    m_busy--;
+
+    dispatchResp();
+
+    onReadyReadStandardOutput();
+
+    if(rc)
+        return GDB_ERROR;
+    return batchResult;
+}
+
+
 /**
  * @brief Starts gdb
  * @return 0 on success and gdb was started.
  */
 int GdbCom::init(QString gdbPath, bool enableDebugLog)
 {
+    TraceScope traceScope("startup", "Spawn GDB");
+
     enableLog(enableDebugLog);
 
     QStringList gdbArgs;
@@ -1229,13 +1301,13 @@ void GdbCom::enableLog(bool enable)
         QString logStr;
         logStr = "# Closed: " + now.toString("yyyy-MM-dd hh:mm:ss") + "\n";
         writeLogEntry(logStr);
-        m_logFile.close();
+        m_logWriter.close();
     }
     m_enableLog = false;
 
     if(enable)
     {
-        if(m_logFile.open(QIODevice::Truncate | QIODevice::WriteOnly | QIODevice::Text))
+        if(m_logWriter.open(GDB_LOG_FILE) == 0)
         {
             infoMsg("Created '%s'", (const char*)GDB_LOG_FILE);
 
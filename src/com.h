@@ -16,6 +16,7 @@
 #include <assert.h>
 #include "tree.h"
 #include "config.h"
+#include "gdblogwriter.h"
 
 
 class Token
@@ -183,6 +184,7 @@ class GdbCom : public QObject
 
         GdbResult commandF(Tree *resultData, const char *cmd, ...);
         GdbResult command(Tree *resultData, QString cmd);
+        GdbResult commandBatch(QStringList cmdList, QList<Tree*> resultDataList);
 
         static QList<Token*> tokenize(QString str);
 
@@ -229,7 +231,7 @@ class GdbCom : public QObject
         
         QList<Token*> m_freeTokens; //!< List of tokens allocated but not in use.
         QList<Token*> m_list;
-        QFile m_logFile;
+        GdbLogWriter m_logWriter;
         QByteArray m_inputBuffer; //!< List of raw characters received from the GDB process.
         int m_busy;
         bool m_enableLog;
@@ -19,6 +19,27 @@
 
 #define GDB_LOG_FILE  "gede_gdb_log.txt"
 
+// Directory (in the project dir) where GDB caches the symbol index of the program
+#define GDB_INDEX_CACHE_DIR  ".gede2_index_cache"
+
+// Script (shipped with GDB) that adds a symbol index section to a program
+#define GDB_ADD_INDEX_CMD  "gdb-add-index"
+
+// The GDB log file is rotated when it gets bigger than this (bytes)
+#define GDB_LOG_MAX_SIZE   (16*1024*1024)
+
+// Number of rotated GDB log files to keep (FILENAME.1 ... FILENAME.N)
+#define GDB_LOG_MAX_FILES  3
+
+// Compress the rotated GDB log files with gzip
+#define GDB_LOG_COMPRESS
+
+// Max number of GDB log entries waiting to be written (must be a power of two)
+#define GDB_LOG_RING_SIZE  8192
+
+// Max number of log messages kept for the UI before it has registered
+#define LOG_PENDING_MAX   1000
+
 // etags command and argument to use to get list of tags
 #define ETAGS_CMD1     "ctags"    // Used on Linux
 #define ETAGS_CMD2     "exctags"  // Used on freebsd
@@ -47,6 +68,45 @@
 // Max number of last used programs
 #define MAX_LAST_USED_PROGRAMS 10
 
+// Number of threads to request backtraces for at a time when grouping threads by stack
+#define THREAD_GROUP_BATCH_SIZE   64
+
+// Max number of frames to compare when grouping threads by stack
+#define THREAD_GROUP_MAX_DEPTH    64
+
+// Number of stack frames to fetch at a time
+#define STACK_PAGE_SIZE   64
+
+// Max number of stack frames to show (to not hang on runaway recursions)
+#define STACK_MAX_DEPTH   10000
+
+// Prefix put in front of the messages printed by log points (dprintf)
+#define LOGPOINT_TAG   "@gede-log@ "
+
+// Max number of lines kept in the log point window
+#define LOGPOINT_MAX_LINES   100000
+
+// How often new log point messages are added to the log point window (ms)
+#define LOGPOINT_FLUSH_INTERVAL   100
+
+// How often the profiler window is updated while sampling (ms)
+#define PROFILER_UPDATE_INTERVAL   500
+
+// Root function of the backtraces that are deeper than the max sample depth
+#define PROFILER_TRUNCATED_NAME   "[truncated]"
+
+// Time to wait for more changes to the source files before reloading them (ms)
+#define SOURCE_WATCHER_DELAY   300
+
+// Max number of prepared text rows kept by each code view
+#define CODEVIEW_ROW_CACHE_SIZE   1000
+
+// Max number of slots in the keyword table of a syntax highlighter (a QSet is used if it is not enough)
+#define KEYWORD_TABLE_MAX_SIZE   (1<<20)
+
+// Number of line number programs in .debug_line that makes it worth to start another thread
+#define DWARF_UNITS_PER_THREAD   16
+
 // Baud rates
 #define BAUDRATE_LIST   {1200,2400,4800,9600,19200,38400,57600,115200}
 
@@ -13,6 +13,7 @@
 #include <QByteArray>
 #include <QDebug>
 #include <QFileInfo>
+#include <QDir>
 
 #include <unistd.h>
 #include <assert.h>
@@ -23,12 +24,17 @@
 #include <termios.h>
 #include <sys/ioctl.h>
 #include <string.h>
+#include <stdio.h>
 #include <errno.h>
+#include <algorithm>
 
+#include "config.h"
 #include "ini.h"
 #include "util.h"
 #include "log.h"
 #include "gdbmiparser.h"
+#include "tracelog.h"
+#include "mirecords.h"
 
 
 VarWatch::VarWatch()
@@ -63,6 +69,7 @@ CoreVar::CoreVar()
  : m_address(0)
    ,m_type(TYPE_UNKNOWN)
    ,m_addressValid(false)
+   ,m_dispCacheValid(0)
 {
 
 }
@@ -73,6 +80,7 @@ CoreVar::CoreVar(QString name)
     ,m_address(0)
       ,m_type(TYPE_UNKNOWN)
     ,m_addressValid(false)
+    ,m_dispCacheValid(0)
 {
 
 }
@@ -94,6 +102,10 @@ void CoreVar::clear()
 
 void CoreVar::valueFromGdbString(QString data)
 {
+    // Most values are simple scalars that do not need to be tokenized
+    if(GdbMiParser::parseScalarValue(this, data))
+        return;
+
     QList<Token*> tokenList = GdbMiParser::tokenizeVarString(data);
     QList<Token*> orgList = tokenList;
 
@@ -111,13 +123,17 @@ void CoreVar::setData(Type type, QVariant data)
 {
     m_type = type;
     m_data = data;
+    m_dispCacheValid = 0;
 }
 
 
+/**
+ * @brief Returns the data formatted for display.
+ *
+ * The formatted text is cached until the data is changed.
+ */
 QString CoreVar::getData(DispFormat fmt) const
 {
-    QString valueText;
-
     if(fmt == FMT_NATIVE)
     {
         if(m_type == TYPE_HEX_INT)
@@ -126,57 +142,99 @@ QString CoreVar::getData(DispFormat fmt) const
             fmt = FMT_CHAR;
     }
 
+    int cacheBit = 1<<(fmt-1);
+    if(!(m_dispCacheValid & cacheBit))
+    {
+        m_dispCache[fmt-1] = formatData(fmt);
+        m_dispCacheValid |= cacheBit;
+    }
+    return m_dispCache[fmt-1];
+}
+
+
+// Binary digits of each nibble
+static const char g_nibbleBits[16][4] =
+{
+    {'0','0','0','0'}, {'0','0','0','1'}, {'0','0','1','0'}, {'0','0','1','1'},
+    {'0','1','0','0'}, {'0','1','0','1'}, {'0','1','1','0'}, {'0','1','1','1'},
+    {'1','0','0','0'}, {'1','0','0','1'}, {'1','0','1','0'}, {'1','0','1','1'},
+    {'1','1','0','0'}, {'1','1','0','1'}, {'1','1','1','0'}, {'1','1','1','1'}
+};
+
+static const char g_hexDigits[] = "0123456789abcdef";
+
+
+QString CoreVar::formatData(DispFormat fmt) const
+{
+    QString valueText;
+
     if(m_type == TYPE_ENUM)
         return m_data.toString();
     else if(m_type == TYPE_CHAR || m_type == TYPE_HEX_INT || m_type == TYPE_DEC_INT)
     {
         if(fmt == FMT_CHAR)
         {
+            char buf[32];
+            int len;
             QChar c = m_data.toChar();
             if(c.isPrint())
-                valueText = QString::asprintf("%d '%c'", (int)m_data.toInt(), c.toLatin1());
+                len = snprintf(buf, sizeof(buf), "%d '%c'", (int)m_data.toInt(), c.toLatin1());
             else
-                valueText = QString::asprintf("%d ' '", (int)m_data.toInt());
+                len = snprintf(buf, sizeof(buf), "%d ' '", (int)m_data.toInt());
+            valueText = QString::fromLatin1(buf, len);
         }
         else if(fmt == FMT_BIN)
         {
-            QString subText;
-            QString reverseText;
+            // Eg: 0b0000_0101
+            char buf[2+64+16];
+            char *p = buf;
             qlonglong val = m_data.toULongLong();
-            do
+
+            // Whole bytes (only the lowest byte of negative numbers)
+            int bitCount = 8;
+            if(val > 0)
             {
-                subText = QString::asprintf("%d", (int)(val & 0x1));
-                reverseText = subText + reverseText;
-                val = val>>1;
+                while(bitCount < 64 && (val >> bitCount) != 0)
+                    bitCount += 8;
             }
-            while(val > 0 || reverseText.length()%8 != 0);
-            for(int i = 0;i < reverseText.length();i++)
+
+            *p++ = '0';
+            *p++ = 'b';
+            for(int shift = bitCount-4;shift >= 0;shift -= 4)
             {
-                valueText += reverseText[i];
-                if(i%4 == 3 && i+1 != reverseText.length())
-                    valueText += "_";
+                memcpy(p, g_nibbleBits[(val >> shift) & 0xf], 4);
+                p += 4;
+                if(shift > 0)
+                    *p++ = '_';
             }
-
-            valueText = "0b" + valueText;
+            valueText = QString::fromLatin1(buf, p-buf);
         }
         else if(fmt == FMT_HEX)
         {
-            QString text;
-            text = QString::asprintf("%llx", m_data.toLongLong());
-
-            // Prefix the string with suitable number of zeroes
-            while(text.length()%4 != 0 && text.length() > 4)
-                text = "0" + text;
-            if(text.length()%2 != 0)
-                text = "0" + text;
-                
-            for(int i = 0;i < text.length();i++)
+            // Eg: 0x0001_2345
+            char buf[2+16+4];
+            char *p = buf;
+            quint64 val = (quint64)m_data.toLongLong();
+
+            int digitCount = 1;
+            while(digitCount < 16 && (val >> (digitCount*4)) != 0)
+                digitCount++;
+
+            // Prefix with zeroes to get whole groups of four (or two) digits
+            if(digitCount > 4)
+                digitCount = (digitCount+3) & ~3;
+            else if(digitCount%2 != 0)
+                digitCount++;
+
+            *p++ = '0';
+            *p++ = 'x';
+            for(int i = 0;i < digitCount;i++)
             {
-                valueText = valueText + text[i];
-                if(i%4 == 3 && i+1 != text.length())
-                    valueText += "_";
+                *p++ = g_hexDigits[(val >> ((digitCount-1-i)*4)) & 0xf];
+                if(i%4 == 3 && i+1 != digitCount)
+                    *p++ = '_';
             }
-            valueText = "0x" + valueText;
+            valueText = QString::fromLatin1(buf, p-buf);
         }
         else// if(fmt == FMT_DEC)
         {
@@ -228,15 +286,28 @@ int Core::openPseudoTerminal()
 
 Core::Core()
  : m_inf(NULL)
+    ,m_threadDetailsGeneration(0)
+    ,m_threadListFullRefresh(false)
+    ,m_quietStackList(false)
+    ,m_quietFrame(false)
+    ,m_sampleStopPending(false)
+    ,m_sampleStopStale(false)
+    ,m_logPointStyle("gdb")
+    ,m_nonStop(false)
     ,m_selectedThreadId(0)
     ,m_targetState(ICore::TARGET_STOPPED)
     ,m_lastTargetState(ICore::TARGET_FINISHED)
     ,m_pid(0)
     ,m_currentFrameIdx(-1)
+    ,m_stackDepth(0)
+    ,m_stackDepthCapped(false)
+    ,m_stackFramesLoaded(0)
     ,m_varWatchLastId(10)
     ,m_isRemote(false)
     ,m_ptsFd(0)
     ,m_scanSources(false)
+    ,m_librariesChanged(false)
+    ,m_lazySharedLibs(false)
     ,m_ptsListener(NULL)
     ,m_memDepth(32)
     ,m_connectionMode(MODE_LOCAL)
@@ -271,6 +342,9 @@ Core::~Core()
     GdbCom& com = GdbCom::getInstance();
     com.setListener(NULL);
 
+    // Write the rest of the GDB log
+    com.enableLog(false);
+
     close(m_ptsFd);
 
     for(int m = 0;m < m_sourceFiles.size();m++)
@@ -325,12 +399,18 @@ int Core::initPid(Settings *cfg, QString gdbPath, QString programPath, int pid)
     m_isRemote = false;
     m_connectionMode = MODE_PID;
     m_lastRunTime = QDateTime::currentDateTime();
+    m_readyTimer.start();
 
     if(com.init(gdbPath, cfg->m_enableDebugLog))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
     }
+
+    initNonStop(cfg);
+    initLogPoints(cfg);
+    initSharedLibs(cfg);
+    initIndexCache(cfg);
     
     QString ptsDevPath = ptsname(m_ptsFd);
     
@@ -344,6 +424,8 @@ int Core::initPid(Settings *cfg, QString gdbPath, QString programPath, int pid)
     {
         critMsg("Failed to load '%s'", stringToCStr(programPath));
     }
+    else
+        rememberProgram(programPath);
 
 
     // Get memory depth (32 or 64)
@@ -369,6 +451,147 @@ int Core::initPid(Settings *cfg, QString gdbPath, QString programPath, int pid)
 }
 
 
+/**
+ * @brief Puts GDB in non-stop mode if enabled in the settings.
+ *
+ * Must be done before the program is started or attached to.
+ * @return 0 on success.
+ */
+int Core::initNonStop(Settings *cfg)
+{
+    GdbCom& com = GdbCom::getInstance();
+
+    m_nonStop = false;
+    if(!cfg->m_nonStop)
+        return 0;
+
+    // Commands must be accepted while some of the threads are running
+    if(com.command(NULL, "-gdb-set mi-async on") == GDB_ERROR)
+        com.command(NULL, "-gdb-set target-async on");
+
+    if(com.command(NULL, "-gdb-set non-stop on") == GDB_ERROR)
+    {
+        warnMsg("Failed to enable non-stop mode");
+        return -1;
+    }
+    m_nonStop = true;
+    return 0;
+}
+
+
+/**
+ * @brief Selects how the messages of the log points (dprintf) are printed.
+ * @return 0 on success.
+ */
+int Core::initLogPoints(Settings *cfg)
+{
+    GdbCom& com = GdbCom::getInstance();
+
+    m_logPointStyle = cfg->m_dprintfStyle;
+    if(m_logPointStyle.isEmpty())
+        m_logPointStyle = "gdb";
+    if(m_logPointStyle == "gdb")
+        return 0;
+
+    // Printed by the target itself. GDB falls back to its own printf
+    // if the target can not run the commands.
+    if(com.commandF(NULL, "-gdb-set dprintf-style %s", stringToCStr(m_logPointStyle)) == GDB_ERROR)
+    {
+        warnMsg("Failed to set dprintf-style to '%s'", stringToCStr(m_logPointStyle));
+        m_logPointStyle = "gdb";
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Stops GDB from reading the symbols of the shared libraries if enabled in the settings.
+ *
+ * Must be done before the program is started, attached to or the core dump is loaded.
+ * The symbols of a library are then loaded by gdbLoadLibrarySymbols().
+ * @return 0 on success.
+ */
+int Core::initSharedLibs(Settings *cfg)
+{
+    GdbCom& com = GdbCom::getInstance();
+
+    m_libraries.clear();
+    m_librariesChanged = false;
+    m_lazySharedLibs = false;
+    if(m_inf)
+        m_inf->ICore_onLibrariesChanged();
+    if(!cfg->m_lazySharedLibs)
+        return 0;
+
+    if(com.command(NULL, "-gdb-set auto-solib-add off") == GDB_ERROR)
+    {
+        warnMsg("Failed to defer the loading of shared library symbols");
+        return -1;
+    }
+    m_lazySharedLibs = true;
+    return 0;
+}
+
+
+/**
+ * @brief Lets GDB cache the symbol index of the program if enabled in the settings.
+ *
+ * Must be done before the symbols are loaded. The next time the same build
+ * is loaded GDB reads the index from the cache instead of creating it.
+ * @return 0 on success.
+ */
+int Core::initIndexCache(Settings *cfg)
+{
+    GdbCom& com = GdbCom::getInstance();
+
+    if(!cfg->m_gdbIndexCache)
+        return 0;
+
+    QString cacheDir = cfg->getIndexCacheDir();
+    if(!QDir().mkpath(cacheDir))
+    {
+        warnMsg("Failed to create '%s'", stringToCStr(cacheDir));
+        return -1;
+    }
+
+    if(com.commandF(NULL, "-gdb-set index-cache directory %s", stringToCStr(cacheDir)) == GDB_ERROR)
+    {
+        warnMsg("GDB does not support an index cache");
+        return -1;
+    }
+
+    // Older GDB versions (before 11) does not have the 'enabled' keyword
+    if(com.command(NULL, "-gdb-set index-cache enabled on") == GDB_ERROR)
+    {
+        if(com.command(NULL, "-gdb-set index-cache on") == GDB_ERROR)
+        {
+            warnMsg("Failed to enable the index cache");
+            return -1;
+        }
+    }
+    infoMsg("Using the index cache in %s", stringToCStr(cacheDir));
+    return 0;
+}
+
+
+/**
+ * @brief Tells the listener how long it took from GDB was started until the target stopped.
+ *
+ * Only done the first time the target stops.
+ */
+void Core::reportReady()
+{
+    if(!m_readyTimer.isValid())
+        return;
+
+    int readyTime = (int)m_readyTimer.elapsed();
+    m_readyTimer.invalidate();
+    if(m_inf)
+        m_inf->ICore_onReady(readyTime);
+}
+
+
 /**
  * @brief Execute the init commands (supplied by the user).
  */
@@ -403,12 +626,18 @@ int Core::initLocal(Settings *cfg, QString gdbPath, QString programPath, QString
     m_isRemote = false;
     m_connectionMode = MODE_LOCAL;
     m_lastRunTime = QDateTime::currentDateTime();
+    m_readyTimer.start();
 
     if(com.init(gdbPath, cfg->m_enableDebugLog))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
     }
+
+    initNonStop(cfg);
+    initLogPoints(cfg);
+    initSharedLibs(cfg);
+    initIndexCache(cfg);
     
     QString ptsDevPath = ptsname(m_ptsFd);
     
@@ -422,6 +651,8 @@ int Core::initLocal(Settings *cfg, QString gdbPath, QString programPath, QString
     {
         critMsg("Failed to load '%s'", stringToCStr(programPath));
     }
+    else
+        rememberProgram(programPath);
 
 
     // Get memory depth (32 or 64)
@@ -464,6 +695,7 @@ int Core::initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QStr
     m_isRemote = false;
     m_connectionMode = MODE_COREDUMP;
     m_lastRunTime = QDateTime::currentDateTime();
+    m_readyTimer.start();
 
     if(com.init(gdbPath, cfg->m_enableDebugLog))
     {
@@ -471,10 +703,16 @@ int Core::initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QStr
         return -1;
     }
 
+    // A core dump has no running threads
+    m_nonStop = false;
+    initSharedLibs(cfg);
+    initIndexCache(cfg);
+
     // Load the symbols
     if(!programPath.isEmpty())
     {
-        com.commandF(&resultData, "-file-exec-and-symbols %s", stringToCStr(programPath));
+        if(com.commandF(&resultData, "-file-exec-and-symbols %s", stringToCStr(programPath)) != GDB_ERROR)
+            rememberProgram(programPath);
     }
 
     // Load the coredump file
@@ -495,11 +733,13 @@ int Core::initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QStr
 
     runInitCommands(cfg);
 
+    gdbGetLibraries();
     gdbGetFiles();
 
     m_targetState = ICore::TARGET_FINISHED;
     if(m_inf)
         m_inf->ICore_onStateChanged(ICore::TARGET_FINISHED);
+    reportReady();
 
 
     com.commandF(NULL, "-stack-list-variables --no-values");
@@ -526,6 +766,7 @@ int Core::initRemote(Settings *cfg, QString gdbPath, QString programPath, QStrin
     m_isRemote = true;
     m_connectionMode = MODE_TCP;
     m_lastRunTime = QDateTime::currentDateTime();
+    m_readyTimer.start();
 
     if(com.init(gdbPath, cfg->m_enableDebugLog))
     {
@@ -533,10 +774,15 @@ int Core::initRemote(Settings *cfg, QString gdbPath, QString programPath, QStrin
         return -1;
     }
 
+    initNonStop(cfg);
+    initLogPoints(cfg);
+    initSharedLibs(cfg);
+    initIndexCache(cfg);
+
     if(!programPath.isEmpty())
     {
-        com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath));
-
+        if(com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath)) != GDB_ERROR)
+            rememberProgram(programPath);
     }
 
     if(!programPath.isEmpty())
@@ -579,6 +825,7 @@ int Core::initSerial(Settings *cfg, QString gdbPath, QString programPath, QStrin
     m_isRemote = true;
     m_connectionMode = MODE_SERIAL;
     m_lastRunTime = QDateTime::currentDateTime();
+    m_readyTimer.start();
 
     if(com.init(gdbPath, cfg->m_enableDebugLog))
     {
@@ -586,12 +833,17 @@ int Core::initSerial(Settings *cfg, QString gdbPath, QString programPath, QStrin
         return -1;
     }
 
+    initNonStop(cfg);
+    initLogPoints(cfg);
+    initSharedLibs(cfg);
+    initIndexCache(cfg);
+
     com.commandF(&resultData, "set serial baud %d", baudRate); 
 
     if(!programPath.isEmpty())
     {
-        com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath));
-
+        if(com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath)) != GDB_ERROR)
+            rememberProgram(programPath);
     }
 
     if(!programPath.isEmpty())
@@ -723,8 +975,35 @@ bool Core::gdbGetFiles()
     Tree resultData;
     QMap<QString, bool> fileLookup;
     bool modified = false;
-    
-    com.command(&resultData, "-file-list-exec-source-files");
+    TraceScope traceScope("startup", "Get source files");
+    QStringList names;
+    QStringList fullNames;
+
+    // The line tables of the program are enough as long as no library with symbols is loaded
+    if(m_lineTable.isLoaded() && !hasLibrarySymbols())
+    {
+        for(int i = 0;i < m_lineTable.getFileCount();i++)
+        {
+            names.append(m_lineTable.getFileName(i));
+            fullNames.append(m_lineTable.getFilePath(i));
+        }
+    }
+    else
+    {
+        com.command(&resultData, "-file-list-exec-source-files");
+        for(int k = 0;k < resultData.getRootChildCount();k++)
+        {
+            TreeNode *rootNode = resultData.getChildAt(k);
+            if(rootNode->getName() != "files")
+                continue;
+            for(int j = 0;j < rootNode->getChildCount();j++)
+            {
+                TreeNode *childNode = rootNode->getChild(j);
+                names.append(childNode->getChildDataString("file"));
+                fullNames.append(childNode->getChildDataString("fullname"));
+            }
+        }
+    }
 
 
     // Clear the old list
@@ -738,49 +1017,36 @@ bool Core::gdbGetFiles()
 
 
     // Create the new list
-    for(int k = 0;k < resultData.getRootChildCount();k++)
+    for(int j = 0;j < names.size();j++)
     {
-        TreeNode *rootNode = resultData.getChildAt(k);
-        QString rootName = rootNode->getName();
+        QString name = names[j];
+        QString fullname = fullNames[j];
+
+        if(fullname.isEmpty())
+            continue;
 
-        if(rootName == "files")
+        if(!name.contains("<built-in>"))
         {
-            for(int j = 0;j < rootNode->getChildCount();j++)
+            // Already added this file?
+            bool alreadyAdded = false;
+            if(fileLookup.contains(fullname))
             {
-                TreeNode *childNode = rootNode->getChild(j);
-                QString name = childNode->getChildDataString("file");
-                QString fullname = childNode->getChildDataString("fullname");
-
-                if(fullname.isEmpty())
-                    continue;
-
-                SourceFile *sourceFile = NULL;
-                if(!name.contains("<built-in>"))
-                {
-                    // Already added this file?
-                    bool alreadyAdded = false;
-                    if(fileLookup.contains(fullname))
-                    {
-                        if(fileLookup[fullname] == true)
-                            alreadyAdded = true;
-                    }
-                    else
-                        modified = true;
-                        
-                    if(!alreadyAdded)
-                    {
-                        fileLookup[fullname] = true;
-                        
-                        sourceFile = new SourceFile; 
+                if(fileLookup[fullname] == true)
+                    alreadyAdded = true;
+            }
+            else
+                modified = true;
+                
+            if(!alreadyAdded)
+            {
+                fileLookup[fullname] = true;
+                
+                SourceFile *sourceFile = new SourceFile; 
 
-                        sourceFile->m_name = name;
-                        sourceFile->m_fullName = fullname;
-                        sourceFile->m_modTime = QDateTime::currentDateTime();
+                sourceFile->m_name = name;
+                sourceFile->m_fullName = fullname;
 
-                        m_sourceFiles.append(sourceFile);
-                    }
-                }
-                
+                m_sourceFiles.append(sourceFile);
             }
         }
     }
@@ -797,6 +1063,199 @@ bool Core::gdbGetFiles()
 }
 
 
+
+/**
+ * @brief Converts a library tuple reported by GDB.
+ */
+static SharedLibrary decodeLibrary(const TreeNode *libNode)
+{
+    MiLibraryRecord record;
+    record.decode(libNode);
+
+    SharedLibrary lib;
+    lib.m_id = record.m_id;
+    lib.m_hostName = record.m_hostName;
+    lib.m_symbolsLoaded = record.m_symbolsLoaded;
+    lib.m_fromAddr = record.m_fromAddr;
+    lib.m_toAddr = record.m_toAddr;
+    return lib;
+}
+
+
+void Core::updateLibrary(const SharedLibrary &lib)
+{
+    m_libraries[lib.m_id] = lib;
+    if(m_inf)
+        m_inf->ICore_onLibrariesChanged();
+}
+
+
+bool Core::hasDeferredLibraries()
+{
+    QMap<QString, SharedLibrary>::const_iterator it = m_libraries.constBegin();
+    for(;it != m_libraries.constEnd();++it)
+    {
+        if(!it.value().m_symbolsLoaded)
+            return true;
+    }
+    return false;
+}
+
+
+bool Core::hasLibrarySymbols()
+{
+    QMap<QString, SharedLibrary>::const_iterator it = m_libraries.constBegin();
+    for(;it != m_libraries.constEnd();++it)
+    {
+        if(it.value().m_symbolsLoaded)
+            return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Asks GDB which of the shared libraries that has their symbols loaded.
+ * @return 0 on success.
+ */
+int Core::gdbGetLibraries()
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    m_librariesChanged = false;
+
+    // Not supported by old GDB versions
+    if(com.command(&resultData, "-file-list-shared-libraries") == GDB_ERROR)
+        return -1;
+
+    QMap<QString, SharedLibrary> libraries;
+    TreeNode *listNode = resultData.findChild("shared-libraries");
+    for(int i = 0;listNode && i < listNode->getChildCount();i++)
+    {
+        SharedLibrary lib = decodeLibrary(listNode->getChild(i));
+        libraries[lib.m_id] = lib;
+    }
+    m_libraries = libraries;
+
+    if(m_inf)
+        m_inf->ICore_onLibrariesChanged();
+    return 0;
+}
+
+
+/**
+ * @brief Loads the symbols of a shared library.
+ * @param libId    The id of the library or empty to load all libraries.
+ * @return 0 on success.
+ */
+int Core::gdbLoadLibrarySymbols(QString libId)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+    QString regex;
+
+    ensureStopped();
+
+    if(!libId.isEmpty())
+    {
+        if(!m_libraries.contains(libId))
+            return -1;
+        const SharedLibrary &lib = m_libraries[libId];
+        QString path = lib.m_hostName.isEmpty() ? lib.m_id : lib.m_hostName;
+
+        // GDB matches the path with a basic regular expression
+        regex = "^";
+        for(int i = 0;i < path.length();i++)
+        {
+            if(QString(".[]*^$\\").contains(path[i]))
+                regex += '\\';
+            regex += path[i];
+        }
+        regex += "$";
+
+        infoMsg("Loading the symbols of %s", stringToCStr(path));
+    }
+
+    if(com.commandF(&resultData, "sharedlibrary %s", stringToCStr(regex)) == GDB_ERROR)
+    {
+        warnMsg("Failed to load the symbols of '%s'", stringToCStr(libId));
+        return -1;
+    }
+
+    if(gdbGetLibraries() != 0)
+    {
+        QMap<QString, SharedLibrary>::iterator it = m_libraries.begin();
+        for(;it != m_libraries.end();++it)
+        {
+            if(libId.isEmpty() || it.key() == libId)
+                it.value().m_symbolsLoaded = true;
+        }
+        if(m_inf)
+            m_inf->ICore_onLibrariesChanged();
+    }
+
+    // The library may have added source files
+    m_scanSources = false;
+    if(gdbGetFiles() && m_inf)
+        m_inf->ICore_onSourceFileListChanged();
+    return 0;
+}
+
+
+/**
+ * @brief Loads the symbols of the deferred library that contains an address.
+ * @param from   The path of the library as reported for the frame (may be empty).
+ * @return 0 if the symbols was loaded.
+ */
+int Core::loadLibraryAt(QString from, unsigned long long addr)
+{
+    QString libId;
+    QMap<QString, SharedLibrary>::const_iterator it = m_libraries.constBegin();
+    for(;it != m_libraries.constEnd() && libId.isEmpty();++it)
+    {
+        const SharedLibrary &lib = it.value();
+        if(lib.m_symbolsLoaded)
+            continue;
+        if(!from.isEmpty() && (from == lib.m_hostName || from == lib.m_id))
+            libId = lib.m_id;
+        else if(addr != 0 && lib.m_fromAddr <= addr && addr < lib.m_toAddr)
+            libId = lib.m_id;
+    }
+    if(libId.isEmpty())
+        return -1;
+    return gdbLoadLibrarySymbols(libId);
+}
+
+
+/**
+ * @brief Finds the deferred library that has code in a source file by reading its line table.
+ * @param allRead   Set to false if the line table of some library could not be read.
+ * @return The id of the library or an empty string if none was found.
+ */
+QString Core::findDeferredLibraryWithFile(QString filename, bool *allRead)
+{
+    *allRead = true;
+    QMap<QString, SharedLibrary>::const_iterator it = m_libraries.constBegin();
+    for(;it != m_libraries.constEnd();++it)
+    {
+        const SharedLibrary &lib = it.value();
+        if(lib.m_symbolsLoaded)
+            continue;
+        QString path = lib.m_hostName.isEmpty() ? lib.m_id : lib.m_hostName;
+        DwarfLineTable lineTable;
+        if(lineTable.load(path) != 0)
+        {
+            *allRead = false;
+            continue;
+        }
+        if(lineTable.hasFile(filename))
+            return lib.m_id;
+    }
+    return "";
+}
+
+
 /**
  * @brief Sets a breakpoint at a function
  */
@@ -854,22 +1313,6 @@ void Core::gdbRun()
 
     if(!m_isRemote)
     {
-        // Loop through all source files
-        for(int i = 0;i < m_sourceFiles.size();i++)
-        {
-            SourceFile *sourceFile = m_sourceFiles[i];
-
-            if(QFileInfo(sourceFile->m_fullName).exists())
-            {
-                // Has the file being modified?
-                QDateTime modTime = QFileInfo(sourceFile->m_fullName).lastModified();
-                if(sourceFile->m_modTime <  modTime)
-                {
-                    m_inf->ICore_onSourceFileChanged(sourceFile->m_fullName);
-                }
-            }
-        }
-
         // Get all source files
         gdbGetFiles();
                                 
@@ -879,6 +1322,8 @@ void Core::gdbRun()
 
 /**
  * @brief Asks gdb to reload and restart the (probably modified binary) that is being debugged.
+ *
+ * GDB is only restarted if the program can not be reloaded in the running GDB.
  * @return 0 on success.
  */
 int Core::gdbReload(Settings &cfg)
@@ -893,22 +1338,6 @@ int Core::gdbReload(Settings &cfg)
         return -1;
     }
 
-    // Check if any source files has been modified
-    for(int i = 0;i < m_sourceFiles.size();i++)
-    {
-        SourceFile *sourceFile = m_sourceFiles[i];
-
-        if(QFileInfo(sourceFile->m_fullName).exists())
-        {
-            // Has the file being modified?
-            QDateTime modTime = QFileInfo(sourceFile->m_fullName).lastModified();
-            if(sourceFile->m_modTime <  modTime)
-            {
-                m_inf->ICore_onSourceFileChanged(sourceFile->m_fullName);
-            }
-        }
-    }
-
     if(m_connectionMode == MODE_TCP)
     {
         Tree resultData;
@@ -928,6 +1357,7 @@ int Core::gdbReload(Settings &cfg)
             rc = com.command(&resultData, "-target-download");
         if (rc == GDB_ERROR)
             return rc;
+        rememberProgram(progpath);
 
         if(m_ptsListener)
             delete m_ptsListener;
@@ -946,8 +1376,9 @@ int Core::gdbReload(Settings &cfg)
         // Get all source files
         gdbGetFiles();
     }
-    else
+    else if(gdbWarmReload(cfg) != 0)
     {
+        warnMsg("Failed to reload the program. Restarting GDB.");
         com.disconnectGdb();
 
         if(m_connectionMode == MODE_LOCAL)
@@ -971,6 +1402,75 @@ int Core::gdbReload(Settings &cfg)
     return rc;
 }
 
+/**
+ * @brief Reloads the program without restarting GDB.
+ *
+ * GDB keeps its symbol tables between runs. The symbols are only read
+ * again if the program has changed.
+ * @return 0 on success.
+ */
+int Core::gdbWarmReload(Settings &cfg)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+    QString programPath = cfg.getProgramPath();
+
+    if(m_connectionMode == MODE_PID)
+        com.command(NULL, "-target-detach");
+
+    if(!programPath.isEmpty() && isProgramChanged(programPath))
+    {
+        infoMsg("Reading the symbols of '%s'", stringToCStr(programPath));
+
+        GdbResult res;
+        if(m_connectionMode == MODE_SERIAL)
+        {
+            res = com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath));
+            if(res != GDB_ERROR)
+                res = com.commandF(&resultData, "-file-exec-file %s", stringToCStr(programPath));
+        }
+        else
+            res = com.commandF(&resultData, "-file-exec-and-symbols %s", stringToCStr(programPath));
+        if(res == GDB_ERROR)
+            return -1;
+        rememberProgram(programPath);
+
+        gdbGetFiles();
+        if(m_inf)
+            m_inf->ICore_onSourceFileListChanged();
+    }
+    else
+        infoMsg("'%s' is unchanged. Keeping the symbols.", stringToCStr(programPath));
+
+    if(m_connectionMode == MODE_SERIAL)
+    {
+        if(!programPath.isEmpty() && cfg.m_download)
+        {
+            if(com.command(&resultData, "-target-download") == GDB_ERROR)
+                return -1;
+        }
+    }
+    else if(m_connectionMode == MODE_PID)
+    {
+        if(com.commandF(NULL, "-target-attach %d", cfg.m_runningPid) == GDB_ERROR)
+            return -1;
+    }
+    else if(m_connectionMode == MODE_COREDUMP)
+    {
+        if(com.commandF(&resultData, "-target-select core %s", stringToCStr(cfg.m_coreDumpFile)) == GDB_ERROR)
+            return -1;
+
+        m_targetState = ICore::TARGET_FINISHED;
+        if(m_inf)
+            m_inf->ICore_onStateChanged(ICore::TARGET_FINISHED);
+        com.commandF(NULL, "-stack-list-variables --no-values");
+    }
+
+    m_lastRunTime = QDateTime::currentDateTime();
+    return 0;
+}
+
+
 /**
  * @brief  Resumes the execution until a breakpoint is encountered, or until the program exits.
  */
@@ -986,7 +1486,11 @@ void Core::gdbContinue()
         return;
     }
 
-    com.commandF(&resultData, "-exec-continue");
+    // Only resume the selected thread in non-stop mode
+    if(m_nonStop)
+        com.commandF(&resultData, "-exec-continue --thread %d", m_selectedThreadId);
+    else
+        com.commandF(&resultData, "-exec-continue");
 
 }
 
@@ -996,6 +1500,9 @@ void Core::gdbContinue()
  */
 void Core::ensureStopped()
 {
+    // GDB accepts commands while threads are running in non-stop mode
+    if(m_nonStop)
+        return;
     if(m_targetState == ICore::TARGET_RUNNING)
         stop();
 }
@@ -1014,6 +1521,20 @@ void Core::stop()
         return;
     }
 
+    // The user wants the stop to be shown even if a sample was pending
+    m_sampleStopPending = false;
+    m_sampleStopStale = false;
+
+    // Only interrupt the selected thread
+    if(m_nonStop)
+    {
+        GdbCom& com = GdbCom::getInstance();
+        if(m_selectedThreadId > 0)
+            com.commandF(NULL, "-exec-interrupt --thread %d", m_selectedThreadId);
+        else
+            com.command(NULL, "-exec-interrupt --all");
+        return;
+    }
 
     if(m_isRemote)
     {
@@ -1051,66 +1572,221 @@ void Core::stop()
 
 
 /**
- * @brief Execute the next row in the program.
+ * @brief Interrupts the target to take a sample of the backtraces.
+ *
+ * The stop is not reported as a normal stop. ICore_onSampleStopped() is
+ * called instead and the target is resumed directly after it.
+ * @return 0 on success.
+ */
+int Core::sampleStop()
+{
+    // Only all the threads can be sampled at once in all-stop mode
+    if(m_nonStop || m_targetState != ICore::TARGET_RUNNING)
+        return -1;
+    if(m_sampleStopPending)
+        return 0;
+
+    // Interrupt the same way as stop() but without the extra step on remote targets
+    int pid = m_isRemote ? GdbCom::getInstance().getPid() : m_pid;
+    if(pid == 0)
+        return -1;
+    m_sampleStopPending = true;
+    kill(pid, SIGINT);
+    return 0;
+}
+
+
+/**
+ * @brief Checks if a stop looks like the interrupt sent by sampleStop().
+ */
+bool Core::isSampleStop(const MiStoppedRecord &stopped) const
+{
+    if(stopped.m_reason != "signal-received")
+        return false;
+    if(stopped.m_signalName == "SIGINT")
+        return true;
+
+    // Some remote stubs report an interrupt as SIGTRAP
+    return m_isRemote && stopped.m_signalName == "SIGTRAP";
+}
+
+
+/**
+ * @brief Execute the next row in the program.
+ */
+void Core::gdbNext()
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    if(m_targetState != ICore::TARGET_STOPPED)
+    {
+        if(m_inf)
+            m_inf->ICore_onMessage("Program is not stopped");
+        return;
+    }
+
+    // Only resume the selected thread in non-stop mode
+    if(m_nonStop)
+        com.commandF(&resultData, "-exec-next --thread %d", m_selectedThreadId);
+    else
+        com.commandF(&resultData, "-exec-next");
+
+}
+
+
+
+/**
+ * @brief Jumps to a location (by changing program counter).
+ * @return 0 on success.
+ */
+int Core::jump(QString filename, int lineNo)
+{
+    int res;
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    if(m_targetState != ICore::TARGET_STOPPED)
+    {
+        if(m_inf)
+            m_inf->ICore_onMessage("Program is not stopped");
+        return -3;
+    }
+
+    res = com.commandF(&resultData, "-break-insert -t %s:%d", stringToCStr(filename), lineNo);
+    if(res != GDB_DONE)
+        return -1;
+    resultData.removeAll();
+        
+    res = com.commandF(&resultData, "-exec-jump %s:%d", stringToCStr(filename), lineNo);
+    if(res != GDB_DONE)
+        return -2;
+
+    return 0;
+}
+
+
+
+/**
+ * @brief Request the newest stack frames.
+ *
+ * Only the first STACK_PAGE_SIZE frames are fetched. The rest are fetched with getMoreStackFrames().
+ */
+void Core::getStackFrames()
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    m_stackDepth = 0;
+    m_stackDepthCapped = false;
+    m_stackFramesLoaded = 0;
+
+    // Get the depth but do not let GDB walk a runaway recursion all the way down.
+    // One extra frame is asked for to know if the stack is deeper than the max.
+    if(com.commandF(&resultData, "-stack-info-depth %d", STACK_MAX_DEPTH+1) != GDB_DONE)
+        return;
+    m_stackDepth = resultData.getInt("depth", 0);
+    if(m_stackDepth > STACK_MAX_DEPTH)
+    {
+        m_stackDepth = STACK_MAX_DEPTH;
+        m_stackDepthCapped = true;
+    }
+    if(m_stackDepth <= 0)
+        return;
+
+    int highIdx = std::min(STACK_PAGE_SIZE, m_stackDepth)-1;
+    com.commandF(&resultData, "-stack-list-frames 0 %d", highIdx);
+}
+
+
+/**
+ * @brief Request the next page of (older) stack frames.
  */
-void Core::gdbNext()
+void Core::getMoreStackFrames()
 {
     GdbCom& com = GdbCom::getInstance();
     Tree resultData;
 
-    if(m_targetState != ICore::TARGET_STOPPED)
-    {
-        if(m_inf)
-            m_inf->ICore_onMessage("Program is not stopped");
+    if(m_targetState == ICore::TARGET_STARTING || m_targetState == ICore::TARGET_RUNNING)
+        return;
+    if(m_stackFramesLoaded <= 0 || m_stackFramesLoaded >= m_stackDepth)
         return;
-    }
-
-    com.commandF(&resultData, "-exec-next");
 
+    int lowIdx = m_stackFramesLoaded;
+    int highIdx = std::min(lowIdx+STACK_PAGE_SIZE, m_stackDepth)-1;
+    com.commandF(&resultData, "-stack-list-frames %d %d", lowIdx, highIdx);
 }
 
 
-
 /**
- * @brief Jumps to a location (by changing program counter).
- * @return 0 on success.
+ * @brief Gets the backtraces of several threads.
+ * @param threadIdList  The threads to get the backtrace for.
+ * @param maxDepth      Max number of frames to get for each thread.
+ * @param stacks        The backtraces (oldest frame first) for each thread (running threads are left out).
  */
-int Core::jump(QString filename, int lineNo)
+void Core::gdbGetThreadStacks(QList<int> threadIdList, int maxDepth, QMap<int, QList<StackFrameEntry> > *stacks)
 {
-    int res;
     GdbCom& com = GdbCom::getInstance();
-    Tree resultData;
+    QStringList cmdList;
+    QList<Tree*> resultList;
+    QList<int> sentIdList;
 
-    if(m_targetState != ICore::TARGET_STOPPED)
+    if(m_targetState == ICore::TARGET_STARTING || m_targetState == ICore::TARGET_RUNNING)
+        return;
+
+    for(int i = 0;i < threadIdList.size();i++)
     {
-        if(m_inf)
-            m_inf->ICore_onMessage("Program is not stopped");
-        return -3;
+        // Threads that are running in non-stop mode have no stack to list
+        int threadId = threadIdList[i];
+        if(m_threadList.contains(threadId) && m_threadList[threadId].m_running)
+            continue;
+
+        cmdList += QString::asprintf("-stack-list-frames --thread %d 0 %d", threadId, maxDepth-1);
+        resultList += new Tree;
+        sentIdList += threadId;
     }
+    if(cmdList.isEmpty())
+        return;
 
-    res = com.commandF(&resultData, "-break-insert -t %s:%d", stringToCStr(filename), lineNo);
-    if(res != GDB_DONE)
-        return -1;
-    resultData.removeAll();
-        
-    res = com.commandF(&resultData, "-exec-jump %s:%d", stringToCStr(filename), lineNo);
-    if(res != GDB_DONE)
-        return -2;
+    // Send all requests at once to not have to wait for GDB between each thread
+    m_quietStackList = true;
+    com.commandBatch(cmdList, resultList);
+    m_quietStackList = false;
 
-    return 0;
+    for(int i = 0;i < resultList.size();i++)
+    {
+        Tree *resultData = resultList[i];
+        TreeNode *stackNode = resultData->findChild("stack");
+        if(stackNode)
+        {
+            QList<StackFrameEntry> stackFrameList;
+            parseStackNode(stackNode, &stackFrameList);
+            (*stacks)[sentIdList[i]] = stackFrameList;
+        }
+        delete resultData;
+    }
 }
 
 
-
 /**
- * @brief Request a list of stack frames.
+ * @brief Parses a 'stack' list received from GDB.
+ * @param stackFrameList   The frames found (oldest frame first).
  */
-void Core::getStackFrames()
+void Core::parseStackNode(const TreeNode *node, QList<StackFrameEntry> *stackFrameList)
 {
-    GdbCom& com = GdbCom::getInstance();
-    Tree resultData;
-    com.command(&resultData, "-stack-list-frames");
+    for(int j = 0;j < node->getChildCount();j++)
+    {
+        const TreeNode *child = node->getChild(j);
+        
+        MiFrameRecord frame;
+        frame.decode(child);
 
+        StackFrameEntry entry;
+        entry.m_functionName = frame.m_func;
+        entry.m_line = frame.m_line;
+        entry.m_sourcePath = frame.m_fullname;
+        stackFrameList->push_front(entry);
+    }
 }
 
 
@@ -1130,7 +1806,11 @@ void Core::gdbStepIn()
     }
 
         
-    com.commandF(&resultData, "-exec-step");
+    // Only resume the selected thread in non-stop mode
+    if(m_nonStop)
+        com.commandF(&resultData, "-exec-step --thread %d", m_selectedThreadId);
+    else
+        com.commandF(&resultData, "-exec-step");
     com.commandF(&resultData, "-var-update --all-values *");
 
 }
@@ -1152,7 +1832,11 @@ void Core::gdbStepOut()
     }
 
         
-    com.commandF(&resultData, "-exec-finish");
+    // Only resume the selected thread in non-stop mode
+    if(m_nonStop)
+        com.commandF(&resultData, "-exec-finish --thread %d", m_selectedThreadId);
+    else
+        com.commandF(&resultData, "-exec-finish");
     com.commandF(&resultData, "-var-update --all-values *");
 
 }
@@ -1198,13 +1882,7 @@ VarWatch* Core::getVarWatchInfo(QString watchId)
 {
     assert(watchId != "");
     assert(watchId[0] == 'w');
-    for(int i = 0;i < m_watchList.size();i++)
-    {
-        VarWatch* watch = m_watchList[i];
-        if(watch->getWatchId() == watchId)
-            return watch;
-    }
-    return NULL;
+    return m_watchMap.value(watchId, NULL);
 }
 
 
@@ -1291,6 +1969,7 @@ int Core::gdbAddVarWatch(QString varName, VarWatch** watchPtr)
     else
     {
         m_watchList.append(w);
+        m_watchMap[watchId] = w;
     }
     
     *watchPtr = w;
@@ -1347,6 +2026,7 @@ int Core::gdbExpandVarWatchChildren(QString watchId)
             watch->m_hasChildren = hasChildren;
             watch->m_parentWatchId = watchId;
             m_watchList.append(watch);
+            m_watchMap[childWatchId] = watch;
         }
 
         m_inf->ICore_onWatchVarChildAdded(*watch);
@@ -1394,6 +2074,7 @@ void Core::gdbRemoveVarWatch(QString watchId)
         if(watch->getWatchId() == watchId)
         {
             m_watchList.removeAt(i--);
+            m_watchMap.remove(watchId);
             delete watch;
         }
     }
@@ -1443,13 +2124,51 @@ void Core::onNotifyAsyncOut(Tree &tree, AsyncClass ac)
     // A new thread has been created
     else if(ac == GdbComListener::AC_THREAD_CREATED)
     {
-        gdbGetThreadList();
-        
+        int threadId = tree.getInt("id", -1);
+        if(threadId != -1 && !m_threadList.contains(threadId))
+        {
+            ThreadInfo tinfo;
+            tinfo.m_id = threadId;
+            tinfo.m_detailsGeneration = -1;
+            tinfo.m_running = false;
+            m_threadList[threadId] = tinfo;
+
+            if(m_inf)
+                m_inf->ICore_onThreadCreated(threadId);
+        }
+    }
+    else if(ac == GdbComListener::AC_THREAD_EXITED)
+    {
+        int threadId = tree.getInt("id", -1);
+        if(m_threadList.remove(threadId) > 0)
+        {
+            if(m_inf)
+                m_inf->ICore_onThreadExited(threadId);
+        }
+    }
+    else if(ac == GdbComListener::AC_THREAD_GROUP_EXITED)
+    {
+        m_threadList.clear();
+        if(m_inf)
+            m_inf->ICore_onThreadListChanged();
     }
     else if(ac == GdbComListener::AC_LIBRARY_LOADED)
     {
+        updateLibrary(decodeLibrary(tree.getRoot()));
+
+        // The symbols are read after the notification
+        m_librariesChanged = true;
         m_scanSources = true;
     }
+    else if(ac == GdbComListener::AC_LIBRARY_UNLOADED)
+    {
+        QString libId = tree.getString("id");
+        if(m_libraries.remove(libId) > 0)
+        {
+            if(m_inf)
+                m_inf->ICore_onLibrariesChanged();
+        }
+    }
     //tree.dump();
 }
 
@@ -1484,16 +2203,101 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
     
     //tree.dump();
 
+    static const TreePath threadIdPath("thread-id");
+
     // The program has stopped
     if(ac == GdbComListener::AC_STOPPED)
     {
+        MiStoppedRecord stopped;
+        stopped.decode(tree);
+
+        if(stopped.m_allStopped)
+            setThreadRunning(-1, false);
+        for(int i = 0;i < stopped.m_stoppedThreads.size();i++)
+            setThreadRunning(stopped.m_stoppedThreads[i], false);
+        if(stopped.m_threadId != 0)
+            setThreadRunning(stopped.m_threadId, false);
+
+        // Interrupted by the profiler?
+        if(m_sampleStopPending && isSampleStop(stopped))
+        {
+            m_sampleStopPending = false;
+            m_targetState = ICore::TARGET_STOPPED;
+
+            if(m_inf)
+                m_inf->ICore_onSampleStopped();
+
+            // Resume without letting anyone know that the target was stopped
+            if(com.command(NULL, "-exec-continue") != GDB_ERROR)
+                m_targetState = ICore::TARGET_RUNNING;
+            return;
+        }
+
+        // The interrupt sent by the profiler may still be delivered when the target is resumed.
+        // It is then shown as a normal stop since the user may have been stepping.
+        if(m_sampleStopStale && isSampleStop(stopped))
+            infoMsg("Stopped by the interrupt of a profiler sample");
+        m_sampleStopStale = m_sampleStopPending;
+        m_sampleStopPending = false;
+
+        if(m_nonStop && stopped.m_threadId != 0 && stopped.m_threadId != m_selectedThreadId)
+        {
+            // Keep showing the selected thread if the user is looking at it
+            if(m_targetState == ICore::TARGET_STOPPED && stopped.m_reason != "exited-normally" &&
+                stopped.m_reason != "exited" && stopped.m_reason != "exited-signalled")
+            {
+                infoMsg("Thread %d stopped", stopped.m_threadId);
+                if(m_threadList.contains(stopped.m_threadId))
+                    m_threadList[stopped.m_threadId].m_detailsGeneration = -1;
+                if(m_inf)
+                    m_inf->ICore_onThreadDetailsChanged(stopped.m_threadId);
+                return;
+            }
+
+            // Switch to the thread that stopped. Its frame is reported below.
+            m_quietFrame = true;
+            if(com.commandF(NULL, "-thread-select %d", stopped.m_threadId) == GDB_DONE)
+                m_selectedThreadId = stopped.m_threadId;
+            m_quietFrame = false;
+        }
+
         m_targetState = ICore::TARGET_STOPPED;
+        reportReady();
 
         if(m_pid == 0)
             com.command(NULL, "-list-thread-groups");
-         
-        // Any new or destroyed thread?
-        com.commandF(NULL, "-thread-info");
+
+        if(m_librariesChanged)
+            gdbGetLibraries();
+
+        // Stopped in a library without symbols?
+        if(m_lazySharedLibs && stopped.m_hasFrame && stopped.m_frame.m_fullname.isEmpty())
+        {
+            if(loadLibraryAt(stopped.m_frame.m_from, stopped.m_frame.m_addr) == 0)
+            {
+                // Get the frame again now that the source is known
+                Tree frameData;
+                m_quietFrame = true;
+                if(com.command(&frameData, "-stack-info-frame") == GDB_DONE)
+                {
+                    TreeNode *frameNode = frameData.findChild("frame");
+                    if(frameNode)
+                    {
+                        stopped.m_frame = MiFrameRecord();
+                        stopped.m_frame.decode(frameNode);
+                    }
+                }
+                m_quietFrame = false;
+            }
+        }
+
+        // The threads are tracked by the =thread-created/=thread-exited
+        // notifications. Only the details (current frame) are outdated now.
+        m_threadDetailsGeneration++;
+        if(m_threadList.isEmpty())
+            gdbGetThreadList();
+        else if(m_inf)
+            m_inf->ICore_onThreadDetailsInvalidated();
 
         com.commandF(NULL, "-var-update --all-values *");
         com.commandF(NULL, "-stack-list-variables --no-values");
@@ -1511,7 +2315,7 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
 
 
         // Get the reason
-        QString reasonString = tree.getString("reason");
+        QString reasonString = stopped.m_reason;
         ICore::StopReason  reason;
         if(reasonString.isEmpty())
             reason = ICore::UNKNOWN;
@@ -1525,12 +2329,12 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
         
         if(m_inf)
         {
-            QString p = tree.getString("frame/fullname");
-            int lineNo = tree.getInt("frame/line");
+            QString p = stopped.m_frame.m_fullname;
+            int lineNo = stopped.m_frame.m_line;
 
             if(reason == ICore::SIGNAL_RECEIVED)
             {
-                QString signalName = tree.getString("signal-name");
+                QString signalName = stopped.m_signalName;
                 if(signalName == "SIGTRAP" && m_isRemote)
                 {
                     m_inf->ICore_onStopped(reason, p, lineNo);
@@ -1550,20 +2354,22 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
             m_inf->ICore_onFrameVarReset();
 
 
-            TreeNode *argsNode = tree.findChild("frame/args");
+            TreeNode *argsNode = stopped.m_frame.m_argsNode;
             if(argsNode)
             {
+                static const TreePath namePath("name");
+                static const TreePath valuePath("value");
                 for(int i = 0;i < argsNode->getChildCount();i++)
                 {
                     TreeNode *child2 = argsNode->getChild(i);
-                    QString varName = child2->getChildDataString("name");
-                    QString varValue = child2->getChildDataString("value");
+                    QString varName = child2->getChildDataString(namePath);
+                    QString varValue = child2->getChildDataString(valuePath);
                     if(m_inf)
                         m_inf->ICore_onFrameVarChanged(varName, varValue);
                 }
             }
 
-            int frameIdx = tree.getInt("frame/level");
+            int frameIdx = stopped.m_frame.m_level;
             m_currentFrameIdx = frameIdx;
             m_inf->ICore_onCurrentFrameChanged(frameIdx);
 
@@ -1571,18 +2377,41 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
     }
     else if(ac == GdbComListener::AC_RUNNING)
     {
-        m_targetState = ICore::TARGET_RUNNING;
+        QString runThreadIdStr = tree.getString(threadIdPath);
+        int runThreadId = runThreadIdStr == "all" ? -1 : runThreadIdStr.toInt(0,0);
+        setThreadRunning(runThreadId, true);
+
+        // The other threads are still stopped in non-stop mode
+        if(!m_nonStop || runThreadId == -1 || runThreadId == m_selectedThreadId)
+            m_targetState = ICore::TARGET_RUNNING;
+
+        if(m_nonStop && m_inf)
+        {
+            if(runThreadId == -1)
+                m_inf->ICore_onThreadDetailsInvalidated();
+            else
+                m_inf->ICore_onThreadDetailsChanged(runThreadId);
+        }
 
         debugMsg("is running");
     }
 
     // Get the current thread
-    QString threadIdStr = tree.getString("thread-id");
-    if(threadIdStr.isEmpty() == false)
+    if(m_nonStop)
     {
-        int threadId = threadIdStr.toInt(0,0);
-        if(m_inf)
-            m_inf->ICore_onCurrentThreadChanged(threadId);
+        // Only changed when switching to the thread that stopped
+        if(ac == GdbComListener::AC_STOPPED && m_inf)
+            m_inf->ICore_onCurrentThreadChanged(m_selectedThreadId);
+    }
+    else
+    {
+        QString threadIdStr = tree.getString(threadIdPath);
+        if(threadIdStr.isEmpty() == false)
+        {
+            int threadId = threadIdStr.toInt(0,0);
+            if(m_inf)
+                m_inf->ICore_onCurrentThreadChanged(threadId);
+        }
     }
 
     // State changed?
@@ -1651,7 +2480,9 @@ void Core::gdbGetThreadList()
     GdbCom& com = GdbCom::getInstance();
     Tree resultData;
 
-    if(m_targetState == ICore::TARGET_STARTING || m_targetState == ICore::TARGET_RUNNING)
+    // The stopped threads can be queried while the others are running in non-stop mode
+    if(m_targetState == ICore::TARGET_STARTING ||
+        (m_targetState == ICore::TARGET_RUNNING && !m_nonStop))
     {
         if(m_inf)
             m_inf->ICore_onMessage("Program is currently running");
@@ -1659,9 +2490,72 @@ void Core::gdbGetThreadList()
     }
 
     
+    m_threadListFullRefresh = true;
     com.commandF(&resultData, "-thread-info");    
+    m_threadListFullRefresh = false;
+
+}
+
+
+/**
+ * @brief Requests the details (Eg: current function) for a set of threads.
+ */
+void Core::gdbGetThreadDetails(QList<int> threadIdList)
+{
+    GdbCom& com = GdbCom::getInstance();
+    QStringList cmdList;
+    QList<Tree*> resultList;
 
+    if(m_targetState == ICore::TARGET_STARTING ||
+        (m_targetState == ICore::TARGET_RUNNING && !m_nonStop))
+        return;
+
+    for(int i = 0;i < threadIdList.size();i++)
+    {
+        int threadId = threadIdList[i];
+        if(!m_threadList.contains(threadId) || m_threadList[threadId].m_running)
+            continue;
+
+        // Mark it as fetched even if GDB does not know about it (to not request it again)
+        m_threadList[threadId].m_detailsGeneration = m_threadDetailsGeneration;
+        cmdList += QString::asprintf("-thread-info %d", threadId);
+        resultList += new Tree;
+    }
+
+    // Send all requests at once to not have to wait for GDB between each thread
+    com.commandBatch(cmdList, resultList);
 
+    for(int i = 0;i < resultList.size();i++)
+        delete resultList[i];
+}
+
+
+/**
+ * @brief Fills in a ThreadInfo from a thread node in a '-thread-info' response.
+ */
+void Core::parseThreadNode(TreeNode *node, ThreadInfo *tinfo)
+{
+    MiThreadRecord record;
+    record.decode(node);
+    QString funcName = record.m_frame.m_func;
+    QString details = record.m_details;
+
+    if(details.isEmpty())
+    {
+        if(!funcName.isEmpty())
+        {
+            details = QString("Executing %1()").arg(funcName);
+            if(record.m_frame.m_line > 0)
+                details += QString(" @ L%1").arg(record.m_frame.m_line);
+        }
+    }
+    
+    tinfo->m_id = record.m_id;
+    tinfo->m_name = record.m_targetId;
+    tinfo->m_details = details;
+    tinfo->m_func = funcName;
+    tinfo->m_detailsGeneration = m_threadDetailsGeneration;
+    tinfo->m_running = record.m_running;
 }
 
 
@@ -1721,27 +2615,37 @@ void Core::dispatchBreakpointDeleted(int id)
 
 void Core::dispatchBreakpointTree(Tree &tree)
 {
-    TreeNode *rootNode = tree.findChild("bkpt");
+    static const TreePath bkptPath("bkpt");
+    TreeNode *rootNode = tree.findChild(bkptPath);
     if(!rootNode)
         return;
-    int lineNo = rootNode->getChildDataInt("line");
-    int number = rootNode->getChildDataInt("number");
+    MiBreakpointRecord record;
+    record.decode(rootNode);
+    int lineNo = record.m_line;
+    int number = record.m_number;
                 
 
     BreakPoint *bkpt = findBreakPointByNumber(number);
+    bool isNew = false;
     if(bkpt == NULL)
     {
         bkpt = new BreakPoint(number);
         m_breakpoints.push_back(bkpt);
+        isNew = true;
     }
+    QString oldFullname = bkpt->m_fullname;
+    int oldLineNo = bkpt->m_lineNo;
+    QString oldFuncName = bkpt->m_funcName;
+    unsigned long long oldAddr = bkpt->m_addr;
+    bool oldIsLogPoint = bkpt->m_isLogPoint;
     bkpt->m_lineNo = lineNo;
-    bkpt->m_fullname = rootNode->getChildDataString("fullname");
+    bkpt->m_fullname = record.m_fullname;
 
     // We did not receive 'fullname' from gdb.
     // Lets try original-location instead...
     if(bkpt->m_fullname.isEmpty())
     {
-        QString orgLoc = rootNode->getChildDataString("original-location");
+        QString orgLoc = record.m_originalLocation;
         int divPos = orgLoc.lastIndexOf(":");
         if(divPos == -1)
             warnMsg("Original-location in unknown format");
@@ -1751,8 +2655,20 @@ void Core::dispatchBreakpointTree(Tree &tree)
         }
     }
     
-    bkpt->m_funcName = rootNode->getChildDataString("func");
-    bkpt->m_addr = rootNode->getChildDataLongLong("addr");
+    bkpt->m_funcName = record.m_func;
+    bkpt->m_addr = record.m_addr;
+    bkpt->m_isLogPoint = (record.m_type == "dprintf");
+
+    // GDB sends breakpoint-modified on every hit (eg: of a dprintf) just to
+    // update the hit count which is not shown, so only tell the gui if
+    // something it shows has changed.
+    if(!isNew &&
+        bkpt->m_fullname == oldFullname &&
+        bkpt->m_lineNo == oldLineNo &&
+        bkpt->m_funcName == oldFuncName &&
+        bkpt->m_addr == oldAddr &&
+        bkpt->m_isLogPoint == oldIsLogPoint)
+        return;
 
     if(m_inf)
         m_inf->ICore_onBreakpointsChanged();
@@ -1778,14 +2694,15 @@ void Core::onResult(Tree &tree)
             debugMsg("Changelist");
             for(int j = 0;j < rootNode->getChildCount();j++)
             {
-                TreeNode *child = rootNode->getChild(j);
-                QString watchId = child->getChildDataString("name");
+                MiChangelistEntry change;
+                change.decode(rootNode->getChild(j));
+                QString watchId = change.m_name;
                 VarWatch *watch = getVarWatchInfo(watchId);
 
                 bool typeChanged = false;
                 
                 // Watch no longer exist?
-                QString inscopeText = child->getChildDataString("in_scope");
+                QString inscopeText = change.m_inScope;
                 if(inscopeText == "invalid")
                 {
                     QString varName = watch->getName();
@@ -1799,7 +2716,7 @@ void Core::onResult(Tree &tree)
                 else
                 {
                 // If the type has changed then all of the children must be removed.
-                QString typeChangeText = child->getChildDataString("type_changed");
+                QString typeChangeText = change.m_typeChanged;
                 if(typeChangeText == "true")
                     typeChanged = true;
                 else if(watch != NULL && typeChanged)
@@ -1815,8 +2732,8 @@ void Core::onResult(Tree &tree)
                         gdbRemoveVarWatch(removeList[cidx]->getWatchId());
                     }
                     watch->setValue("");
-                    watch->m_varType = child->getChildDataString("new_type");
-                    watch->m_hasChildren = child->getChildDataInt("new_num_children") > 0 ? true : false;
+                    watch->m_varType = change.m_newType;
+                    watch->m_hasChildren = change.m_newNumChildren > 0 ? true : false;
                     m_inf->ICore_onWatchVarChanged(*watch);
 
                 }
@@ -1824,8 +2741,8 @@ void Core::onResult(Tree &tree)
                 else if(watch)
                 {
                     
-                watch->setValue(child->getChildDataString("value"));
-                QString inScopeStr = child->getChildDataString("in_scope");
+                watch->setValue(change.m_value);
+                QString inScopeStr = change.m_inScope;
                 if(inScopeStr == "true" || inScopeStr.isEmpty())
                     watch->m_inScope = true;
                 else
@@ -1860,38 +2777,40 @@ void Core::onResult(Tree &tree)
         }
         else if(rootName == "threads")
         {
-            m_threadList.clear();
-            
-            // Parse the result
-            for(int cIdx = 0;cIdx < rootNode->getChildCount();cIdx++)
+            // A complete list of threads?
+            if(m_threadListFullRefresh)
+            {
+                m_threadList.clear();
+                
+                for(int cIdx = 0;cIdx < rootNode->getChildCount();cIdx++)
+                {
+                    ThreadInfo tinfo;
+                    parseThreadNode(rootNode->getChild(cIdx), &tinfo);
+                    m_threadList[tinfo.m_id] = tinfo;
+                }
+
+                if(m_inf)
+                    m_inf->ICore_onThreadListChanged();
+            }
+            else
             {
-                TreeNode *child = rootNode->getChild(cIdx);
-                QString threadId = child->getChildDataString("id");
-                QString targetId = child->getChildDataString("target-id");
-                QString funcName = child->getChildDataString("frame/func");
-                QString lineNo  = child->getChildDataString("frame/line");
-                QString details = child->getChildDataString("details");
-
-                if(details.isEmpty())
+                // Only update the threads that we got info about
+                for(int cIdx = 0;cIdx < rootNode->getChildCount();cIdx++)
                 {
-                    if(!funcName.isEmpty())
+                    ThreadInfo tinfo;
+                    parseThreadNode(rootNode->getChild(cIdx), &tinfo);
+                    bool isNew = !m_threadList.contains(tinfo.m_id);
+                    m_threadList[tinfo.m_id] = tinfo;
+
+                    if(m_inf)
                     {
-                        details = QString("Executing %1()").arg(funcName);
-                        if(!lineNo.isEmpty())
-                            details += QString(" @ L%1").arg(lineNo);
+                        if(isNew)
+                            m_inf->ICore_onThreadCreated(tinfo.m_id);
+                        else
+                            m_inf->ICore_onThreadDetailsChanged(tinfo.m_id);
                     }
                 }
-                
-                ThreadInfo tinfo;
-                tinfo.m_id = atoi(stringToCStr(threadId));
-                tinfo.m_name = targetId;
-                tinfo.m_details = details;
-                tinfo.m_func = funcName;
-                m_threadList[tinfo.m_id] = tinfo;
             }
-
-            if(m_inf)
-                m_inf->ICore_onThreadListChanged();
             
         }
         else if(rootName == "current-thread-id")
@@ -1902,11 +2821,13 @@ void Core::onResult(Tree &tree)
                 m_inf->ICore_onCurrentThreadChanged(threadId);
             
         }
-        else if(rootName == "frame")
+        else if(rootName == "frame" && !m_quietFrame)
         {
-            QString p = rootNode->getChildDataString("fullname");
-            int lineNo = rootNode->getChildDataInt("line");
-            int frameIdx = rootNode->getChildDataInt("level");
+            MiFrameRecord frame;
+            frame.decode(rootNode);
+            QString p = frame.m_fullname;
+            int lineNo = frame.m_line;
+            int frameIdx = frame.m_level;
             ICore::StopReason  reason = ICore::UNKNOWN;
              
             m_currentFrameIdx = frameIdx;
@@ -1918,14 +2839,16 @@ void Core::onResult(Tree &tree)
 
                 m_inf->ICore_onFrameVarReset();
 
-                TreeNode *argsNode = rootNode->findChild("args");
+                TreeNode *argsNode = frame.m_argsNode;
                 if(argsNode)
                 {
+                static const TreePath namePath("name");
+                static const TreePath valuePath("value");
                 for(int i = 0;i < argsNode->getChildCount();i++)
                 {
                     TreeNode *child = argsNode->getChild(i);
-                    QString varName = child->getChildDataString("name");
-                    QString varValue = child->getChildDataString("value");
+                    QString varName = child->getChildDataString(namePath);
+                    QString varValue = child->getChildDataString(valuePath);
                     if(m_inf)
                         m_inf->ICore_onFrameVarChanged(varName, varValue);
                 }
@@ -1933,23 +2856,25 @@ void Core::onResult(Tree &tree)
             }
         }
         // A stack frame dump?
-        else if(rootName == "stack")
+        else if(rootName == "stack" && !m_quietStackList)
         {
             QList<StackFrameEntry> stackFrameList;
-            for(int j = 0;j < rootNode->getChildCount();j++)
-            {
-                const TreeNode *child = rootNode->getChild(j);
-                
-                StackFrameEntry entry;
-                entry.m_functionName = child->getChildDataString("func");
-                entry.m_line = child->getChildDataInt("line");
-                entry.m_sourcePath = child->getChildDataString("fullname");
-                stackFrameList.push_front(entry);
-            }
+            parseStackNode(rootNode, &stackFrameList);
+
+            // First page or an older page?
+            bool isFirstPage = m_stackFramesLoaded == 0 ? true : false;
+            m_stackFramesLoaded += stackFrameList.size();
+            if(m_stackFramesLoaded > m_stackDepth)
+                m_stackDepth = m_stackFramesLoaded;
             if(m_inf)
             {
-                m_inf->ICore_onStackFrameChange(stackFrameList);
-                m_inf->ICore_onCurrentFrameChanged(m_currentFrameIdx);
+                if(isFirstPage)
+                {
+                    m_inf->ICore_onStackFrameChange(stackFrameList);
+                    m_inf->ICore_onCurrentFrameChanged(m_currentFrameIdx);
+                }
+                else
+                    m_inf->ICore_onStackFramesLoaded(stackFrameList);
             }
         }
         // Local variables?
@@ -2012,7 +2937,13 @@ void Core::onConsoleStreamOutput(QString str)
         debugMsg("GDB | Console-stream | '%s'", stringToCStr(text));
 
         if(m_inf)
-            m_inf->ICore_onConsoleStream(text);
+        {
+            // Messages from the log points are shown separately
+            if(text.startsWith(LOGPOINT_TAG))
+                m_inf->ICore_onLogPointOutput(text.mid(strlen(LOGPOINT_TAG)));
+            else
+                m_inf->ICore_onConsoleStream(text);
+        }
     }
 }
 
@@ -2050,9 +2981,40 @@ int Core::gdbSetBreakpoint(QString filename, int lineNo)
     if(filename.isEmpty())
         return -1;
 
+    // Move the breakpoint to the next line with code. The line table only
+    // covers the program so it is not used once a library may have code for the file.
+    if(m_lineTable.hasFile(filename) && !hasLibrarySymbols() && !hasDeferredLibraries())
+    {
+        int codeLineNo = m_lineTable.findCodeLine(filename, lineNo);
+        if(codeLineNo != -1 && codeLineNo != lineNo)
+        {
+            infoMsg("Moving breakpoint from line %d to line %d", lineNo, codeLineNo);
+            lineNo = codeLineNo;
+        }
+    }
+
     ensureStopped();
     
     int res = com.commandF(&resultData, "-break-insert %s:%d", stringToCStr(filename), lineNo);
+
+    // The file may be in a library that has not been loaded yet
+    if(res == GDB_ERROR && m_lazySharedLibs && hasDeferredLibraries() &&
+        resultData.getString("msg").startsWith("No source file named"))
+    {
+        // Only load all of them if the library could not be found from the line tables
+        bool allRead;
+        QString libId = findDeferredLibraryWithFile(filename, &allRead);
+        int loadRc = -1;
+        if(!libId.isEmpty())
+            loadRc = gdbLoadLibrarySymbols(libId);
+        else if(!allRead)
+        {
+            infoMsg("Loading the symbols of the shared libraries to find %s", stringToCStr(filename));
+            loadRc = gdbLoadLibrarySymbols("");
+        }
+        if(loadRc == 0)
+            res = com.commandF(&resultData, "-break-insert %s:%d", stringToCStr(filename), lineNo);
+    }
     if(res == GDB_ERROR)
     {
         rc = -1;
@@ -2063,6 +3025,52 @@ int Core::gdbSetBreakpoint(QString filename, int lineNo)
 }
 
 
+/**
+ * @brief Adds a log point (dprintf) that prints a message each time a line is reached.
+ *
+ * The target is only stopped for a moment to print the message, or not at
+ * all if the message is printed by the agent in gdbserver.
+ * @param format   The printf format (as written inside the quotes in C).
+ * @param args     The expressions to print.
+ */
+int Core::gdbSetLogPoint(QString filename, int lineNo, QString format, QStringList args)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+    int rc = 0;
+
+    if(filename.isEmpty())
+        return -1;
+
+    if(!format.endsWith("\\n"))
+        format += "\\n";
+
+    // Tag the messages printed by GDB so they can be told apart from the rest of the console output
+    if(m_logPointStyle == "gdb")
+        format = LOGPOINT_TAG + format;
+
+    QString cmd = QString("-dprintf-insert %1:%2 \"%3\"").arg(filename).arg(lineNo).arg(format);
+    for(int i = 0;i < args.size();i++)
+    {
+        QString arg = args[i];
+        arg.replace("\\", "\\\\");
+        arg.replace("\"", "\\\"");
+        cmd += " \"" + arg + "\"";
+    }
+
+    ensureStopped();
+
+    int res = com.command(&resultData, cmd);
+    if(res == GDB_ERROR)
+    {
+        rc = -1;
+        warnMsg("Failed to set log point at %s:%d", stringToCStr(filename), lineNo);
+    }
+
+    return rc;
+}
+
+
 /**
  * @brief Returns a list of threads.
  */
@@ -2072,6 +3080,20 @@ QList<ThreadInfo> Core::getThreadList()
 }
 
 
+/**
+ * @brief Returns the last known info about a thread.
+ * @return false if the thread does not exist.
+ */
+bool Core::getThreadInfo(int threadId, ThreadInfo *tinfo)
+{
+    QMap<int, ThreadInfo>::const_iterator it = m_threadList.constFind(threadId);
+    if(it == m_threadList.constEnd())
+        return false;
+    *tinfo = it.value();
+    return true;
+}
+
+
 /**
  * @brief Changes context to a specified thread.
  */
@@ -2089,6 +3111,47 @@ void Core::selectThread(int threadId)
 
         
         m_selectedThreadId = threadId;
+
+        // The target state follows the selected thread in non-stop mode
+        if(m_nonStop && m_threadList.contains(threadId))
+        {
+            if(m_threadList[threadId].m_running)
+                m_targetState = ICore::TARGET_RUNNING;
+            else
+            {
+                m_targetState = ICore::TARGET_STOPPED;
+
+                com.commandF(NULL, "-var-update --all-values *");
+                com.commandF(NULL, "-stack-list-variables --no-values");
+            }
+
+            if(m_inf && m_lastTargetState != m_targetState)
+            {
+                m_inf->ICore_onStateChanged(m_targetState);
+                m_lastTargetState = m_targetState;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Updates the running state of a thread.
+ * @param threadId   The thread or -1 for all threads.
+ */
+void Core::setThreadRunning(int threadId, bool running)
+{
+    if(threadId == -1)
+    {
+        QMap<int, ThreadInfo>::iterator it;
+        for(it = m_threadList.begin();it != m_threadList.end();++it)
+            it.value().m_running = running;
+    }
+    else
+    {
+        QMap<int, ThreadInfo>::iterator it = m_threadList.find(threadId);
+        if(it != m_threadList.end())
+            it.value().m_running = running;
     }
 }
 
@@ -2237,4 +3300,40 @@ QDateTime Core::getTimeStarted()
 }
 
 
+/**
+ * @brief Remembers the identity of the program that GDB has loaded.
+ */
+void Core::rememberProgram(QString programPath)
+{
+    m_programPath = programPath;
+    m_programModTime = QFileInfo(programPath).lastModified();
+    m_programBuildId = readElfBuildId(programPath);
+    m_lineTable.load(programPath);
+}
+
+
+/**
+ * @brief Checks if a program differs from the one that GDB has loaded.
+ *
+ * A program that has been rebuilt with the same result (same build-id)
+ * is not considered changed.
+ */
+bool Core::isProgramChanged(QString programPath)
+{
+    if(programPath != m_programPath)
+        return true;
+
+    QDateTime modTime = QFileInfo(programPath).lastModified();
+    if(modTime == m_programModTime)
+        return false;
+
+    if(m_programBuildId.isEmpty() || readElfBuildId(programPath) != m_programBuildId)
+        return true;
+
+    // Relinked without any change
+    m_programModTime = modTime;
+    return false;
+}
+
+
 
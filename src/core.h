@@ -16,12 +16,15 @@
 #include <QObject>
 #include <QVector>
 #include <QDateTime>
+#include <QElapsedTimer>
 
 #include "com.h"
 #include "settings.h"
+#include "dwarflinetable.h"
 
 
 class Core;
+class MiStoppedRecord;
 
 struct ThreadInfo
 {
@@ -30,6 +33,8 @@ struct ThreadInfo
 
     QString m_func; //!< The name of the function (Eg: "func"). 
     QString m_details;  //!< Additional information about the thread provided by the target.
+    int m_detailsGeneration; //!< The stop generation that m_details was fetched in (-1 = never fetched).
+    bool m_running; //!< True if the thread is running (threads run and stop independently in non-stop mode).
 };
 
 
@@ -42,12 +47,27 @@ struct StackFrameEntry
 };
 
 
+/**
+ * @brief A shared library loaded by the target.
+ */
+class SharedLibrary
+{
+public:
+    SharedLibrary() : m_symbolsLoaded(false), m_fromAddr(0), m_toAddr(0) {};
+
+    QString m_id; //!< The name used by GDB (Eg: "/lib/libc.so.6").
+    QString m_hostName; //!< The path of the library on the host.
+    bool m_symbolsLoaded; //!< False if the symbols has been deferred.
+    unsigned long long m_fromAddr; //!< Lowest address of the code (0 if not known).
+    unsigned long long m_toAddr;
+};
+
+
 class SourceFile
 {
 public:
     QString m_name;
     QString m_fullName;
-    QDateTime m_modTime;
 };
 
 /**
@@ -56,7 +76,7 @@ public:
 class BreakPoint
 {
 public:
-    BreakPoint(int number) : m_number(number) { };
+    BreakPoint(int number) : m_number(number), m_lineNo(0), m_addr(0), m_isLogPoint(false) { };
 
 public:
     int m_number;
@@ -64,6 +84,7 @@ public:
     int m_lineNo;
     QString m_funcName;
     unsigned long long m_addr;
+    bool m_isLogPoint; //!< Prints a message instead of stopping (dprintf).
     
 private:
     BreakPoint(){};
@@ -100,6 +121,7 @@ public:
 
 private:
     void clear();
+    QString formatData(DispFormat fmt) const;
 
 
 private:
@@ -111,6 +133,9 @@ private:
     QString m_varType;
     bool m_hasChildren;
     bool m_addressValid;
+
+    mutable QString m_dispCache[FMT_NATIVE]; //!< The formatted data (indexed by DispFormat-1).
+    mutable int m_dispCacheValid; //!< Bitmask with the valid entries in m_dispCache.
 };
 
 
@@ -180,15 +205,33 @@ class ICore
     virtual void ICore_onWatchVarChanged(VarWatch &watch) = 0;
     virtual void ICore_onWatchVarDeleted(VarWatch &watch) = 0;
     virtual void ICore_onConsoleStream(QString text) = 0;
+    virtual void ICore_onLogPointOutput(QString text) = 0;
+    virtual void ICore_onSampleStopped() = 0;
     virtual void ICore_onBreakpointsChanged() = 0;
     virtual void ICore_onThreadListChanged() = 0;
+    virtual void ICore_onThreadCreated(int threadId) = 0;
+    virtual void ICore_onThreadExited(int threadId) = 0;
+    virtual void ICore_onThreadDetailsChanged(int threadId) = 0;
+    virtual void ICore_onThreadDetailsInvalidated() = 0;
     virtual void ICore_onCurrentThreadChanged(int threadId) = 0;
     virtual void ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList) = 0;
+
+    /**
+     * @brief Called when older frames of the stack has been fetched.
+     * @param stackFrameList    The new frames (oldest frame first). They are older than the already reported frames.
+     */
+    virtual void ICore_onStackFramesLoaded(QList<StackFrameEntry> stackFrameList) = 0;
     virtual void ICore_onMessage(QString message) = 0;
     virtual void ICore_onTargetOutput(QString message) = 0;
     virtual void ICore_onCurrentFrameChanged(int frameIdx) = 0;
     virtual void ICore_onSourceFileListChanged() = 0;
-    virtual void ICore_onSourceFileChanged(QString filename) = 0;
+    virtual void ICore_onLibrariesChanged() = 0;
+
+    /**
+     * @brief Called the first time the target stops after GDB was started.
+     * @param readyTime    Number of ms since GDB was started.
+     */
+    virtual void ICore_onReady(int readyTime) = 0;
 
     /**
      * @brief Called when a new child item has been added for a watched item.
@@ -228,6 +271,7 @@ public:
     void setListener(ICore *inf) { m_inf = inf; };
 
     QDateTime getTimeStarted();
+    bool isProgramChanged(QString programPath);
 private:
     
      void onNotifyAsyncOut(Tree &tree, AsyncClass ac);
@@ -240,11 +284,27 @@ private:
 
     void dispatchBreakpointDeleted(int id);
     void dispatchBreakpointTree(Tree &tree);
+    void parseThreadNode(TreeNode *node, ThreadInfo *tinfo);
+    static void parseStackNode(const TreeNode *node, QList<StackFrameEntry> *stackFrameList);
     static ICore::StopReason parseReasonString(QString string);
     void detectMemoryDepth();
     static int openPseudoTerminal();
     void ensureStopped();
+    int initNonStop(Settings *cfg);
+    int initLogPoints(Settings *cfg);
+    int initSharedLibs(Settings *cfg);
+    int initIndexCache(Settings *cfg);
+    void reportReady();
+    bool isSampleStop(const MiStoppedRecord &stopped) const;
     int runInitCommands(Settings *cfg);
+    void rememberProgram(QString programPath);
+    int gdbWarmReload(Settings &cfg);
+    void setThreadRunning(int threadId, bool running);
+    void updateLibrary(const SharedLibrary &lib);
+    bool hasDeferredLibraries();
+    bool hasLibrarySymbols();
+    int loadLibraryAt(QString from, unsigned long long addr);
+    QString findDeferredLibraryWithFile(QString filename, bool *allRead);
     int priv_gdbVarWatchCreate(QString varName, QString watchId, VarWatch* watch);
 
 public:
@@ -271,8 +331,15 @@ public:
     int jump(QString filename, int lineNo);
 
     int gdbSetBreakpoint(QString filename, int lineNo);
+    int gdbSetLogPoint(QString filename, int lineNo, QString format, QStringList args);
     void gdbGetThreadList();
+    void gdbGetThreadDetails(QList<int> threadIdList);
     void getStackFrames();
+    void getMoreStackFrames();
+    int getStackDepth() { return m_stackDepth; };
+    int getLoadedStackFrameCount() { return m_stackFramesLoaded; };
+    bool isStackDepthCapped() { return m_stackDepthCapped; };
+    void gdbGetThreadStacks(QList<int> threadIdList, int maxDepth, QMap<int, QList<StackFrameEntry> > *stacks);
     void stop();
     int gdbExpandVarWatchChildren(QString watchId);
     int gdbGetMemory(quint64 addr, size_t count, QByteArray *data);
@@ -288,6 +355,9 @@ public:
     void gdbRemoveAllBreakpoints();
 
     QList<ThreadInfo> getThreadList();
+    QList<int> getThreadIdList() { return m_threadList.keys(); };
+    bool getThreadInfo(int threadId, ThreadInfo *tinfo);
+    int getThreadDetailsGeneration() { return m_threadDetailsGeneration; };
 
     // Watch
     VarWatch *getVarWatchInfo(QString watchId);
@@ -298,10 +368,19 @@ public:
 
     
     QVector <SourceFile*> getSourceFiles() { return m_sourceFiles; };
+    QVector<int> getCodeLines(QString filename) const { return m_lineTable.getCodeLines(filename); };
+
+    // Shared libraries
+    QList<SharedLibrary> getLibraries() { return m_libraries.values(); };
+    int gdbGetLibraries();
+    int gdbLoadLibrarySymbols(QString libId);
+    bool isLazySharedLibs() { return m_lazySharedLibs; };
 
     void writeTargetStdin(QString text);
 
     bool isRunning();
+    int sampleStop();
+    bool isNonStop() { return m_nonStop; };
     
 private slots:
         void onGdbOutput(int socketNr);
@@ -311,22 +390,42 @@ private:
     QList<BreakPoint*> m_breakpoints;
     QVector <SourceFile*> m_sourceFiles;
     QMap <int, ThreadInfo> m_threadList;
+    int m_threadDetailsGeneration; //!< Incremented each time the target stops (thread details becomes stale).
+    bool m_threadListFullRefresh; //!< True while a full '-thread-info' is being requested.
+    bool m_quietStackList; //!< True if stack lists should not be reported to the listener.
+    bool m_quietFrame; //!< True if a frame result should not be reported to the listener.
+    bool m_sampleStopPending; //!< True if the target has been interrupted to take a sample.
+    bool m_sampleStopStale; //!< True if the target stopped for another reason before the sample interrupt arrived.
+    QString m_logPointStyle; //!< The dprintf-style used ("gdb", "call" or "agent").
+    bool m_nonStop; //!< True if GDB is in non-stop mode (m_targetState is the state of the selected thread).
     int m_selectedThreadId;
     ICore::TargetState m_targetState;
     ICore::TargetState m_lastTargetState;
     int m_pid;
     int m_currentFrameIdx;
+    int m_stackDepth; //!< Number of frames in the stack (max STACK_MAX_DEPTH).
+    bool m_stackDepthCapped; //!< The stack is deeper than STACK_MAX_DEPTH frames.
+    int m_stackFramesLoaded; //!< Number of frames (starting with the newest) that has been fetched.
     QList <VarWatch*> m_watchList;
+    QHash<QString, VarWatch*> m_watchMap; //!< m_watchList indexed by watchId.
     int m_varWatchLastId;
     bool m_isRemote; //!< True if "remote target" or false if it is a "local target".
     int m_ptsFd;
     bool m_scanSources; //!< True if the source filelist may have changed
+    QMap<QString, SharedLibrary> m_libraries; //!< The loaded shared libraries indexed by id.
+    bool m_librariesChanged; //!< True if the symbol state of m_libraries may be outdated.
+    bool m_lazySharedLibs; //!< True if the symbols of the shared libraries are loaded on demand.
     QSocketNotifier  *m_ptsListener;
 
     QStringList m_localVars;
     int m_memDepth; //!< The memory depth. (Either 64 or 32).
     ConnectionMode m_connectionMode; // The debug mode (tcpip, local, coredump)
     QDateTime m_lastRunTime; //!<  The time init function was called and gdb was started.
+    QElapsedTimer m_readyTimer; //!< Started when gdb is started and invalidated when the target has stopped.
+    QString m_programPath; //!< The program that GDB has loaded the symbols of.
+    QDateTime m_programModTime; //!< The modification time of m_programPath when it was loaded.
+    QByteArray m_programBuildId; //!< The GNU build-id of m_programPath when it was loaded.
+    DwarfLineTable m_lineTable; //!< The source files and code lines of m_programPath.
 };
 
 
@@ -0,0 +1,815 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "dwarflinetable.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <string.h>
+#include <algorithm>
+
+#include "config.h"
+#include "tracelog.h"
+#include "log.h"
+
+
+#define SHT_NOBITS       8
+#define SHF_COMPRESSED   0x800
+
+#define DW_AT_stmt_list   0x10
+#define DW_AT_comp_dir    0x1b
+
+#define DW_UT_compile        0x01
+#define DW_UT_partial        0x03
+#define DW_UT_skeleton       0x04
+#define DW_UT_split_compile  0x05
+
+#define DW_LNCT_path              0x1
+#define DW_LNCT_directory_index   0x2
+
+#define DW_FORM_implicit_const   0x21
+
+#define DW_LNS_copy               1
+#define DW_LNS_advance_pc         2
+#define DW_LNS_advance_line       3
+#define DW_LNS_set_file           4
+#define DW_LNS_set_column         5
+#define DW_LNS_negate_stmt        6
+#define DW_LNS_fixed_advance_pc   9
+#define DW_LNS_set_isa            12
+
+#define DW_LNE_end_sequence   1
+#define DW_LNE_define_file    3
+
+
+/**
+ * @brief Reads values from a part of a debug section.
+ *
+ * Reading past the end sets the error flag and returns zeros.
+ */
+class DwarfReader
+{
+public:
+    DwarfReader(const DwarfSection &section, bool bigEndian)
+        : m_start(section.m_data), m_pos(section.m_data), m_end(section.m_data+section.m_size),
+        m_bigEndian(bigEndian), m_error(section.m_data == NULL) {};
+
+    bool atEnd() const { return m_error || m_pos >= m_end; };
+    bool hasError() const { return m_error; };
+    quint64 getOffset() const { return m_pos-m_start; };
+
+    void seek(quint64 offset)
+    {
+        if(offset > (quint64)(m_end-m_start))
+            m_error = true;
+        else
+            m_pos = m_start+offset;
+    };
+
+    void skip(quint64 len)
+    {
+        if(len > (quint64)(m_end-m_pos))
+            m_error = true;
+        else
+            m_pos += len;
+    };
+
+    quint64 readInt(int size)
+    {
+        if(size > m_end-m_pos)
+        {
+            m_error = true;
+            return 0;
+        }
+        quint64 val = 0;
+        for(int i = 0;i < size;i++)
+            val = (val << 8) | m_pos[m_bigEndian ? i : size-1-i];
+        m_pos += size;
+        return val;
+    };
+
+    quint8 readU8() { return readInt(1); };
+    quint16 readU16() { return readInt(2); };
+    quint32 readU32() { return readInt(4); };
+
+    quint64 readUleb()
+    {
+        quint64 val = 0;
+        int shift = 0;
+        while(m_pos < m_end)
+        {
+            quint8 b = *m_pos++;
+            if(shift < 64)
+                val |= (quint64)(b & 0x7f) << shift;
+            shift += 7;
+            if((b & 0x80) == 0)
+                return val;
+        }
+        m_error = true;
+        return 0;
+    };
+
+    qint64 readSleb()
+    {
+        qint64 val = 0;
+        int shift = 0;
+        while(m_pos < m_end)
+        {
+            quint8 b = *m_pos++;
+            if(shift < 64)
+                val |= (qint64)(b & 0x7f) << shift;
+            shift += 7;
+            if((b & 0x80) == 0)
+            {
+                if(shift < 64 && (b & 0x40))
+                    val |= -((qint64)1 << shift);
+                return val;
+            }
+        }
+        m_error = true;
+        return 0;
+    };
+
+    QByteArray readString()
+    {
+        const uchar *strEnd = (const uchar*)memchr(m_pos, '\0', m_end-m_pos);
+        if(strEnd == NULL)
+        {
+            m_error = true;
+            return QByteArray();
+        }
+        QByteArray str((const char*)m_pos, strEnd-m_pos);
+        m_pos = strEnd+1;
+        return str;
+    };
+
+    /**
+     * @brief Reads a unit length.
+     * @return The offset where the unit ends.
+     */
+    quint64 readUnitLength(bool *is64)
+    {
+        quint64 len = readU32();
+        *is64 = (len == 0xffffffff);
+        if(*is64)
+            len = readInt(8);
+        quint64 unitEnd = getOffset() + len;
+        if(len > (quint64)(m_end-m_pos))
+        {
+            m_error = true;
+            unitEnd = m_end-m_start;
+        }
+        return unitEnd;
+    };
+
+private:
+    const uchar *m_start;
+    const uchar *m_pos;
+    const uchar *m_end;
+    bool m_bigEndian;
+    bool m_error;
+};
+
+
+/**
+ * @brief What is needed to read an attribute value.
+ */
+class DwarfFormInfo
+{
+public:
+    int m_version;
+    int m_addrSize;
+    bool m_is64;
+    const DwarfSection *m_debugStr;
+    const DwarfSection *m_debugLineStr;
+};
+
+
+static QByteArray getSectionString(const DwarfSection &section, quint64 offset)
+{
+    if(section.m_data == NULL || offset >= section.m_size)
+        return QByteArray();
+    const char *str = (const char*)section.m_data + offset;
+    const char *strEnd = (const char*)memchr(str, '\0', section.m_size-offset);
+    if(strEnd == NULL)
+        return QByteArray();
+    return QByteArray(str, strEnd-str);
+}
+
+
+/**
+ * @brief Reads an attribute value.
+ * @param value   The value of constants, offsets and references.
+ * @param str     The value of strings (if the form is a string).
+ * @return false if the form is not known.
+ */
+static bool readForm(DwarfReader &r, int form, const DwarfFormInfo &info, quint64 *value, QByteArray *str)
+{
+    int offsetSize = info.m_is64 ? 8 : 4;
+    *value = 0;
+
+    // The form is given in the data (a nested indirect form is not allowed)
+    if(form == 0x16)
+    {
+        form = (int)r.readUleb();
+        if(form == 0x16)
+            return false;
+    }
+
+    switch(form)
+    {
+        case 0x01: *value = r.readInt(info.m_addrSize);break; // addr
+        case 0x03: r.skip(r.readU16());break; // block2
+        case 0x04: r.skip(r.readU32());break; // block4
+        case 0x05: *value = r.readU16();break; // data2
+        case 0x06: *value = r.readU32();break; // data4
+        case 0x07: *value = r.readInt(8);break; // data8
+        case 0x08: *str = r.readString();break; // string
+        case 0x09: r.skip(r.readUleb());break; // block
+        case 0x0a: r.skip(r.readU8());break; // block1
+        case 0x0b: *value = r.readU8();break; // data1
+        case 0x0c: *value = r.readU8();break; // flag
+        case 0x0d: *value = r.readSleb();break; // sdata
+        case 0x0e: *value = r.readInt(offsetSize);*str = getSectionString(*info.m_debugStr, *value);break; // strp
+        case 0x0f: *value = r.readUleb();break; // udata
+        case 0x10: *value = r.readInt(info.m_version <= 2 ? info.m_addrSize : offsetSize);break; // ref_addr
+        case 0x11: *value = r.readU8();break; // ref1
+        case 0x12: *value = r.readU16();break; // ref2
+        case 0x13: *value = r.readU32();break; // ref4
+        case 0x14: *value = r.readInt(8);break; // ref8
+        case 0x15: *value = r.readUleb();break; // ref_udata
+        case 0x17: *value = r.readInt(offsetSize);break; // sec_offset
+        case 0x18: r.skip(r.readUleb());break; // exprloc
+        case 0x19: *value = 1;break; // flag_present
+        case 0x1a: *value = r.readUleb();break; // strx
+        case 0x1b: *value = r.readUleb();break; // addrx
+        case 0x1c: *value = r.readU32();break; // ref_sup4
+        case 0x1d: *value = r.readInt(offsetSize);break; // strp_sup
+        case 0x1e: r.skip(16);break; // data16
+        case 0x1f: *value = r.readInt(offsetSize);*str = getSectionString(*info.m_debugLineStr, *value);break; // line_strp
+        case 0x20: *value = r.readInt(8);break; // ref_sig8
+        case DW_FORM_implicit_const: break; // The value is in the abbreviation
+        case 0x22: *value = r.readUleb();break; // loclistx
+        case 0x23: *value = r.readUleb();break; // rnglistx
+        case 0x24: *value = r.readInt(8);break; // ref_sup8
+        case 0x25: case 0x29: *value = r.readU8();break; // strx1, addrx1
+        case 0x26: case 0x2a: *value = r.readU16();break; // strx2, addrx2
+        case 0x27: case 0x2b: *value = r.readInt(3);break; // strx3, addrx3
+        case 0x28: case 0x2c: *value = r.readU32();break; // strx4, addrx4
+        default:
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Joins a directory and a path (unless the path is absolute).
+ */
+static QString joinPath(QString dirPath, QString path)
+{
+    if(dirPath.isEmpty() || path.startsWith("/"))
+        return path;
+    return dirPath + "/" + path;
+}
+
+
+
+DwarfLineWorker::DwarfLineWorker(const DwarfLineTable *table, QVector<DwarfLineUnit> *units, int first, int step)
+    : m_table(table)
+    ,m_units(units)
+    ,m_first(first)
+    ,m_step(step)
+{
+}
+
+
+void DwarfLineWorker::run()
+{
+    for(int i = m_first;i < m_units->size();i += m_step)
+        m_table->parseUnit(&(*m_units)[i]);
+}
+
+
+
+DwarfLineTable::DwarfLineTable()
+    : m_bigEndian(false)
+    ,m_isLoaded(false)
+{
+}
+
+
+DwarfLineTable::~DwarfLineTable()
+{
+}
+
+
+/**
+ * @brief Removes all files.
+ */
+void DwarfLineTable::clear()
+{
+    m_isLoaded = false;
+    m_files.clear();
+    m_fileLookup.clear();
+}
+
+
+/**
+ * @brief Maps a debug section (if the file has it).
+ * @return 0 on success or if the section is missing.
+ */
+int DwarfLineTable::mapSection(const QVector<ElfSection> &sections, const char *name, DwarfSection *section)
+{
+    *section = DwarfSection();
+    for(int secIdx = 0;secIdx < sections.size();secIdx++)
+    {
+        const ElfSection &sec = sections[secIdx];
+        if(sec.m_name != name)
+            continue;
+        if(sec.m_type == SHT_NOBITS || sec.m_size == 0)
+            return 0;
+        if(sec.m_flags & SHF_COMPRESSED)
+        {
+            debugMsg("Section %s is compressed", name);
+            return -1;
+        }
+        section->m_data = m_file.map(sec.m_offset, sec.m_size);
+        if(section->m_data == NULL)
+            return -1;
+        section->m_size = sec.m_size;
+        return 0;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Reads the line tables of an executable.
+ * @return 0 on success.
+ */
+int DwarfLineTable::load(QString filename)
+{
+    TraceScope traceScope("startup", "Read line tables");
+    QElapsedTimer timer;
+    timer.start();
+
+    clear();
+
+    m_file.setFileName(filename);
+    if(!m_file.open(QIODevice::ReadOnly))
+        return -1;
+
+    QVector<ElfSection> sections;
+    if(readElfSections(m_file, &sections, &m_bigEndian)
+        || mapSection(sections, ".debug_line", &m_debugLine)
+        || mapSection(sections, ".debug_line_str", &m_debugLineStr)
+        || mapSection(sections, ".debug_str", &m_debugStr)
+        || mapSection(sections, ".debug_info", &m_debugInfo)
+        || mapSection(sections, ".debug_abbrev", &m_debugAbbrev)
+        || m_debugLine.m_data == NULL)
+    {
+        debugMsg("No line tables found in '%s'", stringToCStr(filename));
+        m_file.close();
+        return -1;
+    }
+
+    // Find the line number programs and their compilation directories
+    QVector<DwarfLineUnit> units;
+    findUnits(&units);
+    QHash<quint64, QString> compDirs;
+    findCompDirs(&compDirs);
+    for(int i = 0;i < units.size();i++)
+        units[i].m_compDir = compDirs.value(units[i].m_offset);
+
+    // Parse them
+    int threadCount = std::min(QThread::idealThreadCount(), (int)units.size()/DWARF_UNITS_PER_THREAD);
+    if(threadCount <= 1)
+    {
+        for(int i = 0;i < units.size();i++)
+            parseUnit(&units[i]);
+    }
+    else
+    {
+        QList<DwarfLineWorker*> workers;
+        for(int t = 0;t < threadCount;t++)
+        {
+            DwarfLineWorker *worker = new DwarfLineWorker(this, &units, t, threadCount);
+            workers.append(worker);
+            worker->start();
+        }
+        for(int t = 0;t < workers.size();t++)
+        {
+            workers[t]->wait();
+            delete workers[t];
+        }
+    }
+
+    // The strings have been copied so the sections are not needed anymore
+    m_file.close();
+    m_debugLine = m_debugLineStr = m_debugStr = m_debugInfo = m_debugAbbrev = DwarfSection();
+
+    // Merge the files of all units
+    for(int i = 0;i < units.size();i++)
+    {
+        const DwarfLineUnit &unit = units[i];
+        QVector<int> fileIdxs;
+        for(int j = 0;j < unit.m_filePaths.size();j++)
+        {
+            QString filePath = unit.m_filePaths[j];
+            QHash<QString, int>::const_iterator it = m_fileLookup.constFind(filePath);
+            if(it != m_fileLookup.constEnd())
+                fileIdxs.append(it.value());
+            else
+            {
+                File file;
+                file.m_name = unit.m_fileNames[j];
+                file.m_path = filePath;
+                fileIdxs.append(m_files.size());
+                m_fileLookup.insert(filePath, m_files.size());
+                m_files.append(file);
+            }
+        }
+        for(int j = 0;j < unit.m_lines.size();j++)
+        {
+            quint64 line = unit.m_lines[j];
+            m_files[fileIdxs[line >> 32]].m_lines.append((int)(line & 0xffffffff));
+        }
+    }
+    for(int i = 0;i < m_files.size();i++)
+    {
+        QVector<int> &lines = m_files[i].m_lines;
+        std::sort(lines.begin(), lines.end());
+        lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+    }
+
+    m_isLoaded = true;
+    debugMsg("Read %d source files from %d line tables in %lld ms", m_files.size(), units.size(), (long long)timer.elapsed());
+    return 0;
+}
+
+
+/**
+ * @brief Finds the line number programs in .debug_line.
+ */
+void DwarfLineTable::findUnits(QVector<DwarfLineUnit> *units) const
+{
+    DwarfReader r(m_debugLine, m_bigEndian);
+    while(!r.atEnd())
+    {
+        DwarfLineUnit unit;
+        unit.m_offset = r.getOffset();
+        bool is64;
+        quint64 unitEnd = r.readUnitLength(&is64);
+        if(r.hasError())
+            break;
+        units->append(unit);
+        r.seek(unitEnd);
+    }
+}
+
+
+/**
+ * @brief Finds the compilation directory of each line number program.
+ *
+ * Before DWARF 5, the line number program does not include the
+ * compilation directory so it is read from the first entry of each unit
+ * in .debug_info.
+ * @param compDirs  Offset of the program in .debug_line => directory.
+ */
+void DwarfLineTable::findCompDirs(QHash<quint64, QString> *compDirs) const
+{
+    DwarfReader r(m_debugInfo, m_bigEndian);
+    while(!r.atEnd())
+    {
+        bool is64;
+        quint64 unitEnd = r.readUnitLength(&is64);
+        if(r.hasError())
+            break;
+
+        DwarfFormInfo info;
+        info.m_version = r.readU16();
+        info.m_is64 = is64;
+        info.m_debugStr = &m_debugStr;
+        info.m_debugLineStr = &m_debugLineStr;
+        quint64 abbrevOffset;
+        int unitType = DW_UT_compile;
+        if(info.m_version >= 5)
+        {
+            unitType = r.readU8();
+            info.m_addrSize = r.readU8();
+            abbrevOffset = r.readInt(is64 ? 8 : 4);
+            if(unitType == DW_UT_skeleton || unitType == DW_UT_split_compile)
+                r.skip(8);
+        }
+        else
+        {
+            abbrevOffset = r.readInt(is64 ? 8 : 4);
+            info.m_addrSize = r.readU8();
+        }
+        if(unitType != DW_UT_compile && unitType != DW_UT_partial && unitType != DW_UT_skeleton)
+        {
+            r.seek(unitEnd);
+            continue;
+        }
+
+        // Find the abbreviation of the unit entry
+        quint64 code = r.readUleb();
+        DwarfReader a(m_debugAbbrev, m_bigEndian);
+        a.seek(abbrevOffset);
+        bool found = false;
+        while(!a.atEnd() && !found)
+        {
+            quint64 abbrevCode = a.readUleb();
+            if(abbrevCode == 0)
+                break;
+            a.readUleb(); // Tag
+            a.readU8(); // Has children
+            if(abbrevCode == code)
+                found = true;
+            else
+            {
+                quint64 name, form;
+                do
+                {
+                    name = a.readUleb();
+                    form = a.readUleb();
+                    if(form == DW_FORM_implicit_const)
+                        a.readSleb();
+                } while((name != 0 || form != 0) && !a.hasError());
+            }
+        }
+
+        // Read the attributes
+        quint64 stmtList = 0;
+        bool hasStmtList = false;
+        QByteArray compDir;
+        while(found && !a.hasError() && !r.hasError())
+        {
+            quint64 name = a.readUleb();
+            quint64 form = a.readUleb();
+            if(name == 0 && form == 0)
+                break;
+            if(form == DW_FORM_implicit_const)
+                a.readSleb();
+
+            quint64 value;
+            QByteArray str;
+            if(!readForm(r, form, info, &value, &str))
+                break;
+            if(name == DW_AT_stmt_list)
+            {
+                stmtList = value;
+                hasStmtList = true;
+            }
+            else if(name == DW_AT_comp_dir)
+                compDir = str;
+        }
+        if(hasStmtList && !compDir.isEmpty())
+            compDirs->insert(stmtList, QFile::decodeName(compDir));
+
+        r.seek(unitEnd);
+    }
+}
+
+
+/**
+ * @brief Parses the header and the program of a line number program.
+ *
+ * Only the file and line registers of the state machine are followed.
+ * Called from several threads at the same time.
+ */
+void DwarfLineTable::parseUnit(DwarfLineUnit *unit) const
+{
+    DwarfReader r(m_debugLine, m_bigEndian);
+    r.seek(unit->m_offset);
+    bool is64;
+    quint64 unitEnd = r.readUnitLength(&is64);
+
+    DwarfFormInfo info;
+    info.m_version = r.readU16();
+    info.m_addrSize = 8;
+    info.m_is64 = is64;
+    info.m_debugStr = &m_debugStr;
+    info.m_debugLineStr = &m_debugLineStr;
+    if(info.m_version < 2 || info.m_version > 5)
+        return;
+    if(info.m_version >= 5)
+    {
+        info.m_addrSize = r.readU8();
+        r.readU8(); // Segment selector size
+    }
+    quint64 headerLength = r.readInt(is64 ? 8 : 4);
+    quint64 programStart = r.getOffset() + headerLength;
+    r.readU8(); // Minimum instruction length
+    if(info.m_version >= 4)
+        r.readU8(); // Maximum operations per instruction
+    bool defaultIsStmt = r.readU8() != 0;
+    int lineBase = (qint8)r.readU8();
+    int lineRange = r.readU8();
+    int opcodeBase = r.readU8();
+    QVector<quint8> opcodeLengths(opcodeBase > 0 ? opcodeBase : 1);
+    for(int i = 1;i < opcodeBase;i++)
+        opcodeLengths[i] = r.readU8();
+    if(lineRange == 0 || r.hasError())
+        return;
+
+    // Directories and files
+    QStringList dirs;
+    QStringList fileNames;
+    QVector<int> fileDirs;
+    if(info.m_version < 5)
+    {
+        dirs.append(unit->m_compDir);
+        for(;;)
+        {
+            QByteArray dir = r.readString();
+            if(dir.isEmpty() || r.hasError())
+                break;
+            dirs.append(QFile::decodeName(dir));
+        }
+        for(;;)
+        {
+            QByteArray name = r.readString();
+            if(name.isEmpty() || r.hasError())
+                break;
+            fileNames.append(QFile::decodeName(name));
+            fileDirs.append(r.readUleb());
+            r.readUleb(); // Modification time
+            r.readUleb(); // Length
+        }
+    }
+    else
+    {
+        for(int pass = 0;pass < 2 && !r.hasError();pass++)
+        {
+            QVector<quint64> contentTypes;
+            QVector<quint64> forms;
+            int formatCount = r.readU8();
+            for(int i = 0;i < formatCount;i++)
+            {
+                contentTypes.append(r.readUleb());
+                forms.append(r.readUleb());
+            }
+            quint64 count = r.readUleb();
+            for(quint64 i = 0;i < count && !r.hasError();i++)
+            {
+                QString path;
+                int dirIdx = 0;
+                for(int j = 0;j < formatCount;j++)
+                {
+                    quint64 value;
+                    QByteArray str;
+                    if(!readForm(r, forms[j], info, &value, &str))
+                        return;
+                    if(contentTypes[j] == DW_LNCT_path)
+                        path = QFile::decodeName(str);
+                    else if(contentTypes[j] == DW_LNCT_directory_index)
+                        dirIdx = value;
+                }
+                if(pass == 0)
+                    dirs.append(path);
+                else
+                {
+                    fileNames.append(path);
+                    fileDirs.append(dirIdx);
+                }
+            }
+        }
+    }
+    if(r.hasError())
+        return;
+
+    // The file numbers start at 1 before DWARF 5
+    int fileBase = info.m_version < 5 ? 1 : 0;
+
+    // Run the line number program
+    r.seek(programStart);
+    quint64 file = 1;
+    qint64 line = 1;
+    bool isStmt = defaultIsStmt;
+    while(r.getOffset() < unitEnd && !r.hasError())
+    {
+        int opcode = r.readU8();
+        bool isRow = false;
+        if(opcode >= opcodeBase)
+        {
+            line += lineBase + (opcode-opcodeBase) % lineRange;
+            isRow = true;
+        }
+        else if(opcode == 0)
+        {
+            quint64 len = r.readUleb();
+            quint64 subEnd = r.getOffset() + len;
+            int subOpcode = r.readU8();
+            if(subOpcode == DW_LNE_end_sequence)
+            {
+                file = 1;
+                line = 1;
+                isStmt = defaultIsStmt;
+            }
+            else if(subOpcode == DW_LNE_define_file)
+            {
+                fileNames.append(QFile::decodeName(r.readString()));
+                fileDirs.append(r.readUleb());
+            }
+            r.seek(subEnd);
+        }
+        else
+        {
+            switch(opcode)
+            {
+                case DW_LNS_copy: isRow = true;break;
+                case DW_LNS_advance_pc: r.readUleb();break;
+                case DW_LNS_advance_line: line += r.readSleb();break;
+                case DW_LNS_set_file: file = r.readUleb();break;
+                case DW_LNS_set_column: r.readUleb();break;
+                case DW_LNS_negate_stmt: isStmt = !isStmt;break;
+                case DW_LNS_fixed_advance_pc: r.readU16();break;
+                case DW_LNS_set_isa: r.readUleb();break;
+                default:
+                {
+                    for(int i = 0;i < opcodeLengths[opcode];i++)
+                        r.readUleb();
+                };break;
+            }
+        }
+
+        if(isRow && isStmt && line > 0 && line <= 0x7fffffff)
+        {
+            quint64 fileIdx = file - fileBase;
+            if(file >= (quint64)fileBase && fileIdx < (quint64)fileNames.size())
+                unit->m_lines.append((fileIdx << 32) | (quint64)line);
+        }
+    }
+    std::sort(unit->m_lines.begin(), unit->m_lines.end());
+    unit->m_lines.erase(std::unique(unit->m_lines.begin(), unit->m_lines.end()), unit->m_lines.end());
+
+    // Get the full path of the files
+    QString compDir = dirs.isEmpty() ? QString() : dirs[0];
+    for(int i = 0;i < fileNames.size();i++)
+    {
+        int dirIdx = fileDirs[i];
+        QString dir = (dirIdx >= 0 && dirIdx < dirs.size()) ? dirs[dirIdx] : QString();
+        QString name = fileNames[i];
+        if(dirIdx != 0)
+            name = joinPath(dir, name);
+        unit->m_fileNames.append(name);
+        unit->m_filePaths.append(QDir::cleanPath(joinPath(compDir, name)));
+    }
+}
+
+
+int DwarfLineTable::findFile(QString filePath) const
+{
+    QHash<QString, int>::const_iterator it = m_fileLookup.constFind(filePath);
+    if(it == m_fileLookup.constEnd())
+        it = m_fileLookup.constFind(QDir::cleanPath(filePath));
+    if(it == m_fileLookup.constEnd())
+        return -1;
+    return it.value();
+}
+
+
+/**
+ * @brief Checks if a source file is used by the program.
+ */
+bool DwarfLineTable::hasFile(QString filePath) const
+{
+    return findFile(filePath) != -1;
+}
+
+
+/**
+ * @brief Returns the lines (1=first) in a source file that have code.
+ */
+QVector<int> DwarfLineTable::getCodeLines(QString filePath) const
+{
+    int fileIdx = findFile(filePath);
+    if(fileIdx == -1)
+        return QVector<int>();
+    return m_files[fileIdx].m_lines;
+}
+
+
+/**
+ * @brief Returns the first line at or after a line that has code.
+ * @return The line or -1 if the file is unknown or has no code after the line.
+ */
+int DwarfLineTable::findCodeLine(QString filePath, int lineNo) const
+{
+    int fileIdx = findFile(filePath);
+    if(fileIdx == -1)
+        return -1;
+    const QVector<int> &lines = m_files[fileIdx].m_lines;
+    QVector<int>::const_iterator it = std::lower_bound(lines.constBegin(), lines.constEnd(), lineNo);
+    if(it == lines.constEnd())
+        return -1;
+    return *it;
+}
+
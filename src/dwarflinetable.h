@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__DWARFLINETABLE_H
+#define FILE__DWARFLINETABLE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QThread>
+
+#include "util.h"
+
+
+/**
+ * @brief A memory mapped debug section.
+ */
+class DwarfSection
+{
+public:
+    DwarfSection() : m_data(NULL), m_size(0) {};
+
+    const uchar *m_data;
+    quint64 m_size;
+};
+
+
+/**
+ * @brief The source files and lines of one line number program in .debug_line.
+ */
+class DwarfLineUnit
+{
+public:
+    DwarfLineUnit() : m_offset(0) {};
+
+    quint64 m_offset; //!< Offset of the program in .debug_line.
+    QString m_compDir; //!< Directory of the compilation unit (only needed before DWARF 5).
+    QStringList m_fileNames; //!< The names as written in the program.
+    QStringList m_filePaths; //!< The absolute paths of the files.
+    QVector<quint64> m_lines; //!< (fileIdx << 32 | lineNo) for each line that starts a statement.
+};
+
+
+class DwarfLineTable;
+
+/**
+ * @brief Parses a share of the line number programs.
+ */
+class DwarfLineWorker : public QThread
+{
+public:
+    DwarfLineWorker(const DwarfLineTable *table, QVector<DwarfLineUnit> *units, int first, int step);
+
+    void run();
+
+private:
+    const DwarfLineTable *m_table;
+    QVector<DwarfLineUnit> *m_units;
+    int m_first;
+    int m_step;
+};
+
+
+/**
+ * @brief Reads the source files and the lines with code from the .debug_line section of an executable.
+ *
+ * The debug sections are memory mapped and each line number program is
+ * parsed on its own, in several threads. This gives the source file list
+ * and the lines where a breakpoint can be set without asking GDB.
+ *
+ * Only the program itself is covered, not the shared libraries, and
+ * compressed debug sections or separate debug files are not supported (load()
+ * then fails).
+ */
+class DwarfLineTable
+{
+public:
+    DwarfLineTable();
+    virtual ~DwarfLineTable();
+
+    int load(QString filename);
+    void clear();
+
+    bool isLoaded() const { return m_isLoaded; };
+
+    int getFileCount() const { return m_files.size(); };
+    QString getFileName(int fileIdx) const { return m_files[fileIdx].m_name; };
+    QString getFilePath(int fileIdx) const { return m_files[fileIdx].m_path; };
+
+    bool hasFile(QString filePath) const;
+    QVector<int> getCodeLines(QString filePath) const;
+    int findCodeLine(QString filePath, int lineNo) const;
+
+private:
+    friend class DwarfLineWorker;
+
+    class File
+    {
+    public:
+        QString m_name;
+        QString m_path;
+        QVector<int> m_lines; //!< Sorted lines with code.
+    };
+
+    int mapSection(const QVector<ElfSection> &sections, const char *name, DwarfSection *section);
+    void findUnits(QVector<DwarfLineUnit> *units) const;
+    void findCompDirs(QHash<quint64, QString> *compDirs) const;
+    void parseUnit(DwarfLineUnit *unit) const;
+    int findFile(QString filePath) const;
+
+private:
+    QFile m_file;
+    bool m_bigEndian;
+    DwarfSection m_debugLine;
+    DwarfSection m_debugLineStr;
+    DwarfSection m_debugStr;
+    DwarfSection m_debugInfo;
+    DwarfSection m_debugAbbrev;
+
+    bool m_isLoaded;
+    QVector<File> m_files;
+    QHash<QString, int> m_fileLookup; //!< Path => index in m_files.
+};
+
+#endif // FILE__DWARFLINETABLE_H
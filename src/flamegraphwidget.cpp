@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "flamegraphwidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QToolTip>
+
+#include <algorithm>
+
+
+FlameGraphWidget::FlameGraphWidget(QWidget *parent)
+    : QWidget(parent)
+    ,m_profile(NULL)
+    ,m_zoomNodeIdx(0)
+{
+    setMouseTracking(true);
+}
+
+
+FlameGraphWidget::~FlameGraphWidget()
+{
+}
+
+
+void FlameGraphWidget::setProfile(const SampleProfile *profile)
+{
+    m_profile = profile;
+    m_zoomNodeIdx = 0;
+    updateProfile();
+}
+
+
+int FlameGraphWidget::getRowHeight() const
+{
+    return fontMetrics().height() + 4;
+}
+
+
+/**
+ * @brief Must be called when samples have been added to the profile.
+ */
+void FlameGraphWidget::updateProfile()
+{
+    if(!m_profile)
+        return;
+
+    // The profile was cleared?
+    if(m_zoomNodeIdx >= m_profile->getNodeCount())
+        m_zoomNodeIdx = 0;
+
+    // Parents are always added before their children
+    QVector<int> depths(m_profile->getNodeCount(), 0);
+    int maxDepth = 0;
+    for(int nodeIdx = 1;nodeIdx < depths.size();nodeIdx++)
+    {
+        depths[nodeIdx] = depths[m_profile->getNode(nodeIdx).m_parentIdx] + 1;
+        maxDepth = std::max(maxDepth, depths[nodeIdx]);
+    }
+    setMinimumHeight((maxDepth+1)*getRowHeight());
+
+    update();
+}
+
+
+QString FlameGraphWidget::getNodeName(int nodeIdx) const
+{
+    const SampleProfile::Node &node = m_profile->getNode(nodeIdx);
+    if(node.m_funcIdx == -1)
+        return "all";
+    const SampleProfile::Function &func = m_profile->getFunction(node.m_funcIdx);
+    QString name = m_profile->getString(func.m_nameIdx);
+    if(name.isEmpty())
+        name = "??";
+    return name;
+}
+
+
+void FlameGraphWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().color(QPalette::Base));
+
+    m_nodeRects.clear();
+    if(!m_profile || m_profile->getStackCount() == 0)
+    {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect(), Qt::AlignCenter, "No samples");
+        return;
+    }
+
+    paintNode(painter, event->rect(), m_zoomNodeIdx, 0, width(), 0);
+}
+
+
+void FlameGraphWidget::paintNode(QPainter &painter, const QRect &clipRect, int nodeIdx, double x, double width, int depth)
+{
+    const SampleProfile::Node &node = m_profile->getNode(nodeIdx);
+    int rowHeight = getRowHeight();
+
+    QRect rect((int)x, depth*rowHeight, std::max(1, (int)(x+width) - (int)x - 1), rowHeight-1);
+    if(rect.top() > clipRect.bottom())
+        return;
+
+    NodeRect nodeRect;
+    nodeRect.m_rect = rect;
+    nodeRect.m_nodeIdx = nodeIdx;
+    m_nodeRects.append(nodeRect);
+
+    if(rect.intersects(clipRect))
+    {
+        // Warm colors that are the same for a function each time
+        QString name = getNodeName(nodeIdx);
+        uint hash = qHash(name);
+        QColor color = QColor::fromHsv(hash % 50, 140 + (hash / 50) % 80, 240);
+        painter.fillRect(rect, color);
+
+        if(rect.width() > 20)
+        {
+            painter.setPen(Qt::black);
+            QRect textRect = rect.adjusted(3, 0, -3, 0);
+            QString text = painter.fontMetrics().elidedText(name, Qt::ElideRight, textRect.width());
+            painter.drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, text);
+        }
+    }
+
+    // Draw the callees below
+    double childX = x;
+    for(int i = 0;i < node.m_children.size();i++)
+    {
+        int childIdx = node.m_children[i];
+        double childWidth = (width * m_profile->getNode(childIdx).m_count) / node.m_count;
+        if(childWidth >= 1.0)
+            paintNode(painter, clipRect, childIdx, childX, childWidth, depth+1);
+        childX += childWidth;
+    }
+}
+
+
+/**
+ * @brief Returns the node drawn at a position or -1 if none.
+ */
+int FlameGraphWidget::findNodeAt(QPoint pos) const
+{
+    for(int i = 0;i < m_nodeRects.size();i++)
+    {
+        if(m_nodeRects[i].m_rect.contains(pos))
+            return m_nodeRects[i].m_nodeIdx;
+    }
+    return -1;
+}
+
+
+void FlameGraphWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    int nodeIdx = findNodeAt(event->pos());
+    if(nodeIdx == -1 || !m_profile)
+    {
+        QToolTip::hideText();
+        return;
+    }
+
+    const SampleProfile::Node &node = m_profile->getNode(nodeIdx);
+    QString text = getNodeName(nodeIdx);
+    if(node.m_funcIdx != -1)
+    {
+        const SampleProfile::Function &func = m_profile->getFunction(node.m_funcIdx);
+        QString path = m_profile->getString(func.m_pathIdx);
+        if(!path.isEmpty())
+            text += QString("\n%1").arg(path);
+    }
+    double percent = (100.0 * node.m_count) / std::max(1, m_profile->getStackCount());
+    text += QString("\n%1 samples (%2%)").arg(node.m_count).arg(percent, 0, 'f', 1);
+
+    QToolTip::showText(event->globalPos(), text, this);
+}
+
+
+void FlameGraphWidget::mousePressEvent(QMouseEvent *event)
+{
+    int nodeIdx = findNodeAt(event->pos());
+    if(nodeIdx == -1 || event->button() != Qt::LeftButton)
+        return;
+
+    const SampleProfile::Node &node = m_profile->getNode(nodeIdx);
+    if(node.m_funcIdx == -1)
+        return;
+    const SampleProfile::Function &func = m_profile->getFunction(node.m_funcIdx);
+    QString path = m_profile->getString(func.m_pathIdx);
+    if(!path.isEmpty())
+        emit functionClicked(path, func.m_lineNo);
+}
+
+
+void FlameGraphWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    int nodeIdx = findNodeAt(event->pos());
+    if(nodeIdx == -1)
+        return;
+
+    // Zoom out again if the zoomed in function is double clicked
+    if(nodeIdx == m_zoomNodeIdx)
+        m_zoomNodeIdx = m_profile->getNode(nodeIdx).m_parentIdx == -1 ? 0 : m_profile->getNode(nodeIdx).m_parentIdx;
+    else
+        m_zoomNodeIdx = nodeIdx;
+    update();
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__FLAMEGRAPHWIDGET_H
+#define FILE__FLAMEGRAPHWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QRect>
+
+#include "profiler.h"
+
+
+/**
+ * @brief Shows the backtraces of a SampleProfile as a flame graph.
+ *
+ * The graph is drawn with the outermost frame on top. The width of a
+ * function is proportional to the number of backtraces it was part of.
+ * Click on a function to show its source and double click to zoom in.
+ */
+class FlameGraphWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    FlameGraphWidget(QWidget *parent = NULL);
+    virtual ~FlameGraphWidget();
+
+    void setProfile(const SampleProfile *profile);
+    void updateProfile();
+
+signals:
+    void functionClicked(QString path, int lineNo);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+
+private:
+    void paintNode(QPainter &painter, const QRect &clipRect, int nodeIdx, double x, double width, int depth);
+    int findNodeAt(QPoint pos) const;
+    QString getNodeName(int nodeIdx) const;
+    int getRowHeight() const;
+
+private:
+    class NodeRect
+    {
+    public:
+        QRect m_rect;
+        int m_nodeIdx;
+    };
+
+    const SampleProfile *m_profile;
+    int m_zoomNodeIdx; //!< The node drawn with the full width.
+    QVector<NodeRect> m_nodeRects; //!< The nodes drawn in the last paint.
+};
+
+#endif // FILE__FLAMEGRAPHWIDGET_H
@@ -24,6 +24,7 @@
 #include "opendialog.h"
 #include "settings.h"
 #include "version.h"
+#include "tracelog.h"
 
 
 
@@ -42,6 +43,9 @@ static int dumpUsage()
     printf("  --version                          Displays the version of gede.\n");
     printf("  --projconfig FILENAME              Specify config filename to use.\n");
     printf("                                     Default is '%s' \n", PROJECT_CONFIG_FILENAME);
+    printf("  --trace-startup FILENAME           Writes the time spent in each startup phase to a\n");
+    printf("                                     Chrome trace event file.\n");
+    printf("  --log-file FILENAME                Writes all log messages to a file.\n");
     printf("\n");
     printf("Examples:\n");
     printf("\n");
@@ -111,15 +115,31 @@ int main(int argc, char *argv[])
             customProjectConfig = argv[i];
             cfg.setProjectConfig(customProjectConfig);
         }
+        else if(strcmp(curArg, "--trace-startup") == 0 && i+1 < argc)
+        {
+            i++;
+            TraceLog::getInstance().start(argv[i]);
+        }
+        else if(strcmp(curArg, "--log-file") == 0 && i+1 < argc)
+        {
+            i++;
+            if(loggerOpenFile(argv[i]))
+                errorMsg("Failed to create '%s'", argv[i]);
+        }
         
     }
     
     // Load default config
+    TraceLog &trace = TraceLog::getInstance();
+    qint64 traceStart = trace.getTimestamp();
     cfg.load();
+    trace.addComplete("startup", "Load config", traceStart);
     for(int i = 1;i < argc;i++)
     {
         const char *curArg = argv[i];
-        if((strcmp(curArg, "--projconfig") == 0 || strcmp(curArg, "--proj-config") == 0)
+        if((strcmp(curArg, "--projconfig") == 0 || strcmp(curArg, "--proj-config") == 0
+                || strcmp(curArg, "--trace-startup") == 0
+                || strcmp(curArg, "--log-file") == 0)
             && i+1 < argc)
         {
             i++;
@@ -153,7 +173,9 @@ int main(int argc, char *argv[])
     }
     cfg.save();
     
+    traceStart = trace.getTimestamp();
     QApplication app(argc, argv);
+    trace.addComplete("startup", "Init QApplication", traceStart);
 
     if(!cfg.m_guiStyleName.isEmpty())
     {
@@ -174,7 +196,11 @@ int main(int argc, char *argv[])
 
         dlg.loadConfig(cfg);
 
-        if(dlg.exec() != QDialog::Accepted)
+        // Includes the time waiting for the user
+        traceStart = trace.getTimestamp();
+        int dlgResult = dlg.exec();
+        trace.addComplete("startup", "Open dialog", traceStart);
+        if(dlgResult != QDialog::Accepted)
             return 1;
 
         dlg.saveConfig(&cfg);
@@ -199,8 +225,11 @@ int main(int argc, char *argv[])
     Core &core = Core::getInstance();
 
     
+    traceStart = trace.getTimestamp();
     MainWindow w(NULL);
+    trace.addComplete("startup", "Create main window", traceStart);
 
+    traceStart = trace.getTimestamp();
     if(cfg.m_connectionMode == MODE_LOCAL)
         rc = core.initLocal(&cfg, cfg.m_gdbPath, cfg.getProgramPath(), cfg.m_argumentList);
     else if(cfg.m_connectionMode == MODE_SERIAL)
@@ -211,26 +240,45 @@ int main(int argc, char *argv[])
         rc = core.initPid(&cfg, cfg.m_gdbPath, cfg.getProgramPath(), cfg.m_runningPid);
     else
         rc = core.initRemote(&cfg, cfg.m_gdbPath, cfg.getProgramPath(), cfg.m_tcpHost, cfg.m_tcpPort);
+    trace.addComplete("startup", "Init core", traceStart);
 
     if(rc)
+    {
+        trace.save();
         return rc;
+    }
 
     // Set the status line
     w.setStatusLine(cfg);
 
+    traceStart = trace.getTimestamp();
     w.insertSourceFiles();
+    trace.addComplete("startup", "Insert source files", traceStart);
 
     if(cfg.m_reloadBreakpoints)
+    {
+        traceStart = trace.getTimestamp();
         loadBreakpoints(cfg, core);
+        trace.addComplete("startup", "Load breakpoints", traceStart);
+    }
 
 
     if(rc == 0 && (cfg.m_connectionMode == MODE_LOCAL ||
                    cfg.m_connectionMode == MODE_TCP ||
                    cfg.m_connectionMode == MODE_SERIAL))
+    {
+        traceStart = trace.getTimestamp();
         core.gdbRun();
+        trace.addComplete("startup", "Run", traceStart);
+    }
 
     w.show();
 
-    return app.exec();
+    rc = app.exec();
+
+    // Startup never finished (eg: no tag scan)?
+    trace.save();
+
+    return rc;
 }
 
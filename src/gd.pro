@@ -33,8 +33,8 @@ HEADERS+=log.h
 SOURCES+=qtutil.cpp util.cpp detectdistro.cpp
 HEADERS+=qtutil.h util.h detectdistro.h
 
-SOURCES+=tree.cpp
-HEADERS+=tree.h
+SOURCES+=tree.cpp mirecords.cpp
+HEADERS+=tree.h mirecords.h
 
 SOURCES+=aboutdialog.cpp
 HEADERS+=aboutdialog.h
@@ -69,8 +69,8 @@ HEADERS+=rusttagscanner.h
 
 HEADERS+=config.h
 
-SOURCES+=varctl.cpp watchvarctl.cpp autovarctl.cpp
-HEADERS+=varctl.h watchvarctl.h autovarctl.h
+SOURCES+=varctl.cpp watchvarctl.cpp autovarctl.cpp varwatchmodel.cpp
+HEADERS+=varctl.h watchvarctl.h autovarctl.h varwatchmodel.h
 
 SOURCES+=consolewidget.cpp
 HEADERS+=consolewidget.h
@@ -117,6 +117,27 @@ FORMS+=gotodialog.ui
 SOURCES+=locator.cpp
 HEADERS+=locator.h
 
+SOURCES+=threadlistmodel.cpp
+HEADERS+=threadlistmodel.h
+SOURCES+=stackgroups.cpp
+HEADERS+=stackgroups.h
+SOURCES+=tracelog.cpp
+HEADERS+=tracelog.h
+SOURCES+=gdblogwriter.cpp
+HEADERS+=gdblogwriter.h
+SOURCES+=profiler.cpp
+HEADERS+=profiler.h
+SOURCES+=flamegraphwidget.cpp
+HEADERS+=flamegraphwidget.h
+SOURCES+=symbolindex.cpp
+HEADERS+=symbolindex.h
+SOURCES+=tagbrowser.cpp
+HEADERS+=tagbrowser.h
+SOURCES+=sourcewatcher.cpp
+HEADERS+=sourcewatcher.h
+SOURCES+=dwarflinetable.cpp
+HEADERS+=dwarflinetable.h
+
 RESOURCES += resource.qrc
 
 #QMAKE_CXXFLAGS += -I./  -g
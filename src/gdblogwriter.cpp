@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "gdblogwriter.h"
+
+#include <QProcess>
+#include <QStringList>
+#include <time.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "util.h"
+
+
+static GdbLogWriter *g_crashLogWriter = NULL;
+
+
+static void onFatalSignal(int signo)
+{
+    if(g_crashLogWriter)
+        g_crashLogWriter->writeTail();
+
+    // The handler was reset so this gives the default action (core dump)
+    raise(signo);
+}
+
+
+/**
+ * @brief Installs onFatalSignal() for the signals that kill the process (unless they are already handled).
+ */
+static void installFatalSignalHandlers()
+{
+    static const int signalList[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+    for(int i = 0;i < (int)(sizeof(signalList)/sizeof(signalList[0]));i++)
+    {
+        struct sigaction oldAction;
+        if(sigaction(signalList[i], NULL, &oldAction) != 0 || oldAction.sa_handler != SIG_DFL)
+            continue;
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = onFatalSignal;
+        action.sa_flags = SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        sigaction(signalList[i], &action, NULL);
+    }
+}
+
+
+GdbLogWriter::GdbLogWriter()
+    : m_fileSize(0)
+    ,m_head(0)
+    ,m_tail(0)
+    ,m_droppedCount(0)
+    ,m_droppedWarned(false)
+    ,m_quit(0)
+    ,m_sleeping(0)
+{
+}
+
+
+GdbLogWriter::~GdbLogWriter()
+{
+    close();
+    if(g_crashLogWriter == this)
+        g_crashLogWriter = NULL;
+}
+
+
+/**
+ * @brief Creates the log file and starts the writer thread.
+ * @return 0 on success.
+ */
+int GdbLogWriter::open(QString filename)
+{
+    close();
+
+    m_filename = filename;
+    m_file.setFileName(filename);
+    if(!m_file.open(QIODevice::Truncate | QIODevice::WriteOnly | QIODevice::Unbuffered))
+        return 1;
+    m_fileSize = 0;
+
+    m_head = 0;
+    m_tail = 0;
+    m_droppedCount = 0;
+    m_droppedWarned = false;
+    m_quit = 0;
+    m_sleeping = 0;
+    start(QThread::LowPriority);
+
+    g_crashLogWriter = this;
+    installFatalSignalHandlers();
+    return 0;
+}
+
+
+/**
+ * @brief Writes all queued entries and closes the log file.
+ */
+void GdbLogWriter::close()
+{
+    if(!isRunning())
+        return;
+
+    __atomic_store_n(&m_quit, 1, __ATOMIC_SEQ_CST);
+    wakeWriter();
+    wait();
+}
+
+
+/**
+ * @brief Wakes up the writer thread if it sleeps.
+ *
+ * The semaphore (and its mutex) is only touched if the writer thread
+ * was about to sleep, not for each entry.
+ */
+void GdbLogWriter::wakeWriter()
+{
+    if(__atomic_load_n(&m_sleeping, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&m_sleeping, 0, __ATOMIC_SEQ_CST))
+        m_wakeup.release();
+}
+
+
+/**
+ * @brief Queues a log entry (called from the thread talking to GDB).
+ */
+void GdbLogWriter::write(QString text)
+{
+    unsigned int head = m_head;
+    unsigned int tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+
+    // Full?
+    if(head - tail >= GDB_LOG_RING_SIZE)
+    {
+        __atomic_fetch_add(&m_droppedCount, 1, __ATOMIC_SEQ_CST);
+        wakeWriter();
+        return;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    GdbLogEntry &entry = m_ring[head % GDB_LOG_RING_SIZE];
+    entry.m_timestampNs = (qint64)ts.tv_sec*1000000000LL + ts.tv_nsec;
+    entry.m_text = text;
+
+    __atomic_store_n(&m_head, head+1, __ATOMIC_SEQ_CST);
+
+    wakeWriter();
+}
+
+
+/**
+ * @brief Writes the entries that the writer thread has not written yet.
+ *
+ * Called from the fatal signal handler. This is best effort since it is
+ * not async-signal-safe, but the process is about to die anyway.
+ */
+void GdbLogWriter::writeTail()
+{
+    int fd = m_file.handle();
+    if(fd == -1)
+        return;
+
+    unsigned int tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+    unsigned int head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+    if(head - tail > GDB_LOG_RING_SIZE)
+        return;
+    for(;tail != head;tail++)
+    {
+        QByteArray line = formatEntry(m_ring[tail % GDB_LOG_RING_SIZE]);
+        if(::write(fd, line.constData(), line.size()) < 0)
+            break;
+    }
+    static const char crashNote[] = "# Gede crashed\n";
+    ssize_t rc = ::write(fd, crashNote, sizeof(crashNote)-1);
+    (void)rc;
+}
+
+
+void GdbLogWriter::run()
+{
+    while(1)
+    {
+        // Tell write() to wake us up and then check again, to not miss an
+        // entry that was added in between.
+        __atomic_store_n(&m_sleeping, 1, __ATOMIC_SEQ_CST);
+        if(!hasWork())
+            m_wakeup.acquire();
+        else if(!__atomic_exchange_n(&m_sleeping, 0, __ATOMIC_SEQ_CST))
+        {
+            // write() already cleared the flag so take its release
+            m_wakeup.acquire();
+        }
+
+        int quit = __atomic_load_n(&m_quit, __ATOMIC_ACQUIRE);
+        drain();
+        if(quit)
+            break;
+    }
+    m_file.close();
+}
+
+
+/**
+ * @brief Returns true if there are entries to write or the thread should quit.
+ */
+bool GdbLogWriter::hasWork()
+{
+    return __atomic_load_n(&m_head, __ATOMIC_SEQ_CST) != m_tail ||
+        __atomic_load_n(&m_droppedCount, __ATOMIC_SEQ_CST) != 0 ||
+        __atomic_load_n(&m_quit, __ATOMIC_SEQ_CST) != 0;
+}
+
+
+/**
+ * @brief Writes all queued entries to the file.
+ * @return The number of entries written.
+ */
+unsigned int GdbLogWriter::drain()
+{
+    unsigned int tail = m_tail;
+    unsigned int head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+    unsigned int count = head - tail;
+
+    unsigned int droppedCount = __atomic_exchange_n(&m_droppedCount, 0, __ATOMIC_RELAXED);
+    if(droppedCount > 0)
+    {
+        GdbLogEntry note;
+        note.m_text = QString("# %1 entries dropped\n").arg(droppedCount);
+        writeEntry(note);
+        if(!m_droppedWarned)
+        {
+            m_droppedWarned = true;
+            warnMsg("The GDB log can not keep up, dropped %u entries", droppedCount);
+        }
+    }
+
+    for(;tail != head;tail++)
+    {
+        GdbLogEntry &entry = m_ring[tail % GDB_LOG_RING_SIZE];
+        writeEntry(entry);
+
+        // Free the text in this thread
+        entry.m_text = QString();
+        __atomic_store_n(&m_tail, tail+1, __ATOMIC_RELEASE);
+    }
+    return count;
+}
+
+
+/**
+ * @brief Returns an entry as it is written to the file ("SS.nnnnnnnnn|TEXT").
+ */
+QByteArray GdbLogWriter::formatEntry(const GdbLogEntry &entry)
+{
+    char timeStr[32];
+    snprintf(timeStr, sizeof(timeStr), "%02d.%09d|",
+                        (int)((entry.m_timestampNs/1000000000LL)%100),
+                        (int)(entry.m_timestampNs%1000000000LL));
+    return QByteArray(timeStr) + entry.m_text.toUtf8();
+}
+
+
+void GdbLogWriter::writeEntry(const GdbLogEntry &entry)
+{
+    if(m_fileSize >= GDB_LOG_MAX_SIZE)
+        rotate();
+
+    QByteArray line = formatEntry(entry);
+    m_file.write(line);
+    m_fileSize += line.size();
+}
+
+
+/**
+ * @brief Moves the log file to FILENAME.1 (and FILENAME.1 to FILENAME.2 and so on).
+ */
+void GdbLogWriter::rotate()
+{
+    m_file.close();
+
+    QStringList suffixList;
+    suffixList += "";
+    suffixList += ".gz";
+
+    for(int s = 0;s < suffixList.size();s++)
+        QFile::remove(QString("%1.%2%3").arg(m_filename).arg(GDB_LOG_MAX_FILES).arg(suffixList[s]));
+    for(int i = GDB_LOG_MAX_FILES-1;i >= 1;i--)
+    {
+        for(int s = 0;s < suffixList.size();s++)
+        {
+            QString oldName = QString("%1.%2%3").arg(m_filename).arg(i).arg(suffixList[s]);
+            if(QFile::exists(oldName))
+                QFile::rename(oldName, QString("%1.%2%3").arg(m_filename).arg(i+1).arg(suffixList[s]));
+        }
+    }
+    QString rotatedName = m_filename + ".1";
+    QFile::rename(m_filename, rotatedName);
+
+#ifdef GDB_LOG_COMPRESS
+    QStringList gzipArgs;
+    gzipArgs += "-f";
+    gzipArgs += rotatedName;
+    QProcess::startDetached("gzip", gzipArgs);
+#endif
+
+    m_file.setFileName(m_filename);
+    if(!m_file.open(QIODevice::Truncate | QIODevice::WriteOnly | QIODevice::Unbuffered))
+        warnMsg("Failed to create %s", stringToCStr(m_filename));
+    m_fileSize = 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__GDBLOGWRITER_H
+#define FILE__GDBLOGWRITER_H
+
+#include <QThread>
+#include <QString>
+#include <QFile>
+#include <QSemaphore>
+
+#include "config.h"
+
+
+/**
+ * @brief A queued log line.
+ */
+class GdbLogEntry
+{
+public:
+    GdbLogEntry() : m_timestampNs(0) {};
+
+    qint64 m_timestampNs; //!< Wall clock time in nanoseconds.
+    QString m_text;
+};
+
+
+/**
+ * @brief Writes the GDB traffic log from a background thread.
+ *
+ * Entries are passed to the writer thread through a lock-free ring buffer
+ * so that logging does not block the thread talking to GDB. There may only
+ * be one thread calling write(). If the ring buffer is full, the entry is
+ * dropped and a note about it is written to the log. The semaphore that
+ * wakes the writer thread is only used when the thread sleeps, so write()
+ * normally takes no lock.
+ *
+ * The file is written unbuffered and the queued entries are written by a
+ * handler of the fatal signals, so the tail of the log survives a crash.
+ *
+ * The log file is rotated when it reaches GDB_LOG_MAX_SIZE bytes.
+ */
+class GdbLogWriter : public QThread
+{
+public:
+    GdbLogWriter();
+    virtual ~GdbLogWriter();
+
+    int open(QString filename);
+    void close();
+
+    void write(QString text);
+    void writeTail();
+
+protected:
+    void run();
+
+private:
+    void wakeWriter();
+    bool hasWork();
+    unsigned int drain();
+    static QByteArray formatEntry(const GdbLogEntry &entry);
+    void writeEntry(const GdbLogEntry &entry);
+    void rotate();
+
+private:
+    QString m_filename;
+    QFile m_file; //!< Only accessed by the writer thread while it runs.
+    qint64 m_fileSize;
+
+    GdbLogEntry m_ring[GDB_LOG_RING_SIZE];
+    unsigned int m_head; //!< Number of entries added (only written by the producer).
+    unsigned int m_tail; //!< Number of entries written (only written by the writer thread).
+    unsigned int m_droppedCount;
+    bool m_droppedWarned; //!< Only accessed by the writer thread.
+    int m_quit;
+    int m_sleeping; //!< Set by the writer thread before it waits for m_wakeup.
+    QSemaphore m_wakeup; //!< Released when there are entries to write and the writer thread sleeps.
+};
+
+#endif // FILE__GDBLOGWRITER_H
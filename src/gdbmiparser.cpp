@@ -9,6 +9,7 @@
 //#define ENABLE_DEBUGMSG
 
 #include <assert.h>
+#include <limits.h>
 
 #include "gdbmiparser.h"
 #include "util.h"
@@ -390,3 +391,142 @@ int GdbMiParser::parseVariableData(CoreVar *var, QList<Token*> *tokenList)
     return rc;
 }
 
+
+
+static inline bool isDigitChar(ushort c)
+{
+    return '0' <= c && c <= '9';
+}
+
+static inline bool isHexDigitChar(ushort c)
+{
+    return isDigitChar(c) || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F');
+}
+
+static inline bool isIdentChar(ushort c)
+{
+    return isDigitChar(c) || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_' || c == ':';
+}
+
+
+/**
+ * @brief Decodes the common scalar values without tokenizing them.
+ *
+ * Handles integers (Eg: '-12' or '0x1f'), pointers with a symbol
+ * (Eg: '0x601040 <global_var>'), characters (Eg: '97 'a''), floats
+ * and enums. The result is the same as from tokenizeVarString() and
+ * parseVariableData().
+ *
+ * @return false if the value has some other shape.
+ */
+bool GdbMiParser::parseScalarValue(CoreVar *var, const QString &str)
+{
+    const QChar *s = str.constData();
+    int len = str.length();
+    int i;
+
+    if(len == 0)
+        return false;
+    ushort c0 = s[0].unicode();
+
+    // Enum? (Eg: 'RED' or 'true')
+    if(!isDigitChar(c0) && isIdentChar(c0))
+    {
+        for(i = 1;i < len;i++)
+        {
+            if(!isIdentChar(s[i].unicode()))
+                return false;
+        }
+        var->setData(CoreVar::TYPE_ENUM, str);
+        return true;
+    }
+
+    // Hex integer or a pointer?
+    if(len > 2 && c0 == '0' && s[1].unicode() == 'x')
+    {
+        quint64 addr = 0;
+        for(i = 2;i < len && isHexDigitChar(s[i].unicode());i++)
+        {
+            ushort c = s[i].unicode();
+            addr = (addr << 4) | (isDigitChar(c) ? c-'0' : (c|0x20)-'a'+10);
+        }
+        int digitCount = i-2;
+        if(digitCount == 0 || digitCount > 16)
+            return false;
+
+        if(i == len)
+        {
+            var->setData(CoreVar::TYPE_HEX_INT, (qulonglong)addr);
+            return true;
+        }
+
+        // Followed by a symbol (Eg: '0x601040 <global_var>')?
+        if(i+3 < len && s[i].unicode() == ' ' && s[i+1].unicode() == '<' && s[len-1].unicode() == '>')
+        {
+            int symStart = i+2;
+            if(s[symStart].unicode() == '<')
+                return false;
+            for(i = symStart;i < len-1;i++)
+            {
+                ushort c = s[i].unicode();
+                if(c == '>' || c == '\\')
+                    return false;
+            }
+
+            // The address is parsed as a signed value
+            var->setPointerAddress(addr > (quint64)LLONG_MAX ? 0 : addr);
+            setData(var, str.mid(symStart, len-1-symStart));
+            return true;
+        }
+        return false;
+    }
+
+    // Decimal integer, float or character?
+    i = 0;
+    if(c0 == '-')
+        i++;
+    int digitStart = i;
+    for(;i < len && isDigitChar(s[i].unicode());i++)
+    {
+    }
+    int digitCount = i-digitStart;
+    if(digitCount == 0)
+        return false;
+
+    if(i == len)
+    {
+        var->setData(CoreVar::TYPE_DEC_INT, str.toLongLong(0,0));
+        return true;
+    }
+
+    ushort c = s[i].unicode();
+
+    // Character? (Eg: '97 'a'')
+    if(c == ' ' && i+1 < len && s[i+1].unicode() == '\'')
+    {
+        if(digitCount > 9)
+            return false;
+        int val = 0;
+        for(int j = digitStart;j < digitStart+digitCount;j++)
+            val = val*10 + (s[j].unicode()-'0');
+        if(c0 == '-')
+            val = -val;
+        var->setData(CoreVar::TYPE_CHAR, val);
+        return true;
+    }
+
+    // Float? (Eg: '3.1400000000000001' or '1.5e+10')
+    if(c == '.')
+    {
+        for(;i < len;i++)
+        {
+            c = s[i].unicode();
+            if(!isDigitChar(c) && c != '.' && c != 'e' && c != 'E' && c != '+' && c != '-')
+                return false;
+        }
+        var->setData(CoreVar::TYPE_FLOAT, str);
+        return true;
+    }
+    return false;
+}
+
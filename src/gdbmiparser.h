@@ -26,6 +26,8 @@ class GdbMiParser
 
 
     static void setData(CoreVar *var, QString data);
+
+    static bool parseScalarValue(CoreVar *var, const QString &str);
     
 };
 
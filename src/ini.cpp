@@ -11,6 +11,7 @@
 #include <QFile>
 #include <QStringList>
 #include <assert.h>
+#include <string.h>
 #include <QtDebug>
 
 #include "util.h"
@@ -111,6 +112,7 @@ IniEntry *IniGroup::addEntry(QString name, IniEntry::EntryType type)
     {
         entry = new IniEntry(name);
         m_entries.push_back(entry);
+        m_entryLookup.insert(name, entry);
     }
     entry->m_type = type;
     return entry;
@@ -119,16 +121,7 @@ IniEntry *IniGroup::addEntry(QString name, IniEntry::EntryType type)
 
 IniEntry *IniGroup::findEntry(QString entryName)
 {
-    for(int i = 0;i < m_entries.size();i++)
-    {
-        IniEntry *entry = NULL;
-        entry = m_entries[i];
-        if(entry->m_name == entryName)
-            return entry;
-        assert(entry->m_name.toUpper() != entryName.toUpper());
-
-    }
-    return NULL;
+    return m_entryLookup.value(entryName, NULL);
 }
 
 
@@ -140,6 +133,7 @@ void IniGroup::removeAll()
         delete entry;
     }
     m_entries.clear();
+    m_entryLookup.clear();
 }
 
 /**
@@ -148,11 +142,15 @@ void IniGroup::removeAll()
 void IniGroup::copy(const IniGroup &src)
 {
     removeAll();
+    m_name = src.m_name;
+    m_entries.reserve(src.m_entries.size());
+    m_entryLookup.reserve(src.m_entries.size());
     for(int i = 0;i < src.m_entries.size();i++)
     {
         IniEntry *entry = src.m_entries[i];
         IniEntry *newEntry = new IniEntry(*entry);
         m_entries.push_back(newEntry);
+        m_entryLookup.insert(newEntry->m_name, newEntry);
     }
 }
 
@@ -207,6 +205,7 @@ void Ini::copy(const Ini &src)
         IniGroup *entry = src.m_entries[i];
         IniGroup *newEntry = new IniGroup(*entry);
         m_entries.push_back(newEntry);
+        m_groupLookup.insert(newEntry->m_name, newEntry);
     }
 }
 
@@ -219,19 +218,13 @@ void Ini::removeAll()
         delete entry;
     }
     m_entries.clear();
+    m_groupLookup.clear();
 }
 
 
 IniGroup *Ini::findGroup(QString groupName)
 {
-    for(int i = 0;i < m_entries.size();i++)
-    {
-        IniGroup *entry = NULL;
-        entry = m_entries[i];
-        if(entry->m_name == groupName)
-            return entry;
-    }
-    return NULL;
+    return m_groupLookup.value(groupName, NULL);
 }
 
 void Ini::divideName(QString name, QString *groupName, QString *entryName)
@@ -280,6 +273,7 @@ IniEntry *Ini::addEntry(QString groupName, QString entryName, IniEntry::EntryTyp
     {
         group = new IniGroup(groupName);
         m_entries.push_back(group);
+        m_groupLookup.insert(groupName, group);
     }
     return group->addEntry(entryName, type);
 }
@@ -636,198 +630,151 @@ QString Ini::encodeValueString(const IniEntry &entry)
 }
 
 
+/**
+ * @brief Returns a pointer to the end of the line (the '\r' or '\n' or the end of the buffer).
+ */
+static const char *findLineEnd(const char *p, const char *end)
+{
+    while(p < end && *p != '\n' && *p != '\r')
+        p++;
+    return p;
+}
+
+
+/**
+ * @brief Returns a pointer to the first occurance of a character on the line (or NULL if not found).
+ */
+static const char *findOnLine(const char *p, const char *end, char c)
+{
+    while(p < end && *p != '\n' && *p != '\r')
+    {
+        if(*p == c)
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+
 /**
  * @brief Loads the content of a ini file.
+ *
+ * The file is parsed as raw bytes and only the keys and values are converted to QString.
  * @return 0 on success.
  */
 int Ini::appendLoad(QString filename)
 {
     int lineNo = 1;
-    QString str;
-    QString name;
-    QString value2;
-    QString specialKind;
     QString groupName;
 
     debugMsg("Ini::%s(filename:\"%s\")", __func__, stringToCStr(filename));
     
     QFile file(filename);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         return 1;
     }
     
-    QString allContent(file.readAll ());
+    QByteArray allContent = file.readAll();
+    const char *p = allContent.constData();
+    const char *end = p + allContent.size();
 
-
-    enum { STATE_IDLE, STATE_SKIP_LINE, STATE_KEY, STATE_GROUP, STATE_VALUE,
-        STATE_SPECIAL_TYPE, STATE_SPECIAL_DATA, STATE_VALUE_STR } state = STATE_IDLE;
-    for(int i = 0;i < allContent.size();i++)
+    while(p < end)
     {
+        char c = *p;
 
-        QChar c = allContent[i];
-
-    switch(state)
-    {
-            case STATE_IDLE:
+        if(c == '\n')
+        {
+            lineNo++;
+            p++;
+        }
+        else if(c == '\r' || c == ' ' || c == '\t')
+            p++;
+        else if(c == '#')
+            p = findLineEnd(p, end);
+        else if(c == '=')
+        {
+            errorMsg("Empty key at L%d", lineNo);
+            p = findLineEnd(p, end);
+        }
+        else if(c == '[')
+        {
+            const char *groupEnd = findOnLine(p+1, end, ']');
+            if(groupEnd == NULL)
             {
-                if(c == QChar('='))
-                {
-                    errorMsg("Empty key at L%d", lineNo);
-                    state = STATE_SKIP_LINE;
-                }
-                else if(c == QChar('\n') || c == QChar('\r'))
-                {
-                    lineNo++;
-                }
-                else if(c.isSpace())
-                {
-
-                }
-                else if(c == QChar('#'))
-                {
-                    state = STATE_SKIP_LINE;
-                }
-                else if(c == QChar('['))
-                {
-                    str = "";
-                    state = STATE_GROUP;
-                }
-                else
-                {
-                    str = c;
-                    state = STATE_KEY;
-                    specialKind = "";
-                }
-                
-            };break;
-            case STATE_GROUP:
+                errorMsg("Parse error at L%d", lineNo);
+                p = findLineEnd(p, end);
+            }
+            else
             {
-                if(c == QChar('\n') || c == QChar('\r'))
-                {
-                    errorMsg("Parse error at L%d", lineNo);
-                    lineNo++;
-                    state = STATE_IDLE;
-                }
-                else if(c == QChar(']'))
-                {
-                    groupName = str;
-                    state = STATE_IDLE;
-                }
-                else
-                    str += c;
-
-
-            };break;
-            case STATE_KEY:
+                groupName = QString::fromUtf8(p+1, groupEnd-(p+1));
+                p = groupEnd+1;
+            }
+        }
+        else
+        {
+            // Get the key
+            const char *keyEnd = findOnLine(p, end, '=');
+            if(keyEnd == NULL)
             {
-                if(c == QChar('\n') || c == QChar('\r'))
-                {
-                    errorMsg("Parse error at L%d", lineNo);
-                    lineNo++;
-                    state = STATE_IDLE;
-                }
-                else if(c == QChar('='))
-                {
-                    name = str;
-                    value2.clear();
-                    state = STATE_VALUE;
-                }
-                else
-                    str += c;
-
-            };break;
-            case STATE_VALUE:
+                errorMsg("Parse error at L%d", lineNo);
+                p = findLineEnd(p, end);
+                continue;
+            }
+            QString name = QString::fromUtf8(p, keyEnd-p).trimmed();
+            p = keyEnd+1;
+            while(p < end && (*p == ' ' || *p == '\t'))
+                p++;
+
+            // Quoted string?
+            if(p < end && *p == '"')
             {
-                if(c == QChar('\n') || c == QChar('\r'))
+                const char *valueStart = p+1;
+                const char *valueEnd = (const char*)memchr(valueStart, '"', end-valueStart);
+                if(valueEnd == NULL)
+                    valueEnd = end;
+                for(const char *q = valueStart;q < valueEnd;q++)
                 {
-                    lineNo++;
-
-                    IniEntry *entry = addEntry(groupName, name.trimmed(), IniEntry::TYPE_STRING);
-                    if(decodeValueString(entry, "", value2.trimmed()))
-                        warnMsg("Parse error in %s:L%d", stringToCStr(filename), lineNo);
-                             
-                    state = STATE_IDLE;
+                    if(*q == '\n')
+                        lineNo++;
                 }
-                else
-                {
-                    if(value2.isEmpty())
-                    {
-                        if(c == '"')
-                            state = STATE_VALUE_STR;
-                        else if(c == '@')
-                            state = STATE_SPECIAL_TYPE;
-                        else if(!c.isSpace())
-                            value2 += c;
-                    }
-                    else
-                    {
-                        value2 += c;
-                    }
-                }
-            };break;
-            case STATE_SPECIAL_TYPE:
+                IniEntry *entry = addEntry(groupName, name, IniEntry::TYPE_STRING);
+                entry->m_value = QString::fromUtf8(valueStart, valueEnd-valueStart);
+                p = valueEnd < end ? valueEnd+1 : end;
+            }
+            // Special type? Eg: "@ByteArray(...)"
+            else if(p < end && *p == '@')
             {
-                if(c == QChar('\n') || c == QChar('\r'))
+                const char *dataStart = findOnLine(p+1, end, '(');
+                if(dataStart == NULL)
                 {
-                    lineNo++;
-
                     errorMsg("Parse error in L%d", lineNo);
-                             
-                    state = STATE_IDLE;
+                    p = findLineEnd(p, end);
+                    continue;
                 }
-                else
+                QString specialKind = QString::fromLatin1(p+1, dataStart-(p+1)).trimmed();
+                dataStart++;
+                const char *dataEnd = (const char*)memchr(dataStart, ')', end-dataStart);
+                if(dataEnd == NULL)
+                    dataEnd = end;
+                for(const char *q = dataStart;q < dataEnd;q++)
                 {
-                    if(c == '(')
-                    {
-                        specialKind = value2;
-                        value2.clear();
-                        state = STATE_SPECIAL_DATA;
-                    }
-                    else if(!c.isSpace())
-                        value2 += c;
+                    if(*q == '\n')
+                        lineNo++;
                 }
-            };break;
-            case STATE_SPECIAL_DATA:
+                IniEntry *entry = addEntry(groupName, name, IniEntry::TYPE_STRING);
+                decodeValueString(entry, specialKind, QString::fromUtf8(dataStart, dataEnd-dataStart).trimmed());
+                p = dataEnd < end ? dataEnd+1 : end;
+            }
+            else
             {
-                if(c == QChar(')'))
-                {
-                    IniEntry *entry = addEntry(groupName, name.trimmed(), IniEntry::TYPE_STRING);
-                    decodeValueString(entry,specialKind, value2.trimmed());
-                             
-                    state = STATE_IDLE;
-                }
-                else
-                    value2 += c;
-
-            };break;
-            case STATE_VALUE_STR:
-            {
-                if(c == QChar('"'))
-                {
-                    IniEntry *entry = addEntry(groupName, name.trimmed(), IniEntry::TYPE_STRING);
-                    entry->m_value = value2;
-                             
-                    state = STATE_IDLE;
-                }
-                else
-                    value2 += c;
-                
-            };break;
-            case STATE_SKIP_LINE:
-            {
-                if(c == QChar('\n') || c == QChar('\r'))
-                {
-                    lineNo++;
-                    state = STATE_IDLE;
-                }
-            };break;
-
-        };
+                const char *valueEnd = findLineEnd(p, end);
+                IniEntry *entry = addEntry(groupName, name, IniEntry::TYPE_STRING);
+                if(decodeValueString(entry, "", QString::fromUtf8(p, valueEnd-p).trimmed()))
+                    warnMsg("Parse error in %s:L%d", stringToCStr(filename), lineNo);
+                p = valueEnd;
+            }
+        }
     }
     return 0;
 }
-
-
-
-
@@ -14,6 +14,7 @@
 #include <QString>
 #include <QColor>
 #include <QVariant>
+#include <QHash>
 
 class IniGroup;
 class Ini;
@@ -60,6 +61,7 @@ class IniGroup
     private:
         QString m_name;
         QVector<IniEntry *> m_entries;
+        QHash<QString, IniEntry *> m_entryLookup; //!< Entry name to entry.
         
     friend Ini;
 };
@@ -111,6 +113,7 @@ private:
     
 private:
     QVector<IniGroup*> m_entries;
+    QHash<QString, IniGroup*> m_groupLookup; //!< Group name to group.
 };
 
 #endif // FILE__INI_H
@@ -12,6 +12,8 @@
 
 #include "locator.h"
 
+#include <algorithm>
+
 #include "util.h"
 #include "log.h"
 #include "core.h"
@@ -34,6 +36,7 @@ void Location::dump()
 Locator::Locator(TagManager *mgr, QList<FileInfo> *sourceFiles)
     : m_mgr(mgr)
     ,m_sourceFiles(sourceFiles)
+    ,m_tagIndexGeneration(-1)
 {
 }
 
@@ -47,6 +50,84 @@ void Locator::setCurrentFile(QString filename)
     m_currentFilename = filename;
 }
 
+
+/**
+ * @brief Compares the completion names of two tags (given by their index).
+ */
+class CompletionNameLess
+{
+public:
+    CompletionNameLess(const QVector<LocatorTag> &tags) : m_tags(tags) {};
+
+    bool operator()(int a, int b) const { return m_tags[a].m_completionName < m_tags[b].m_completionName; };
+    bool operator()(int a, const QString &b) const { return m_tags[a].m_completionName < b; };
+
+private:
+    const QVector<LocatorTag> &m_tags;
+};
+
+
+/**
+ * @brief Must be called when the list of source files has changed.
+ */
+void Locator::updateFileIndex()
+{
+    m_filesByName.clear();
+    for(int k = 0;k < m_sourceFiles->size();k++)
+    {
+        const FileInfo &info = (*m_sourceFiles)[k];
+        m_filesByName[info.m_name].append(k);
+    }
+
+    m_sortedFileNames = m_filesByName.keys();
+    std::sort(m_sortedFileNames.begin(), m_sortedFileNames.end());
+
+    m_tagIndexGeneration = -1;
+}
+
+
+/**
+ * @brief Rebuilds the tag index if any file has been scanned since the last time.
+ */
+void Locator::updateTagIndex()
+{
+    if(m_tagIndexGeneration == m_mgr->getGeneration())
+        return;
+    m_tagIndexGeneration = m_mgr->getGeneration();
+
+    m_tags.clear();
+    m_tagsByName.clear();
+    m_sortedFunctions.clear();
+    for(int k = 0;k < m_sourceFiles->size();k++)
+    {
+        const FileInfo &info = (*m_sourceFiles)[k];
+        const QList<Tag> &tagList = m_mgr->getTagList(info.m_fullName);
+        for(int i = 0;i < tagList.size();i++)
+        {
+            const Tag &tag = tagList[i];
+            LocatorTag entry;
+            entry.m_name = tag.getName();
+            entry.m_className = tag.getClassName();
+            entry.m_filePath = tag.getFilePath();
+            entry.m_lineNo = tag.getLineNo();
+            entry.m_isFunc = tag.m_type == Tag::TAG_FUNC;
+            if(entry.m_isFunc)
+            {
+                if(tag.isClassMember())
+                    entry.m_completionName = tag.getClassName() + "::" + tag.getName();
+                else
+                    entry.m_completionName = tag.getName();
+                entry.m_completionName += "()";
+                m_sortedFunctions.append(m_tags.size());
+            }
+            m_tagsByName[entry.m_name].append(m_tags.size());
+            m_tags.append(entry);
+        }
+    }
+
+    std::sort(m_sortedFunctions.begin(), m_sortedFunctions.end(), CompletionNameLess(m_tags));
+}
+
 static bool validFunctionChar(QChar c)
 {
     if(c.isDigit() || c.isLetter() || c == '.' || c == ':' || c == '_' || c == '(' || c == ')' || c == '~')
@@ -109,18 +190,19 @@ static QStringList tokenize(QString expr)
 
 
 
+/**
+ * @brief Finds the files with a name (Eg: "main.c") or a path suffix (Eg: "src/main.c").
+ */
 QStringList Locator::findFile(QString defFilename)
 {
     QStringList fileList;
-    if(!defFilename.contains('/'))
+    bool isPath = defFilename.contains('/');
+    const QVector<int> idxList = m_filesByName.value(getFilenamePart(defFilename));
+    for(int k = 0;k < idxList.size();k++)
     {
-        for(int k = 0;k < m_sourceFiles->size();k++)
-        {
-            FileInfo &info = (*m_sourceFiles)[k];
-            if(info.m_name == defFilename)
-                fileList.append(info.m_fullName);
-
-        }
+        const FileInfo &info = (*m_sourceFiles)[idxList[k]];
+        if(!isPath || info.m_fullName == defFilename || info.m_fullName.endsWith("/" + defFilename))
+            fileList.append(info.m_fullName);
     }
     if(fileList.isEmpty())
         warnMsg("File '%s' not found", qPrintable(defFilename));
@@ -133,20 +215,16 @@ QStringList Locator::searchExpression(QString filename, QString expressionStart)
     debugMsg("%s('%s', '%s')", __func__, qPrintable(filename), qPrintable(expressionStart));
     
     QStringList list;
-    for(int k = 0;k < m_sourceFiles->size();k++)
+    const QVector<int> idxList = m_filesByName.value(filename);
+    for(int k = 0;k < idxList.size();k++)
     {
-        FileInfo &info = (*m_sourceFiles)[k];
+        const FileInfo &info = (*m_sourceFiles)[idxList[k]];
 
-        
-        if(info.m_name != filename)
-            continue;
-            
         // Find the tag
-        QList<Tag> tagList;
-        m_mgr->getTags(info.m_fullName, &tagList);
+        const QList<Tag> &tagList = m_mgr->getTagList(info.m_fullName);
         for(int i = 0;i < tagList.size();i++)
         {
-            Tag &tag = tagList[i];
+            const Tag &tag = tagList[i];
             if(tag.m_type == Tag::TAG_FUNC)
             {
                 QString tagName = tag.getName() + "()";
@@ -165,35 +243,27 @@ QStringList Locator::searchExpression(QString filename, QString expressionStart)
 QStringList Locator::searchExpression(QString expressionStart)
 {
     QStringList list;
-    for(int k = 0;k < m_sourceFiles->size();k++)
-    {
-        FileInfo &info = (*m_sourceFiles)[k];
-        if(info.m_name.startsWith(expressionStart))
-            list.append(info.m_name);
 
+    // Filenames starting with the text
+    QStringList::const_iterator fileIt = std::lower_bound(m_sortedFileNames.constBegin(), m_sortedFileNames.constEnd(), expressionStart);
+    for(;fileIt != m_sortedFileNames.constEnd() && fileIt->startsWith(expressionStart);++fileIt)
+    {
+        int count = m_filesByName.value(*fileIt).size();
+        for(int k = 0;k < count;k++)
+            list.append(*fileIt);
+    }
 
-        // Find the tag
-        QList<Tag> tagList;
-        m_mgr->getTags(info.m_fullName, &tagList);
-        for(int i = 0;i < tagList.size();i++)
-        {
-            Tag &tag = tagList[i];
-            if(tag.m_type == Tag::TAG_FUNC)
-            {
-            QString tagName;
-            if(tag.isClassMember())
-                tagName = tag.getClassName() + "::" + tag.getName();
-            else
-                tagName = tag.getName();
-            tagName += "()";
-            
-            if(tagName.startsWith(expressionStart))
-            {
-                debugMsg("Found '%s'", qPrintable(tagName));
-                list.append(tagName);
-            }
-            }
-        }
+    // Functions starting with the text
+    updateTagIndex();
+    QVector<int>::const_iterator funcIt = std::lower_bound(m_sortedFunctions.constBegin(), m_sortedFunctions.constEnd(),
+                                            expressionStart, CompletionNameLess(m_tags));
+    for(;funcIt != m_sortedFunctions.constEnd();++funcIt)
+    {
+        const QString &tagName = m_tags[*funcIt].m_completionName;
+        if(!tagName.startsWith(expressionStart))
+            break;
+        debugMsg("Found '%s'", qPrintable(tagName));
+        list.append(tagName);
     }
                 
     return list;
@@ -265,19 +335,26 @@ QVector<Location> Locator::locate(QString expr)
 
                 debugMsg("Looking for function '%s'", qPrintable(funcName));
             
+                QString className;
+                if(funcName.contains("::"))
+                {
+                    int divPos = funcName.indexOf("::");
+                    className = funcName.left(divPos);
+                    funcName = funcName.mid(divPos+2);
+                }
+
                 // Find the tag
-                QList<Tag> tagList;
-                m_mgr->lookupTag(funcName, &tagList);
-                for(int i = 0;i < tagList.size();i++)
+                updateTagIndex();
+                const QVector<int> idxList = m_tagsByName.value(funcName);
+                for(int i = 0;i < idxList.size();i++)
                 {
-                    Tag &tag = tagList[i];
-#ifdef ENABLE_DEBUGMSG
-                    tag.dump();
-#endif
+                    const LocatorTag &tag = m_tags[idxList[i]];
+                    if(tag.m_className != className)
+                        continue;
                     if(defFilename.isEmpty() ||
-                        tag.getFilePath().endsWith("/" + defFilename))
+                        tag.m_filePath.endsWith("/" + defFilename))
                     {
-                        Location loc = Location(tag.getFilePath(), tag.getLineNo());
+                        Location loc = Location(tag.m_filePath, tag.m_lineNo);
 #ifdef ENABLE_DEBUGMSG
                         loc.dump();
 #endif
@@ -334,22 +411,14 @@ QVector<Location> Locator::locate(QString expr)
 QVector<Location> Locator::locateFunction(QString name)
 {
     QVector<Location> list;
-    for(int k = 0;k < m_sourceFiles->size();k++)
-    {
-        FileInfo &info = (*m_sourceFiles)[k];
 
-        // Find the tag
-        QList<Tag> tagList;
-        m_mgr->getTags(info.m_fullName, &tagList);
-        for(int i = 0;i < tagList.size();i++)
-        {
-            Tag &tag = tagList[i];
-            if(tag.m_type == Tag::TAG_FUNC && tag.getName() == name)
-            {
-                list.append(Location(tag.getFilePath(), tag.getLineNo()));
-            }
-            
-        }
+    updateTagIndex();
+    const QVector<int> idxList = m_tagsByName.value(name);
+    for(int i = 0;i < idxList.size();i++)
+    {
+        const LocatorTag &tag = m_tags[idxList[i]];
+        if(tag.m_isFunc)
+            list.append(Location(tag.m_filePath, tag.m_lineNo));
     }
     return list;
 }
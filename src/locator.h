@@ -3,6 +3,8 @@
 
 #include <QString>
 #include <QVector>
+#include <QHash>
+#include <QStringList>
 
 #include "tagmanager.h"
 
@@ -19,6 +21,27 @@ public:
     int m_lineNo;
 };
 
+/**
+ * @brief A tag in the index of the Locator.
+ */
+class LocatorTag
+{
+public:
+    QString m_name; //!< Eg: "func".
+    QString m_className;
+    QString m_completionName; //!< Eg: "Class::func()" (only set for functions).
+    QString m_filePath;
+    int m_lineNo;
+    bool m_isFunc;
+};
+
+
+/**
+ * @brief Finds files, functions and lines from expressions like "file.cpp:123".
+ *
+ * The files are indexed by their name and the tags by their name so
+ * that a lookup only touches the matches, even for huge projects.
+ */
 class Locator
 {
 public:
@@ -26,6 +49,7 @@ public:
     virtual ~Locator();
     
     void setCurrentFile(QString filename);
+    void updateFileIndex();
     QVector<Location> locate(QString expr);
     QVector<Location> locateFunction(QString name);
 
@@ -35,11 +59,20 @@ public:
 
 private:
     QStringList findFile(QString defFilename);
+    void updateTagIndex();
     
 public:
     TagManager *m_mgr;
     QString m_currentFilename;
     QList<FileInfo> *m_sourceFiles;
+
+private:
+    QHash<QString, QVector<int> > m_filesByName; //!< Index in m_sourceFiles for each filename (Eg: "main.c").
+    QStringList m_sortedFileNames; //!< The unique filenames (sorted).
+    QVector<LocatorTag> m_tags; //!< The tags of all the files in m_sourceFiles.
+    QHash<QString, QVector<int> > m_tagsByName; //!< Index in m_tags for each tag name.
+    QVector<int> m_sortedFunctions; //!< Index in m_tags of all functions sorted by m_completionName.
+    int m_tagIndexGeneration; //!< The TagManager generation the tag index was built from (-1 if outdated).
 };
 
 #endif // FILE__LOCATOR_H
@@ -9,35 +9,35 @@
 #include "log.h"
 
 #include <QDebug>
-#include <QTime>
-#include <QMutex>
-#include <QMutexLocker>
+#include <QThread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
 
 namespace gedelog
 {
-struct LogEntry
+/**
+ * @brief A queued message. The text is stored directly after the struct.
+ */
+struct LogNode
 {
-public:
-    typedef enum { TYPE_CRIT, TYPE_WARN, TYPE_INFO, TYPE_ERROR} Type;
-
-    LogEntry(Type t, QString msg) : m_type(t), m_text(msg) {};
-    virtual ~LogEntry() {};
-    
-
-    Type m_type;
-    QString m_text;
-    
+    LogNode *m_next;
+    LogLevel m_level;
+    qint64 m_timestampUs;
+    const char *m_filename; //!< Source file of a debug message (or NULL).
+    int m_lineNo;
+    int m_textLen;
+    char m_text[1];
 };
 }
 
 using namespace gedelog;
 
 
-static QMutex g_mutex;
-static ILogger *g_logger = NULL;
-static QList<gedelog::LogEntry> m_pendingEntries;
-
-
 #ifdef WIN32
 #define YELLOW_CODE ""
 #define GREEN_CODE  ""
@@ -50,168 +50,456 @@ static QList<gedelog::LogEntry> m_pendingEntries;
 #define NO_CODE     "\033[1;0m"
 #endif
 
+#ifdef ENABLE_DEBUGMSG
+#define CONSOLE_DEFAULT_LEVEL  LOG_LEVEL_DEBUG
+#else
+#define CONSOLE_DEFAULT_LEVEL  LOG_LEVEL_NONE
+#endif
 
 
-void loggerRegister(ILogger *logger)
-{
-    QMutexLocker locker(&g_mutex);
-    g_logger = logger;
+// The messages are passed through a lock-free multi-producer, single-consumer
+// queue (an intrusive linked list). Producers swap in their node at g_head and
+// the consumer pops from g_tail. The thread that logged a message tries to
+// become the consumer and deliver everything queued so far. If another thread
+// already is the consumer, that thread delivers it instead.
+static LogNode g_stub;
+static LogNode *g_head = &g_stub;
+static LogNode *g_tail = &g_stub;
+static unsigned int g_pushCount = 0;
+static unsigned int g_popCount = 0;
+static int g_consumerBusy = 0;
+
+// Number of nested acquireConsumer() calls by this thread. Non-zero while
+// the thread is the consumer, eg: when a sink logs from its callback.
+static __thread int g_consumerDepth = 0;
+
+// Lowest level that any sink accepts (read by the producers).
+static int g_minLevel = CONSOLE_DEFAULT_LEVEL < LOG_LEVEL_INFO ? CONSOLE_DEFAULT_LEVEL : LOG_LEVEL_INFO;
+
+// Only accessed by the consumer.
+static ILogger *g_logger = NULL;
+static QList<LogMessage> g_pendingEntries;
+static FILE *g_file = NULL;
+static int g_levels[LOG_SINK_COUNT] = { LOG_LEVEL_INFO, LOG_LEVEL_DEBUG, CONSOLE_DEFAULT_LEVEL };
 
-    while(!m_pendingEntries.isEmpty())
+static const char *g_levelNames[] = { "DEBUG", "INFO ", "WARN ", "ERROR", "CRIT " };
+static const char *g_levelColours[] = { "", "", YELLOW_CODE, RED_CODE, RED_CODE };
+
+
+void ILogger::ILogger_onMessages(const QList<LogMessage> &msgList)
+{
+    for(int i = 0;i < msgList.size();i++)
     {
-        LogEntry entry = m_pendingEntries.takeFirst();
-        if(entry.m_type == LogEntry::TYPE_INFO)
-            g_logger->ILogger_onInfoMsg(entry.m_text);
-        else if(entry.m_type == LogEntry::TYPE_WARN)
-            g_logger->ILogger_onWarnMsg(entry.m_text);
-        else if(entry.m_type == LogEntry::TYPE_CRIT)
-            g_logger->ILogger_onCriticalMsg(entry.m_text);
+        const LogMessage &msg = msgList[i];
+        if(msg.m_level == LOG_LEVEL_CRIT)
+            ILogger_onCriticalMsg(msg.m_text);
+        else if(msg.m_level == LOG_LEVEL_ERROR)
+            ILogger_onErrorMsg(msg.m_text);
+        else if(msg.m_level == LOG_LEVEL_WARN)
+            ILogger_onWarnMsg(msg.m_text);
         else
-            g_logger->ILogger_onErrorMsg(entry.m_text);
+            ILogger_onInfoMsg(msg.m_text);
     }
-    
 }
 
-void loggerUnregister(ILogger *logger)
+
+static void pushNode(LogNode *node)
 {
-    QMutexLocker locker(&g_mutex);
-    Q_UNUSED(logger);
-    
-    g_logger = NULL;
+    node->m_next = NULL;
+    LogNode *prev = __atomic_exchange_n(&g_head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->m_next, node, __ATOMIC_RELEASE);
 }
 
 
-void debugMsg_(const char *filename, int lineNo, const char *fmt, ...)
+/**
+ * @brief Removes the oldest node from the queue (only called by the consumer).
+ * @return NULL if the queue is empty or if the next node is not completely pushed yet.
+ */
+static LogNode *popNode()
 {
-    va_list ap;
-    char buffer[1024];
-    QTime curTime = QTime::currentTime();
+    LogNode *tail = g_tail;
+    LogNode *next = __atomic_load_n(&tail->m_next, __ATOMIC_ACQUIRE);
+    if(tail == &g_stub)
+    {
+        if(next == NULL)
+            return NULL;
+        g_tail = next;
+        tail = next;
+        next = __atomic_load_n(&tail->m_next, __ATOMIC_ACQUIRE);
+    }
+    if(next)
+    {
+        g_tail = next;
+        return tail;
+    }
 
-    QMutexLocker locker(&g_mutex);
+    // A producer is in the middle of pushing?
+    if(tail != __atomic_load_n(&g_head, __ATOMIC_ACQUIRE))
+        return NULL;
 
-    va_start(ap, fmt);
+    // Put back the stub so that the last node can be removed
+    pushNode(&g_stub);
+    next = __atomic_load_n(&tail->m_next, __ATOMIC_ACQUIRE);
+    if(next)
+    {
+        g_tail = next;
+        return tail;
+    }
+    return NULL;
+}
 
-    vsnprintf(buffer, sizeof(buffer), fmt, ap);
 
+static bool tryAcquireConsumer()
+{
+    int expected = 0;
+    if(!__atomic_compare_exchange_n(&g_consumerBusy, &expected, 1, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        return false;
+    g_consumerDepth = 1;
+    return true;
+}
 
-    va_end(ap);
 
-    printf("%2d.%03d| DEBUG | %s:%3d| %s\n",
-        curTime.second()%100, curTime.msec(),
-        filename, lineNo, buffer);
+static void acquireConsumer()
+{
+    // Already the consumer (called from a sink)?
+    if(g_consumerDepth > 0)
+    {
+        g_consumerDepth++;
+        return;
+    }
+    while(!tryAcquireConsumer())
+        QThread::yieldCurrentThread();
 }
 
 
-void errorMsg(const char *fmt, ...)
+static void releaseConsumer()
 {
-    va_list ap;
-    char buffer[1024];
-    QTime curTime = QTime::currentTime();
+    g_consumerDepth--;
+    if(g_consumerDepth == 0)
+        __atomic_store_n(&g_consumerBusy, 0, __ATOMIC_SEQ_CST);
+}
 
-    QMutexLocker locker(&g_mutex);
 
-    va_start(ap, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, ap);
+static int getSinkLevel(LogSink sink)
+{
+    if(sink == LOG_SINK_FILE && g_file == NULL)
+        return LOG_LEVEL_NONE;
 
+    // Until there is a UI to show them, the messages are shown on the console.
+    if(sink == LOG_SINK_CONSOLE && g_logger == NULL)
+        return qMin(g_levels[sink], (int)LOG_LEVEL_INFO);
+    return g_levels[sink];
+}
 
-    va_end(ap);
+
+static void updateMinLevel()
+{
+    int minLevel = LOG_LEVEL_NONE;
+    for(int sink = 0;sink < LOG_SINK_COUNT;sink++)
+        minLevel = qMin(minLevel, getSinkLevel((LogSink)sink));
+    __atomic_store_n(&g_minLevel, minLevel, __ATOMIC_RELAXED);
+}
 
 
-    if(g_logger)
-        g_logger->ILogger_onErrorMsg(buffer);
+static void writeLine(FILE *file, const LogNode *node, bool useColours)
+{
+    int sec = (int)((node->m_timestampUs/1000000LL)%60);
+    int msec = (int)((node->m_timestampUs/1000LL)%1000);
+    const char *startCode = useColours ? g_levelColours[node->m_level] : "";
+    const char *endCode = startCode[0] != '\0' ? NO_CODE : "";
+
+    if(node->m_filename)
+        fprintf(file, "%s%2d.%03d| %s | %s:%3d| %s%s\n",
+            startCode, sec, msec, g_levelNames[node->m_level],
+            node->m_filename, node->m_lineNo, node->m_text, endCode);
     else
+        fprintf(file, "%s%2d.%03d| %s | %s%s\n",
+            startCode, sec, msec, g_levelNames[node->m_level],
+            node->m_text, endCode);
+}
+
+
+/**
+ * @brief Delivers all queued messages to the sinks (only called by the consumer).
+ * @return The number of messages removed from the queue.
+ */
+static int drain()
+{
+    int uiLevel = getSinkLevel(LOG_SINK_UI);
+    int fileLevel = getSinkLevel(LOG_SINK_FILE);
+    int consoleLevel = getSinkLevel(LOG_SINK_CONSOLE);
+    QList<LogMessage> batch;
+    int count = 0;
+
+    LogNode *node;
+    while((node = popNode()) != NULL)
     {
-        m_pendingEntries.append(LogEntry(LogEntry::TYPE_ERROR, buffer));
+        __atomic_store_n(&g_popCount, g_popCount+1, __ATOMIC_SEQ_CST);
+        count++;
+
+        if(node->m_level >= consoleLevel)
+            writeLine(stderr, node, true);
+        if(node->m_level >= fileLevel)
+            writeLine(g_file, node, false);
+        if(node->m_level >= uiLevel)
+        {
+            LogMessage msg;
+            msg.m_level = node->m_level;
+            msg.m_timestampUs = node->m_timestampUs;
+            msg.m_text = QString::fromUtf8(node->m_text, node->m_textLen);
+            batch.append(msg);
+        }
+        free(node);
+    }
 
-        printf(RED_CODE "%2d.%03d| ERROR | %s" NO_CODE "\n",
-            curTime.second()%100, curTime.msec(),
-            buffer);
+    if(count > 0 && g_file)
+        fflush(g_file);
 
+    if(!batch.isEmpty())
+    {
+        if(g_logger)
+            g_logger->ILogger_onMessages(batch);
+        else
+        {
+            g_pendingEntries += batch;
+            while(g_pendingEntries.size() > LOG_PENDING_MAX)
+                g_pendingEntries.removeFirst();
+        }
     }
+    return count;
+}
 
+
+/**
+ * @brief Delivers the queued messages unless another thread already is doing it.
+ *
+ * A message logged by a sink is only queued, the consumer that called the
+ * sink delivers it.
+ */
+static void dispatch()
+{
+    if(g_consumerDepth > 0)
+        return;
+
+    while(tryAcquireConsumer())
+    {
+        int count = drain();
+        releaseConsumer();
+
+        // Done unless a message was pushed while we were draining. Its producer
+        // may have failed to become the consumer and left it to us.
+        if(__atomic_load_n(&g_pushCount, __ATOMIC_SEQ_CST) == __atomic_load_n(&g_popCount, __ATOMIC_SEQ_CST))
+            break;
+
+        // Wait for a producer that is in the middle of pushing
+        if(count == 0)
+            QThread::yieldCurrentThread();
+    }
 }
 
 
-void warnMsg(const char *fmt, ...)
+static void logMsg(LogLevel level, const char *filename, int lineNo, const char *fmt, va_list ap)
 {
-    va_list ap;
+    // Skip the formatting if no sink wants the message
+    if((int)level < __atomic_load_n(&g_minLevel, __ATOMIC_RELAXED))
+        return;
+
     char buffer[1024];
-    QTime curTime = QTime::currentTime();
+    int len = vsnprintf(buffer, sizeof(buffer), fmt, ap);
+    if(len < 0)
+    {
+        len = 0;
+        buffer[0] = '\0';
+    }
+    else if(len >= (int)sizeof(buffer))
+        len = sizeof(buffer)-1;
 
-    QMutexLocker locker(&g_mutex);
+    LogNode *node = (LogNode*)malloc(sizeof(LogNode) + len);
+    if(node == NULL)
+        return;
 
-    va_start(ap, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, ap);
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
 
+    node->m_level = level;
+    node->m_timestampUs = (qint64)ts.tv_sec*1000000LL + ts.tv_nsec/1000;
+    node->m_filename = filename;
+    node->m_lineNo = lineNo;
+    node->m_textLen = len;
+    memcpy(node->m_text, buffer, len+1);
 
-    va_end(ap);
+    pushNode(node);
+    __atomic_add_fetch(&g_pushCount, 1, __ATOMIC_SEQ_CST);
 
+    dispatch();
+}
 
-    if(g_logger)
-        g_logger->ILogger_onWarnMsg(buffer);
-    else
-    {
-        m_pendingEntries.append(LogEntry(LogEntry::TYPE_WARN, buffer));
 
-        printf(YELLOW_CODE "%2d.%03d| WARN  | %s" NO_CODE "\n",
-            curTime.second()%100, curTime.msec(),
-            buffer);
+/**
+ * @brief Sets the logger that the UI sink delivers to.
+ *
+ * Messages logged before a logger was registered are delivered to it.
+ */
+void loggerRegister(ILogger *logger)
+{
+    acquireConsumer();
+    drain();
+
+    g_logger = logger;
+    updateMinLevel();
+
+    if(!g_pendingEntries.isEmpty())
+    {
+        QList<LogMessage> pendingEntries = g_pendingEntries;
+        g_pendingEntries.clear();
+        g_logger->ILogger_onMessages(pendingEntries);
     }
+
+    releaseConsumer();
+    dispatch();
 }
 
+void loggerUnregister(ILogger *logger)
+{
+    Q_UNUSED(logger);
 
+    acquireConsumer();
+    drain();
 
-void infoMsg(const char *fmt, ...)
+    g_logger = NULL;
+    updateMinLevel();
+
+    releaseConsumer();
+    dispatch();
+}
+
+
+/**
+ * @brief Sets the lowest level of messages that a sink receives.
+ */
+void loggerSetLevel(LogSink sink, LogLevel minLevel)
 {
-    va_list ap;
-    char buffer[1024];
-    QTime curTime = QTime::currentTime();
+    acquireConsumer();
+    drain();
 
-    QMutexLocker locker(&g_mutex);
+    g_levels[sink] = minLevel;
+    updateMinLevel();
 
-    va_start(ap, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, ap);
+    releaseConsumer();
+    dispatch();
+}
 
 
-    va_end(ap);
+LogLevel loggerGetLevel(LogSink sink)
+{
+    acquireConsumer();
+    LogLevel level = (LogLevel)g_levels[sink];
+    releaseConsumer();
+    dispatch();
+    return level;
+}
 
-    if(g_logger)
-        g_logger->ILogger_onInfoMsg(buffer);
-    else
-    {
-        m_pendingEntries.append(LogEntry(LogEntry::TYPE_INFO, buffer));
 
-        printf("%2d.%03d| INFO  | %s\n",
-            curTime.second()%100, curTime.msec(),
-            buffer);
-    }
+/**
+ * @brief Starts to write the messages to a file.
+ * @return 0 on success.
+ */
+int loggerOpenFile(QString filename)
+{
+    int rc = 0;
+
+    acquireConsumer();
+    drain();
+
+    if(g_file)
+        fclose(g_file);
+    g_file = fopen(filename.toLocal8Bit().constData(), "w");
+    if(g_file == NULL)
+        rc = 1;
+    updateMinLevel();
+
+    releaseConsumer();
+    dispatch();
+    return rc;
 }
 
 
+void loggerCloseFile()
+{
+    acquireConsumer();
+    drain();
 
-void critMsg(const char *fmt, ...)
+    if(g_file)
+        fclose(g_file);
+    g_file = NULL;
+    updateMinLevel();
+
+    releaseConsumer();
+    dispatch();
+}
+
+
+/**
+ * @brief Delivers all queued messages before returning.
+ */
+void loggerFlush()
+{
+    acquireConsumer();
+    drain();
+    releaseConsumer();
+    dispatch();
+}
+
+
+void debugMsg_(const char *filename, int lineNo, const char *fmt, ...)
 {
     va_list ap;
-    char buffer[1024];
-    QTime curTime = QTime::currentTime();
 
-    QMutexLocker locker(&g_mutex);
+    va_start(ap, fmt);
+    logMsg(LOG_LEVEL_DEBUG, filename, lineNo, fmt, ap);
+    va_end(ap);
+}
+
+
+void errorMsg(const char *fmt, ...)
+{
+    va_list ap;
 
     va_start(ap, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, ap);
+    logMsg(LOG_LEVEL_ERROR, NULL, 0, fmt, ap);
+    va_end(ap);
+}
+
 
+void warnMsg(const char *fmt, ...)
+{
+    va_list ap;
 
+    va_start(ap, fmt);
+    logMsg(LOG_LEVEL_WARN, NULL, 0, fmt, ap);
     va_end(ap);
+}
 
-    if(g_logger)
-        g_logger->ILogger_onCriticalMsg(buffer);
-    else
-    {
-        m_pendingEntries.append(LogEntry(LogEntry::TYPE_CRIT, buffer));
 
-        printf("%2d.%03d| ERROR | %s\n",
-            curTime.second()%100, curTime.msec(),
-            buffer);
-    }
+
+void infoMsg(const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    logMsg(LOG_LEVEL_INFO, NULL, 0, fmt, ap);
+    va_end(ap);
+}
+
+
+
+void critMsg(const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    logMsg(LOG_LEVEL_CRIT, NULL, 0, fmt, ap);
+    va_end(ap);
 }
 
@@ -10,6 +10,45 @@
 #define FILE__LOG_H
 
 #include <QDebug>
+#include <QList>
+#include <QMetaType>
+
+
+typedef enum
+{
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_CRIT,
+    LOG_LEVEL_NONE //!< Used to turn off a sink.
+} LogLevel;
+
+
+typedef enum
+{
+    LOG_SINK_UI = 0, //!< The registered ILogger.
+    LOG_SINK_FILE,
+    LOG_SINK_CONSOLE, //!< stderr
+    LOG_SINK_COUNT
+} LogSink;
+
+
+/**
+ * @brief A message delivered to an ILogger.
+ */
+class LogMessage
+{
+public:
+    LogMessage() : m_level(LOG_LEVEL_INFO), m_timestampUs(0) {};
+
+    LogLevel m_level;
+    qint64 m_timestampUs; //!< Wall clock time in microseconds.
+    QString m_text;
+};
+
+Q_DECLARE_METATYPE(LogMessage)
+
 
 class ILogger
 {
@@ -17,10 +56,12 @@ public:
     ILogger() {};
     virtual ~ILogger() {};
 
-    virtual void ILogger_onWarnMsg(QString text) = 0;
-    virtual void ILogger_onErrorMsg(QString text) = 0;
-    virtual void ILogger_onInfoMsg(QString text) = 0;
-    virtual void ILogger_onCriticalMsg(QString text) = 0;
+    virtual void ILogger_onMessages(const QList<LogMessage> &msgList);
+
+    virtual void ILogger_onWarnMsg(QString text) { Q_UNUSED(text); };
+    virtual void ILogger_onErrorMsg(QString text) { Q_UNUSED(text); };
+    virtual void ILogger_onInfoMsg(QString text) { Q_UNUSED(text); };
+    virtual void ILogger_onCriticalMsg(QString text) { Q_UNUSED(text); };
 
 };
 
@@ -40,7 +81,12 @@ void infoMsg(const char *fmt,...);
 void loggerRegister(ILogger *logger);
 void loggerUnregister(ILogger *logger);
 
+void loggerSetLevel(LogSink sink, LogLevel minLevel);
+LogLevel loggerGetLevel(LogSink sink);
+int loggerOpenFile(QString filename);
+void loggerCloseFile();
+void loggerFlush();
 
-#endif // FILE__LOG_H
 
+#endif // FILE__LOG_H
 
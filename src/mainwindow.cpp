@@ -14,9 +14,11 @@
 #include <QMessageBox>
 #include <QScrollBar>
 #include <QFileInfo>
+#include <QInputDialog>
 
 #include <assert.h>
 
+#include "config.h"
 #include "util.h"
 #include "log.h"
 #include "core.h"
@@ -26,13 +28,18 @@
 #include "codeview.h"
 #include "memorydialog.h"
 #include "gotodialog.h"
+#include "tracelog.h"
 
 
 
 MainWindow::MainWindow(QWidget *parent)
       : QMainWindow(parent)
       ,m_tagManager(m_cfg)
+      ,m_tagBrowserGeneration(-1)
       ,m_locator(&m_tagManager, &m_sourceFiles)
+      ,m_firstPaintDone(false)
+      ,m_firstTagScanDone(false)
+      ,m_tagScanTraceStart(0)
 {
     QStringList names;
 
@@ -42,6 +49,19 @@ MainWindow::MainWindow(QWidget *parent)
     m_autoVarCtl.setWidget(m_ui.autoWidget);
     m_watchVarCtl.setWidget(m_ui.varWidget);
 
+    // Log point window
+    m_ui.logPointView->setMaximumBlockCount(LOGPOINT_MAX_LINES);
+    m_logPointFlushTimer.setSingleShot(true);
+    m_logPointFlushTimer.setInterval(LOGPOINT_FLUSH_INTERVAL);
+    connect(&m_logPointFlushTimer, SIGNAL(timeout()), this, SLOT(onLogPointFlushTimeout()));
+
+    // Profiler window
+    m_ui.flameGraph->setProfile(&m_profiler.getProfile());
+    connect(&m_profiler, SIGNAL(updated()), this, SLOT(onProfilerUpdated()));
+    connect(m_ui.pushButton_profilerSample, SIGNAL(toggled(bool)), this, SLOT(onProfilerSampleToggled(bool)));
+    connect(m_ui.pushButton_profilerClear, SIGNAL(clicked()), this, SLOT(onProfilerClear()));
+    connect(m_ui.flameGraph, SIGNAL(functionClicked(QString,int)), this, SLOT(onFlameGraphFunctionClicked(QString,int)));
+
 
     m_fileIcon.addFile(QString::fromUtf8(":/images/res/file.png"), QSize(), QIcon::Normal, QIcon::Off);
     m_folderIcon.addFile(QString::fromUtf8(":/images/res/folder.png"), QSize(), QIcon::Normal, QIcon::Off);
@@ -63,6 +83,22 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_ui.treeWidget_breakpoints, SIGNAL(customContextMenuRequested(const QPoint &)), this, SLOT(onBreakpointsWidgetContextMenu(const QPoint&)));
     m_ui.treeWidget_breakpoints->setContextMenuPolicy(Qt::CustomContextMenu);
 
+    // Library widget
+    m_ui.treeWidget_libraries->setColumnCount(3);
+    m_ui.treeWidget_libraries->setColumnWidth(0, 200);
+    m_ui.treeWidget_libraries->setColumnWidth(1, 70);
+    names.clear();
+    names += "Library";
+    names += "Symbols";
+    names += "Addr";
+    m_ui.treeWidget_libraries->setHeaderLabels(names);
+    connect(m_ui.treeWidget_libraries, SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)), this, SLOT(onLibrariesWidgetItemDoubleClicked(QTreeWidgetItem*, int)));
+    connect(m_ui.treeWidget_libraries, SIGNAL(customContextMenuRequested(const QPoint &)), this, SLOT(onLibrariesWidgetContextMenu(const QPoint&)));
+    m_ui.treeWidget_libraries->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_librariesUpdateTimer.setSingleShot(true);
+    m_librariesUpdateTimer.setInterval(0);
+    connect(&m_librariesUpdateTimer, SIGNAL(timeout()), this, SLOT(onLibrariesUpdateTimeout()));
+
 
 
 
@@ -74,18 +110,21 @@ MainWindow::MainWindow(QWidget *parent)
 
 
     // Thread widget
-    treeWidget = m_ui.treeWidget_threads;
-    names.clear();
-    names += "Name";
-    names += "Details";
-    treeWidget->setHeaderLabels(names);
-    treeWidget->setColumnCount(2);
-    treeWidget->setColumnWidth(0, 150);
-    treeWidget->setColumnWidth(1, 100);
+    QTreeView *threadView = m_ui.treeView_threads;
+    threadView->setModel(&m_threadListModel);
+    threadView->setColumnWidth(0, 150);
+    threadView->setColumnWidth(1, 100);
 
-    connect(m_ui.treeWidget_threads, SIGNAL(itemSelectionChanged()), this,
+    connect(threadView->selectionModel(), SIGNAL(selectionChanged(const QItemSelection&, const QItemSelection&)), this,
                 SLOT(onThreadWidgetSelectionChanged()));
 
+    connect(m_ui.checkBox_groupThreads, SIGNAL(stateChanged(int)), this, SLOT(onGroupThreadsCheckBoxStateChanged(int)));
+    m_ui.treeWidget_threadGroups->setColumnWidth(0, 80);
+    m_ui.treeWidget_threadGroups->setVisible(false);
+    connect(m_ui.treeWidget_threadGroups, SIGNAL(itemClicked(QTreeWidgetItem*, int)), this, SLOT(onThreadGroupsItemClicked(QTreeWidgetItem*, int)));
+    connect(&m_stackGroupCollector, SIGNAL(progress(int,int)), this, SLOT(onThreadGroupsProgress(int,int)));
+    connect(&m_stackGroupCollector, SIGNAL(finished()), this, SLOT(onThreadGroupsFinished()));
+
     // Stack widget
     treeWidget = m_ui.treeWidget_stack;
     names.clear();
@@ -96,6 +135,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(m_ui.treeWidget_stack, SIGNAL(itemSelectionChanged()), this,
                 SLOT(onStackWidgetSelectionChanged()));
+    connect(m_ui.treeWidget_stack->verticalScrollBar(), SIGNAL(valueChanged(int)), this,
+                SLOT(onStackWidgetScrolled(int)));
 
 
 
@@ -152,6 +193,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_ui.actionViewTargetOutput, SIGNAL(triggered()), SLOT(onViewTargetOutput()));
     connect(m_ui.actionViewGedeOutput, SIGNAL(triggered()), SLOT(onViewGedeOutput()));
     connect(m_ui.actionViewGdbOutput, SIGNAL(triggered()), SLOT(onViewGdbOutput()));
+    connect(m_ui.actionViewLogPoints, SIGNAL(triggered()), SLOT(onViewLogPoints()));
+    connect(m_ui.actionViewProfiler, SIGNAL(triggered()), SLOT(onViewProfiler()));
+    connect(m_ui.actionViewLibraries, SIGNAL(triggered()), SLOT(onViewLibraries()));
     connect(m_ui.actionViewFileBrowser, SIGNAL(triggered()), SLOT(onViewFileBrowser()));
     connect(m_ui.actionViewClassFilter, SIGNAL(triggered()), SLOT(onViewClassFilter()));
     connect(m_ui.actionViewFunctionFilter, SIGNAL(triggered()), SLOT(onViewFuncFilter()));
@@ -161,6 +205,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_ui.actionDefaultViewSetup, SIGNAL(triggered()), SLOT(onDefaultViewSetup()));
 
     connect(m_ui.actionSettings, SIGNAL(triggered()), SLOT(onSettings()));
+    connect(m_ui.actionAddSymbolIndex, SIGNAL(triggered()), SLOT(onAddSymbolIndex()));
+    connect(&m_symbolIndexGenerator, SIGNAL(finished(bool)), SLOT(onSymbolIndexFinished(bool)));
 
     
 
@@ -168,12 +214,13 @@ MainWindow::MainWindow(QWidget *parent)
     core.setListener(this);
 
     connect(&m_tagManager, SIGNAL(onAllScansDone()), SLOT(onAllTagScansDone()));
+    connect(&m_sourceWatcher, SIGNAL(filesChanged(QStringList)), SLOT(onSourceFilesModified(QStringList)));
 
-    //Setup the function treewidget
-    treeWidget = m_ui.treeWidget_functions;
-    treeWidget->setColumnWidth(0, 200);
-    connect(m_ui.treeWidget_functions, SIGNAL(itemClicked(QTreeWidgetItem * , int )),
-            SLOT(onFuncWidgetItemSelected(QTreeWidgetItem * , int )));
+    //Setup the function and class views
+    connect(&m_tagBrowserWorker, SIGNAL(resultReady(TagBrowserResult)), SLOT(onTagBrowserResult(TagBrowserResult)));
+    m_ui.treeView_functions->setModel(&m_functionListModel);
+    m_ui.treeView_functions->setColumnWidth(0, 200);
+    connect(m_ui.treeView_functions, SIGNAL(clicked(const QModelIndex &)), SLOT(onTagBrowserItemClicked(const QModelIndex &)));
 
     m_ui.lineEdit_funcFilter->setPlaceholderText("Filter1;Filter2;...");
     connect(m_ui.lineEdit_funcFilter, SIGNAL(textChanged(const QString &)), SLOT(onFuncFilter_textChanged(const QString&)));
@@ -193,11 +240,9 @@ MainWindow::MainWindow(QWidget *parent)
     m_ui.widget_search->hide();
 
     
-    //Setup the class treewidget
-    treeWidget = m_ui.treeWidget_classes;
-    treeWidget->setColumnWidth(0, 200);
-    connect(m_ui.treeWidget_classes, SIGNAL(itemClicked(QTreeWidgetItem * , int )),
-            SLOT(onFuncWidgetItemSelected(QTreeWidgetItem * , int )));
+    m_ui.treeView_classes->setModel(&m_classTreeModel);
+    m_ui.treeView_classes->setColumnWidth(0, 200);
+    connect(m_ui.treeView_classes, SIGNAL(clicked(const QModelIndex &)), SLOT(onTagBrowserItemClicked(const QModelIndex &)));
 
 
 
@@ -227,10 +272,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     m_ui.targetOutputView->setScrollBar(m_ui.verticalScrollBar_console);
 
-    connect(this, SIGNAL(newInfoMsg(QString)), SLOT(onNewInfoMsg(QString)));
-    connect(this, SIGNAL(newWarnMsg(QString)), SLOT(onNewWarnMsg(QString)));
-    connect(this, SIGNAL(newErrorMsg(QString)), SLOT(onNewErrorMsg(QString)));
-    connect(this, SIGNAL(newCritMsg(QString)), SLOT(onNewCritMsg(QString)));
+    qRegisterMetaType<QList<LogMessage> >("QList<LogMessage>");
+    connect(this, SIGNAL(newLogMessages(QList<LogMessage>)), SLOT(onNewLogMessages(QList<LogMessage>)));
 
     connect(m_ui.gdbPrompt, &QLineEdit::returnPressed, this, &MainWindow::onUserGdbCommandEntered);
 
@@ -252,10 +295,16 @@ MainWindow::~MainWindow()
  */
 void MainWindow::showWidgets()
 {
-    if(!m_cfg.m_viewFuncFilter)
+    if(!m_cfg.m_viewFuncFilter && !m_funcFilterText.isEmpty())
+    {
         m_funcFilterText.clear();
-    if(!m_cfg.m_viewClassFilter)
+        m_tagBrowserWorker.setFuncFilter(m_funcFilterText);
+    }
+    if(!m_cfg.m_viewClassFilter && !m_classFilterText.isEmpty())
+    {
         m_classFilterText.clear();
+        m_tagBrowserWorker.setClassFilter(m_classFilterText);
+    }
 
 
     m_ui.actionViewFunctionFilter->setChecked(m_cfg.m_viewFuncFilter);
@@ -265,6 +314,11 @@ void MainWindow::showWidgets()
     QWidget *currentSelection = m_ui.tabWidget->currentWidget();
     m_ui.tabWidget->clear();
 
+//
+    QTreeWidget *librariesWidget = m_ui.treeWidget_libraries;
+    if(m_cfg.m_viewWindowLibraries)
+        m_ui.tabWidget->insertTab(0, librariesWidget, "Libraries");
+
 //
     QTreeWidget *stackWidget = m_ui.treeWidget_stack;
     if(m_cfg.m_viewWindowStack)
@@ -276,7 +330,7 @@ void MainWindow::showWidgets()
         m_ui.tabWidget->insertTab(0, breakpointsWidget, "Breakpoints");
 
 //
-    QTreeWidget *threadsWidget = m_ui.treeWidget_threads;
+    QWidget *threadsWidget = m_ui.tab_threads;
     if(m_cfg.m_viewWindowThreads)
         m_ui.tabWidget->insertTab(0, threadsWidget, "Threads");
 
@@ -306,6 +360,10 @@ void MainWindow::showWidgets()
 
     currentSelection = m_ui.tabWidget_2->currentWidget();
     m_ui.tabWidget_2->clear();
+    if(m_cfg.m_viewWindowProfiler)
+        m_ui.tabWidget_2->insertTab(0, m_ui.tab_profiler, "Profiler");
+    if(m_cfg.m_viewWindowLogPoints)
+        m_ui.tabWidget_2->insertTab(0, m_ui.logPointView, "Log Points");
     if(m_cfg.m_viewWindowTargetOutput)
         m_ui.tabWidget_2->insertTab(0, m_ui.widget_console, "Target Console");
     if(m_cfg.m_viewWindowGedeOutput)
@@ -329,10 +387,13 @@ void MainWindow::onDefaultViewSetup()
     m_cfg.m_viewWindowStack = true;
     m_cfg.m_viewWindowBreakpoints = true;
     m_cfg.m_viewWindowThreads = true;
+    m_cfg.m_viewWindowLibraries = true;
     m_cfg.m_viewWindowWatch = true;
     m_cfg.m_viewWindowAutoVariables = true;
     m_cfg.m_viewWindowTargetOutput = true;
     m_cfg.m_viewWindowGdbOutput = true;
+    m_cfg.m_viewWindowLogPoints = true;
+    m_cfg.m_viewWindowProfiler = true;
     m_cfg.m_viewWindowFileBrowser = true;
     m_cfg.m_viewFuncFilter = true;
     m_cfg.m_viewClassFilter = true;
@@ -348,12 +409,15 @@ void MainWindow::onDefaultViewSetup()
 
     m_ui.actionViewStack->setChecked(m_cfg.m_viewWindowStack);
     m_ui.actionViewThreads->setChecked(m_cfg.m_viewWindowThreads);
+    m_ui.actionViewLibraries->setChecked(m_cfg.m_viewWindowLibraries);
     m_ui.actionViewBreakpoints->setChecked(m_cfg.m_viewWindowBreakpoints);
     m_ui.actionViewWatch->setChecked(m_cfg.m_viewWindowWatch);
     m_ui.actionViewAutoVariables->setChecked(m_cfg.m_viewWindowAutoVariables);
     m_ui.actionViewTargetOutput->setChecked(m_cfg.m_viewWindowTargetOutput);
     m_ui.actionViewGedeOutput->setChecked(m_cfg.m_viewWindowGedeOutput);
     m_ui.actionViewGdbOutput->setChecked(m_cfg.m_viewWindowGdbOutput);
+    m_ui.actionViewLogPoints->setChecked(m_cfg.m_viewWindowLogPoints);
+    m_ui.actionViewProfiler->setChecked(m_cfg.m_viewWindowProfiler);
     m_ui.actionViewFileBrowser->setChecked(m_cfg.m_viewWindowFileBrowser);
     m_ui.actionViewFunctionFilter->setChecked(m_cfg.m_viewFuncFilter);
     m_ui.actionViewClassFilter->setChecked(m_cfg.m_viewClassFilter);
@@ -439,6 +503,27 @@ void MainWindow::onViewGdbOutput()
     showWidgets();
 }
 
+void MainWindow::onViewLogPoints()
+{
+    m_cfg.m_viewWindowLogPoints = m_cfg.m_viewWindowLogPoints ? false : true;
+
+    showWidgets();
+}
+
+void MainWindow::onViewProfiler()
+{
+    m_cfg.m_viewWindowProfiler = m_cfg.m_viewWindowProfiler ? false : true;
+
+    showWidgets();
+}
+
+void MainWindow::onViewLibraries()
+{
+    m_cfg.m_viewWindowLibraries = m_cfg.m_viewWindowLibraries ? false : true;
+
+    showWidgets();
+}
+
 void MainWindow::onViewFileBrowser()
 {
     m_cfg.m_viewWindowFileBrowser = m_cfg.m_viewWindowFileBrowser ? false : true;
@@ -475,12 +560,15 @@ void MainWindow::loadConfig()
 
     m_ui.actionViewStack->setChecked(m_cfg.m_viewWindowStack);
     m_ui.actionViewThreads->setChecked(m_cfg.m_viewWindowThreads);
+    m_ui.actionViewLibraries->setChecked(m_cfg.m_viewWindowLibraries);
     m_ui.actionViewBreakpoints->setChecked(m_cfg.m_viewWindowBreakpoints);
     m_ui.actionViewWatch->setChecked(m_cfg.m_viewWindowWatch);
     m_ui.actionViewAutoVariables->setChecked(m_cfg.m_viewWindowAutoVariables);
     m_ui.actionViewTargetOutput->setChecked(m_cfg.m_viewWindowTargetOutput);
     m_ui.actionViewGedeOutput->setChecked(m_cfg.m_viewWindowGedeOutput);
     m_ui.actionViewGdbOutput->setChecked(m_cfg.m_viewWindowGdbOutput);
+    m_ui.actionViewLogPoints->setChecked(m_cfg.m_viewWindowLogPoints);
+    m_ui.actionViewProfiler->setChecked(m_cfg.m_viewWindowProfiler);
     m_ui.actionViewFileBrowser->setChecked(m_cfg.m_viewWindowFileBrowser);
     m_ui.actionViewFunctionFilter->setChecked(m_cfg.m_viewFuncFilter);
     m_ui.actionViewClassFilter->setChecked(m_cfg.m_viewClassFilter);
@@ -503,6 +591,29 @@ void MainWindow::showEvent(QShowEvent* e)
 
 }
 
+void MainWindow::paintEvent(QPaintEvent *e)
+{
+    QMainWindow::paintEvent(e);
+
+    if(!m_firstPaintDone)
+    {
+        m_firstPaintDone = true;
+        TraceLog::getInstance().addInstant("startup", "First paint");
+        checkStartupDone();
+    }
+}
+
+
+/**
+ * @brief Writes the startup trace when the window has been painted and the tags are scanned.
+ */
+void MainWindow::checkStartupDone()
+{
+    if(m_firstPaintDone && m_firstTagScanDone)
+        TraceLog::getInstance().save();
+}
+
+
 void MainWindow::closeEvent(QCloseEvent *e)
 {
     Q_UNUSED(e);
@@ -747,6 +858,7 @@ void MainWindow::insertSourceFiles()
             }
         }
     }
+    m_locator.updateFileIndex();
 
     
 
@@ -757,7 +869,16 @@ void MainWindow::insertSourceFiles()
         FileInfo &info = m_sourceFiles[i];
         queueList += info.m_fullName;
     }
+    m_tagScanTraceStart = TraceLog::getInstance().getTimestamp();
     m_tagManager.queueScan(queueList);
+    m_sourceWatcher.setFiles(queueList);
+
+    // The program may have been reloaded
+    for(int tabIdx = 0;tabIdx <  m_ui.editorTabWidget->count();tabIdx++)
+    {
+        CodeViewTab* codeViewTab = (CodeViewTab* )m_ui.editorTabWidget->widget(tabIdx);
+        codeViewTab->setCodeLines(core.getCodeLines(codeViewTab->getFilePath()));
+    }
 
     
     for(int i = 0;i < m_sourceFiles.size();i++)
@@ -831,20 +952,167 @@ void MainWindow::ICore_onWatchVarChildAdded(VarWatch &watch)
 }
 
 
-void MainWindow::ICore_onSourceFileChanged(QString filename)
+/**
+ * @brief Called when source files has been modified on disk.
+ */
+void MainWindow::onSourceFilesModified(QStringList filePathList)
 {
-    CodeViewTab* codeViewTab = findTab(filename);
-    if(codeViewTab)
-    {
-        // Get the tags in the file
-        QList<Tag> tagList;
-        m_tagManager.scan(filename, &tagList);
+    m_tagManager.invalidate(filePathList);
 
-        // Open the file
-        if(codeViewTab->open(filename,tagList))
+    // Reload the opened files directly
+    for(int i = 0;i < filePathList.size();i++)
+    {
+        QString filePath = filePathList[i];
+        CodeViewTab* codeViewTab = findTab(filePath);
+        if(codeViewTab)
         {
+            QList<Tag> tagList;
+            m_tagManager.scan(filePath, &tagList);
+            codeViewTab->reload(tagList);
         }
     }
+
+    // Tag the rest in the background
+    m_tagManager.queueScan(filePathList);
+}
+
+
+void MainWindow::ICore_onLibrariesChanged()
+{
+    // Libraries are often loaded a few hundred at a time
+    if(!m_librariesUpdateTimer.isActive())
+        m_librariesUpdateTimer.start();
+}
+
+
+/**
+ * @brief Reports the time to the first stop and compares it with the last session.
+ */
+void MainWindow::ICore_onReady(int readyTime)
+{
+    QString programPath = m_cfg.getProgramPath();
+    QString indexSection;
+    if(!programPath.isEmpty())
+        indexSection = SymbolIndexGenerator::getIndexSection(programPath);
+
+    QString details = QString("symbol index: %1, index cache: %2")
+                        .arg(indexSection.isEmpty() ? "none" : indexSection)
+                        .arg(m_cfg.m_gdbIndexCache ? "on" : "off");
+    if(m_cfg.m_lastReadyTime > 0)
+        infoMsg("Ready in %d ms (last session: %d ms, %s)", readyTime, m_cfg.m_lastReadyTime, stringToCStr(details));
+    else
+        infoMsg("Ready in %d ms (%s)", readyTime, stringToCStr(details));
+
+    m_cfg.m_lastReadyTime = readyTime;
+}
+
+
+void MainWindow::onAddSymbolIndex()
+{
+    QString programPath = m_cfg.getProgramPath();
+    if(programPath.isEmpty())
+    {
+        warnMsg("No program to add a symbol index to");
+        return;
+    }
+
+    if(m_symbolIndexGenerator.start(m_cfg.m_gdbPath, programPath) == 0)
+        m_ui.actionAddSymbolIndex->setEnabled(false);
+}
+
+
+void MainWindow::onSymbolIndexFinished(bool success)
+{
+    Q_UNUSED(success);
+    m_ui.actionAddSymbolIndex->setEnabled(true);
+}
+
+
+void MainWindow::onLibrariesUpdateTimeout()
+{
+    Core &core = Core::getInstance();
+    QList<SharedLibrary> libs = core.getLibraries();
+    QTreeWidget *libWidget = m_ui.treeWidget_libraries;
+
+    QString selectedId;
+    if(libWidget->currentItem())
+        selectedId = libWidget->currentItem()->data(0, Qt::UserRole).toString();
+
+    libWidget->clear();
+    QList<QTreeWidgetItem *> items;
+    for(int i = 0;i < libs.size();i++)
+    {
+        const SharedLibrary &lib = libs[i];
+        QString path = lib.m_hostName.isEmpty() ? lib.m_id : lib.m_hostName;
+
+        QTreeWidgetItem *item = new QTreeWidgetItem;
+        item->setText(0, getFilenamePart(path));
+        item->setToolTip(0, path);
+        item->setText(1, lib.m_symbolsLoaded ? "Loaded" : "Deferred");
+        if(lib.m_fromAddr != 0)
+            item->setText(2, longLongToHexString(lib.m_fromAddr));
+        item->setData(0, Qt::UserRole, lib.m_id);
+        items.append(item);
+    }
+    libWidget->addTopLevelItems(items);
+
+    for(int i = 0;i < items.size() && !selectedId.isEmpty();i++)
+    {
+        if(items[i]->data(0, Qt::UserRole).toString() == selectedId)
+            libWidget->setCurrentItem(items[i]);
+    }
+}
+
+
+void MainWindow::onLibrariesWidgetItemDoubleClicked(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column);
+    Core &core = Core::getInstance();
+
+    QString libId = item->data(0, Qt::UserRole).toString();
+    core.gdbLoadLibrarySymbols(libId);
+}
+
+
+void MainWindow::onLibrariesWidgetContextMenu(const QPoint& pos)
+{
+    QAction *action;
+    Core &core = Core::getInstance();
+
+    QPoint popupPos = m_ui.treeWidget_libraries->mapToGlobal(pos);
+
+    m_popupMenu.clear();
+
+    action = m_popupMenu.addAction("Load symbols");
+    action->setEnabled(!m_ui.treeWidget_libraries->selectedItems().isEmpty());
+    connect(action, SIGNAL(triggered()), this, SLOT(onLibrariesLoadSelected()));
+
+    action = m_popupMenu.addAction("Load all symbols");
+    action->setEnabled(core.isLazySharedLibs());
+    connect(action, SIGNAL(triggered()), this, SLOT(onLibrariesLoadAll()));
+
+    m_popupMenu.popup(popupPos);
+}
+
+
+void MainWindow::onLibrariesLoadSelected()
+{
+    Core &core = Core::getInstance();
+
+    QStringList libIds;
+    QList<QTreeWidgetItem *> selectedItems = m_ui.treeWidget_libraries->selectedItems();
+    for(int i = 0;i < selectedItems.size();i++)
+        libIds.append(selectedItems[i]->data(0, Qt::UserRole).toString());
+
+    for(int i = 0;i < libIds.size();i++)
+        core.gdbLoadLibrarySymbols(libIds[i]);
+}
+
+
+void MainWindow::onLibrariesLoadAll()
+{
+    Core &core = Core::getInstance();
+    core.gdbLoadLibrarySymbols("");
 }
 
 
@@ -913,31 +1181,123 @@ void MainWindow::onNewInfoMsg(QString msg)
     m_ui.gedeOutputWidget->append(text);
 }
 
-void MainWindow::ILogger_onWarnMsg(QString text)
+/**
+ * @brief Called with a batch of log messages (from any thread).
+ */
+void MainWindow::ILogger_onMessages(const QList<LogMessage> &msgList)
 {
-    emit newWarnMsg(text);
+    emit newLogMessages(msgList);
+}
+
+void MainWindow::onNewLogMessages(QList<LogMessage> msgList)
+{
+    for(int i = 0;i < msgList.size();i++)
+    {
+        const LogMessage &msg = msgList[i];
+        if(msg.m_level == LOG_LEVEL_CRIT)
+            onNewCritMsg(msg.m_text);
+        else if(msg.m_level == LOG_LEVEL_ERROR)
+            onNewErrorMsg(msg.m_text);
+        else if(msg.m_level == LOG_LEVEL_WARN)
+            onNewWarnMsg(msg.m_text);
+        else
+            onNewInfoMsg(msg.m_text);
+    }
 }
 
 
-void MainWindow::ILogger_onErrorMsg(QString text)
+void MainWindow::ICore_onConsoleStream(QString text)
 {
-    emit newErrorMsg(text);
+    m_ui.logView->appendPlainText(text);
 }
 
-void MainWindow::ILogger_onCriticalMsg(QString text)
+
+/**
+ * @brief Called for each message printed by a log point.
+ *
+ * A log point in a loop can print thousands of messages per second,
+ * so the messages are added to the window in batches.
+ */
+void MainWindow::ICore_onLogPointOutput(QString text)
+{
+    m_logPointPending.append(text);
+    if(m_logPointPending.size() > LOGPOINT_MAX_LINES)
+        m_logPointPending.removeFirst();
+
+    if(!m_logPointFlushTimer.isActive())
+        m_logPointFlushTimer.start();
+}
+
+
+void MainWindow::onLogPointFlushTimeout()
 {
-    emit newCritMsg(text);
+    if(m_logPointPending.isEmpty())
+        return;
+
+    m_ui.logPointView->appendPlainText(m_logPointPending.join("\n"));
+    m_logPointPending.clear();
 }
 
-void MainWindow::ILogger_onInfoMsg(QString text)
+
+void MainWindow::ICore_onSampleStopped()
 {
-    emit newInfoMsg(text);
+    m_profiler.onSampleStopped();
 }
 
 
-void MainWindow::ICore_onConsoleStream(QString text)
+void MainWindow::onProfilerSampleToggled(bool checked)
 {
-    m_ui.logView->appendPlainText(text);
+    Core &core = Core::getInstance();
+
+    if(!checked)
+    {
+        m_profiler.stop();
+        return;
+    }
+
+    // The threads can not be interrupted all at once in non-stop mode
+    if(core.isNonStop())
+    {
+        warnMsg("Sampling is not supported in non-stop mode");
+        m_ui.pushButton_profilerSample->setChecked(false);
+        return;
+    }
+    m_profiler.start();
+}
+
+
+void MainWindow::onProfilerClear()
+{
+    m_profiler.clear();
+    m_ui.flameGraph->setProfile(&m_profiler.getProfile());
+}
+
+
+/**
+ * @brief Called periodically while sampling with the new samples.
+ */
+void MainWindow::onProfilerUpdated()
+{
+    const SampleProfile &profile = m_profiler.getProfile();
+
+    if(profile.getSampleCount() == 0)
+        m_ui.label_profilerStatus->setText("No samples");
+    else
+        m_ui.label_profilerStatus->setText(QString("%1 samples, %2 backtraces").arg(profile.getSampleCount()).arg(profile.getStackCount()));
+
+    m_ui.flameGraph->updateProfile();
+
+    for(int tabIdx = 0;tabIdx <  m_ui.editorTabWidget->count();tabIdx++)
+    {
+        CodeViewTab* codeViewTab = (CodeViewTab* )m_ui.editorTabWidget->widget(tabIdx);
+        codeViewTab->setLineHits(profile.getLineHits(codeViewTab->getFilePath()));
+    }
+}
+
+
+void MainWindow::onFlameGraphFunctionClicked(QString path, int lineNo)
+{
+    open(path, lineNo);
 }
 
 void MainWindow::ICore_onMessage(QString message)
@@ -960,13 +1320,11 @@ void
 MainWindow::onThreadWidgetSelectionChanged( )
 {
     // Get the new selected thread
-    QTreeWidget *threadWidget = m_ui.treeWidget_threads;
-    QList <QTreeWidgetItem *> selectedItems = threadWidget->selectedItems();
-    if(selectedItems.size() > 0)
+    QTreeView *threadView = m_ui.treeView_threads;
+    QModelIndexList selectedRows = threadView->selectionModel()->selectedRows();
+    if(selectedRows.size() > 0)
     {
-        QTreeWidgetItem * currentItem;
-        currentItem = selectedItems[0];
-        int selectedThreadId = currentItem->data(0, Qt::UserRole).toInt();
+        int selectedThreadId = m_threadListModel.getThreadId(selectedRows[0].row());
 
         // Select the thread
         Core &core = Core::getInstance();
@@ -988,7 +1346,11 @@ void MainWindow::onStackWidgetSelectionChanged()
         currentItem = selectedItems[0];
         selectedFrame = currentItem->data(0, Qt::UserRole).toInt();
 
-        core.selectFrame(selectedFrame);
+        // The "more frames" item?
+        if(selectedFrame < 0)
+            core.getMoreStackFrames();
+        else
+            core.selectFrame(selectedFrame);
     }
 }
 
@@ -1218,6 +1580,9 @@ CodeViewTab* MainWindow::open(QString filename)
             return NULL;
         }
 
+        codeViewTab->setLineHits(m_profiler.getProfile().getLineHits(filename));
+        codeViewTab->setCodeLines(Core::getInstance().getCodeLines(filename));
+
         // Add the new codeview tab
         m_ui.editorTabWidget->addTab(codeViewTab, getFilenamePart(filename));
         m_ui.editorTabWidget->setCurrentIndex(m_ui.editorTabWidget->count()-1);
@@ -1390,9 +1755,11 @@ void MainWindow::onRestart()
 
     m_ui.targetOutputView->clearAll();
 
+    // The source files that are too many to be watched are checked at each restart
+    m_sourceWatcher.checkUnwatched();
+
     // Was the program modified since last time?
-    QDateTime modTime = QFileInfo(m_cfg.getProgramPath()).lastModified();
-    if(modTime > core.getTimeStarted())
+    if(core.isProgramChanged(m_cfg.getProgramPath()))
     {
         // Ask the user what to do
         QMessageBox msgBox;
@@ -1409,6 +1776,8 @@ void MainWindow::onRestart()
         else
             core.gdbRun();
     }
+    else if(m_cfg.m_connectionMode == MODE_PID || m_cfg.m_connectionMode == MODE_COREDUMP)
+        core.gdbReload(m_cfg);
     else
         core.gdbRun();
 }
@@ -1439,55 +1808,146 @@ void MainWindow::onStepOut()
 
 
 void MainWindow::ICore_onThreadListChanged()
+{
+    m_threadListModel.reload();
+    updateThreadGroups();
+}
+
+
+void MainWindow::ICore_onThreadCreated(int threadId)
+{
+    m_threadListModel.addThread(threadId);
+}
+
+
+void MainWindow::ICore_onThreadExited(int threadId)
+{
+    m_threadListModel.removeThread(threadId);
+}
+
+
+void MainWindow::ICore_onThreadDetailsChanged(int threadId)
+{
+    m_threadListModel.updateThread(threadId);
+}
+
+
+void MainWindow::ICore_onThreadDetailsInvalidated()
+{
+    m_threadListModel.invalidateDetails();
+    updateThreadGroups();
+}
+
+
+/**
+ * @brief Starts to regroup the threads by their stacks if the group view is shown.
+ */
+void MainWindow::updateThreadGroups()
 {
     Core &core = Core::getInstance();
 
-    QTreeWidget *threadWidget = m_ui.treeWidget_threads;
-    threadWidget->clear();
+    if(m_ui.checkBox_groupThreads->checkState() != Qt::Checked)
+        return;
+    if(core.isRunning())
+        return;
 
-    QList<ThreadInfo> list = core.getThreadList();
-    
-    for(int idx = 0;idx < list.size();idx++)
-    {
-        // Get name
-        QString name = list[idx].m_name;
-        QString desc = list[idx].m_details;
-        
+    m_stackGroupCollector.abort();
+    m_stackGroupCollector.start();
+}
 
-        // Add the item
-        QStringList names;
-        names.push_back(name);
-        names.push_back(desc);
-        QTreeWidgetItem *item = new QTreeWidgetItem(names);
-        item->setData(0, Qt::UserRole, list[idx].m_id);
-        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        threadWidget->insertTopLevelItem(0, item);
 
+void MainWindow::onGroupThreadsCheckBoxStateChanged(int state)
+{
+    bool showGroups = state == Qt::Checked ? true : false;
+
+    m_ui.treeView_threads->setVisible(!showGroups);
+    m_ui.treeWidget_threadGroups->setVisible(showGroups);
+
+    if(showGroups)
+        updateThreadGroups();
+    else
+    {
+        m_stackGroupCollector.abort();
+        m_ui.treeWidget_threadGroups->clear();
     }
 }
 
 
-void MainWindow::ICore_onCurrentThreadChanged(int threadId)
+void MainWindow::onThreadGroupsProgress(int doneCount, int totalCount)
 {
-    QTreeWidget *threadWidget = m_ui.treeWidget_threads;
-    QTreeWidgetItem *rootItem = threadWidget->invisibleRootItem();
-    threadWidget->clearSelection();
-    QTreeWidgetItem *selectItem = NULL;
-    for(int i = 0;i < rootItem->childCount();i++)
+    m_ui.checkBox_groupThreads->setText(QString("Group by unique stacks (%1/%2)").arg(doneCount).arg(totalCount));
+}
+
+
+void MainWindow::onThreadGroupsFinished()
+{
+    QTreeWidget *groupWidget = m_ui.treeWidget_threadGroups;
+    QList<StackGroup*> groups = m_stackGroupCollector.getGroups();
+
+    m_ui.checkBox_groupThreads->setText("Group by unique stacks");
+
+    groupWidget->clear();
+    for(int i = 0;i < groups.size();i++)
     {
-        QTreeWidgetItem *item = rootItem->child(i);
-        assert(item != NULL);
-        if(item)
+        const StackGroup *group = groups[i];
+
+        // Show the innermost frame in the group row
+        QString topFrame;
+        if(!group->m_frames.isEmpty())
         {
-            int id = item->data(0, Qt::UserRole).toInt();
-            if(id == threadId)
-            {
-                selectItem = item;
-            }
+            const StackFrameEntry &entry = group->m_frames.last();
+            topFrame = entry.m_functionName + "()";
+        }
+
+        QStringList threadIdTexts;
+        for(int j = 0;j < group->m_threadIds.size() && j < 32;j++)
+            threadIdTexts += QString::number(group->m_threadIds[j]);
+        if(group->m_threadIds.size() > 32)
+            threadIdTexts += "...";
+
+        QTreeWidgetItem *groupItem = new QTreeWidgetItem;
+        groupItem->setText(0, QString::number(group->m_threadIds.size()));
+        groupItem->setText(1, topFrame);
+        groupItem->setToolTip(0, "Threads: " + threadIdTexts.join(", "));
+        groupItem->setData(0, Qt::UserRole, group->m_threadIds[0]);
+        groupWidget->addTopLevelItem(groupItem);
+
+        for(int j = group->m_frames.size()-1;j >= 0;j--)
+        {
+            const StackFrameEntry &entry = group->m_frames[j];
+            QTreeWidgetItem *frameItem = new QTreeWidgetItem;
+            frameItem->setText(1, QString("%1() %2:%3").arg(entry.m_functionName).arg(getFilenamePart(entry.m_sourcePath)).arg(entry.m_line));
+            frameItem->setData(0, Qt::UserRole, group->m_threadIds[0]);
+            groupItem->addChild(frameItem);
         }
     }
-    if(selectItem)
-        threadWidget->setCurrentItem(selectItem);
+}
+
+
+/**
+ * @brief Selects the first thread of the group that was clicked.
+ */
+void MainWindow::onThreadGroupsItemClicked(QTreeWidgetItem *item, int column)
+{
+    Q_UNUSED(column);
+    Core &core = Core::getInstance();
+
+    int threadId = item->data(0, Qt::UserRole).toInt();
+    core.selectThread(threadId);
+}
+
+
+void MainWindow::ICore_onCurrentThreadChanged(int threadId)
+{
+    QTreeView *threadView = m_ui.treeView_threads;
+    int row = m_threadListModel.findRow(threadId);
+    if(row == -1)
+        return;
+    QModelIndex idx = m_threadListModel.index(row, 0);
+    if(threadView->currentIndex() == idx)
+        return;
+    threadView->selectionModel()->setCurrentIndex(idx,
+            QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
 }
 
 
@@ -1499,17 +1959,30 @@ void MainWindow::ICore_onBreakpointsChanged()
     QList<BreakPoint*>  bklist = core.getBreakPoints();
     
 
-    // Update the settings
-    m_cfg.m_breakpoints.clear();
+    // Update the settings (only saved if the non log point breakpoints changed)
+    QList<SettingsBreakpoint> cfgBreakpoints;
     for(int u = 0;u < bklist.size();u++)
     {
         BreakPoint* bkpt = bklist[u];
+        if(bkpt->m_isLogPoint)
+            continue;
         SettingsBreakpoint bkptCfg;
         bkptCfg.m_filename = bkpt->m_fullname;
         bkptCfg.m_lineNo = bkpt->m_lineNo;
-        m_cfg.m_breakpoints.push_back(bkptCfg);
+        cfgBreakpoints.push_back(bkptCfg);
+    }
+    bool cfgChanged = (cfgBreakpoints.size() != m_cfg.m_breakpoints.size());
+    for(int u = 0;!cfgChanged && u < cfgBreakpoints.size();u++)
+    {
+        if(cfgBreakpoints[u].m_filename != m_cfg.m_breakpoints[u].m_filename ||
+            cfgBreakpoints[u].m_lineNo != m_cfg.m_breakpoints[u].m_lineNo)
+            cfgChanged = true;
+    }
+    if(cfgChanged)
+    {
+        m_cfg.m_breakpoints = cfgBreakpoints;
+        m_cfg.save();
     }
-    m_cfg.save();
     
 
     // Update the breakpoint list widget
@@ -1564,8 +2037,52 @@ void MainWindow::ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList)
     
     stackWidget->clear();
 
+    insertStackFrameItems(stackFrameList, 0);
+}
+
+
+/**
+ * @brief Older frames has been fetched (added at the top of the stack widget).
+ */
+void MainWindow::ICore_onStackFramesLoaded(QList<StackFrameEntry> stackFrameList)
+{
+    QTreeWidget *stackWidget = m_ui.treeWidget_stack;
+
+    int firstFrameIdx = m_stackFrameList.size();
+    m_stackFrameList = stackFrameList + m_stackFrameList;
+
+    // Keep the frames that were shown in place
+    QTreeWidgetItem *rootItem = stackWidget->invisibleRootItem();
+    QTreeWidgetItem *topItem = NULL;
+    for(int i = 0;i < rootItem->childCount() && topItem == NULL;i++)
+    {
+        QTreeWidgetItem *item = rootItem->child(i);
+        if(item->data(0, Qt::UserRole).toInt() >= 0)
+            topItem = item;
+    }
+
+    insertStackFrameItems(stackFrameList, firstFrameIdx);
+
+    if(topItem)
+        stackWidget->scrollToItem(topItem, QAbstractItemView::PositionAtTop);
+}
+
+
+/**
+ * @brief Adds frames at the top of the stack widget.
+ * @param stackFrameList   The frames (oldest first).
+ * @param firstFrameIdx    The frame index of the newest frame in the list.
+ */
+void MainWindow::insertStackFrameItems(QList<StackFrameEntry> stackFrameList, int firstFrameIdx)
+{
+    Core &core = Core::getInstance();
+    QTreeWidget *stackWidget = m_ui.treeWidget_stack;
+
+    // Remove the old "more frames" item
+    QTreeWidgetItem *rootItem = stackWidget->invisibleRootItem();
+    if(rootItem->childCount() > 0 && rootItem->child(0)->data(0, Qt::UserRole).toInt() < 0)
+        delete stackWidget->takeTopLevelItem(0);
 
-    
     for(int idx = 0;idx < stackFrameList.size();idx++)
     {
         // Get name
@@ -1579,7 +2096,7 @@ void MainWindow::ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList)
         QTreeWidgetItem *item = new QTreeWidgetItem(names);
 
         
-        item->setData(0, Qt::UserRole, idx);
+        item->setData(0, Qt::UserRole, firstFrameIdx+idx);
         item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
 
         // Add the item to the widget
@@ -1587,7 +2104,33 @@ void MainWindow::ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList)
 
 
     }
-    
+
+    // Not all frames fetched?
+    QString moreText;
+    if(core.getLoadedStackFrameCount() < core.getStackDepth())
+        moreText = QString("<%1 more frames>").arg(core.getStackDepth()-core.getLoadedStackFrameCount());
+    else if(core.isStackDepthCapped())
+        moreText = QString("<stack truncated at %1 frames>").arg(core.getStackDepth());
+    if(!moreText.isEmpty())
+    {
+        QTreeWidgetItem *item = new QTreeWidgetItem(QStringList(moreText));
+        item->setData(0, Qt::UserRole, -1);
+        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+        stackWidget->insertTopLevelItem(0, item);
+    }
+}
+
+
+/**
+ * @brief Fetches older frames when the top of the stack widget is scrolled into view.
+ */
+void MainWindow::onStackWidgetScrolled(int value)
+{
+    Core &core = Core::getInstance();
+    QScrollBar *scrollBar = m_ui.treeWidget_stack->verticalScrollBar();
+
+    if(value == scrollBar->minimum() && scrollBar->maximum() > scrollBar->minimum())
+        core.getMoreStackFrames();
 }
 
 
@@ -1716,13 +2259,12 @@ void MainWindow::ICodeView_onContextMenu(QPoint pos, int lineNo, QStringList tex
         {
             FileInfo& fileInfo = m_sourceFiles[i];
 
-            QList<Tag> tagList;
-            m_tagManager.getTags(fileInfo.m_fullName, &tagList);
+            const QList<Tag> &tagList = m_tagManager.getTagList(fileInfo.m_fullName);
 
             // Loop through all the tags
             for(int j = 0;j < tagList.size();j++)
             {
-                Tag &tagInfo = tagList[j];
+                const Tag &tagInfo = tagList[j];
                 QString tagName = tagInfo.m_name;
 
                 // Tag match?
@@ -1778,6 +2320,11 @@ void MainWindow::ICodeView_onContextMenu(QPoint pos, int lineNo, QStringList tex
     action->setData(lineNo);
     connect(action, SIGNAL(triggered()), this, SLOT(onCodeViewContextMenuToggleBreakpoint()));
 
+    title = QString::asprintf("Add log point at L%d...", lineNo);
+    action = m_popupMenu.addAction(title);
+    action->setData(lineNo);
+    connect(action, SIGNAL(triggered()), this, SLOT(onCodeViewContextMenuAddLogPoint()));
+
     action = m_popupMenu.addSeparator();
 
     // Add to the menu
@@ -1843,6 +2390,79 @@ void MainWindow::onCodeViewContextMenuToggleBreakpoint()
 }
 
 
+/**
+ * @brief Splits the text entered for a log point into the format and the arguments.
+ * @param text   Text in the form '"x=%d y=%d", x, y' or just 'Hello'.
+ */
+static void parseLogPointText(QString text, QString *format, QStringList *args)
+{
+    text = text.trimmed();
+    args->clear();
+    if(!text.startsWith('"'))
+    {
+        *format = text;
+        return;
+    }
+
+    // Find the end of the format string
+    int pos = 1;
+    while(pos < text.size() && text[pos] != '"')
+    {
+        if(text[pos] == '\\')
+            pos++;
+        pos++;
+    }
+    *format = text.mid(1, pos-1);
+
+    // Split the arguments on the commas that are not inside parentheses
+    QString arg;
+    int depth = 0;
+    for(pos = pos+1;pos < text.size();pos++)
+    {
+        QChar c = text[pos];
+        if(c == ',' && depth == 0)
+        {
+            if(!arg.trimmed().isEmpty())
+                args->append(arg.trimmed());
+            arg.clear();
+            continue;
+        }
+        if(c == '(' || c == '[')
+            depth++;
+        else if(c == ')' || c == ']')
+            depth--;
+        arg += c;
+    }
+    if(!arg.trimmed().isEmpty())
+        args->append(arg.trimmed());
+}
+
+
+void MainWindow::onCodeViewContextMenuAddLogPoint()
+{
+    QAction *action = static_cast<QAction *>(sender ());
+    int lineNo = action->data().toInt();
+    Core &core = Core::getInstance();
+
+    CodeViewTab* currentCodeViewTab = currentTab();
+    if(!currentCodeViewTab)
+        return;
+
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "Add log point",
+                        QString::asprintf("Message to print when L%d is reached (\"format\", args...):", lineNo),
+                        QLineEdit::Normal, "\"\"", &ok);
+    if(!ok || text.trimmed().isEmpty())
+        return;
+
+    QString format;
+    QStringList args;
+    parseLogPointText(text, &format, &args);
+
+    core.gdbSetLogPoint(currentCodeViewTab->getFilePath(), lineNo, format, args);
+}
+
+
 void MainWindow::onCodeViewContextMenuShowCurrentLocation()
 {
     // Open file
@@ -1973,12 +2593,15 @@ void MainWindow::setConfig()
 
     m_gedeOutputFont = QFont(m_cfg.m_gedeOutputFontFamily, m_cfg.m_gedeOutputFontSize);
     m_ui.gedeOutputWidget->setFont(m_gedeOutputFont);
+    m_ui.logPointView->setFont(m_gdbOutputFont);
 
     m_outputFont = QFont(m_cfg.m_outputFontFamily, m_cfg.m_outputFontSize);
     m_ui.targetOutputView->setMonoFont(m_outputFont);
     
     m_autoVarCtl.setConfig(&m_cfg);
 
+    m_profiler.setConfig(&m_cfg);
+
     m_tagManager.setConfig(m_cfg);
 }
 
@@ -2057,6 +2680,7 @@ void MainWindow::ICore_onStateChanged(TargetState state)
     if(state == TARGET_STARTING || state == TARGET_RUNNING)
     {
         m_ui.treeWidget_stack->clear();
+        m_stackGroupCollector.abort();
     }
     m_autoVarCtl.ICore_onStateChanged(state);
 }
@@ -2262,25 +2886,8 @@ void MainWindow::onFuncFilterClear()
 
 void MainWindow::onFuncFilter_textChanged(const QString &text)
 {
-    // Create the search list
-    m_funcFilterText.clear();
-    QStringList list = text.split(";");
-    for(int i = 0;i < list.size();i++)
-    {
-        QString item = list[i].trimmed();
-        if(!item.isEmpty())
-        {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-            QRegularExpression rx(QRegularExpression::wildcardToRegularExpression(item));
-#else
-            QRegExp rx(item);
-            rx.setPatternSyntax(QRegExp::Wildcard);
-#endif
-            m_funcFilterText.append(rx);
-        }
-    }
-    
-    fillInFuncList();
+    m_funcFilterText = text;
+    m_tagBrowserWorker.setFuncFilter(m_funcFilterText);
 }
 
 
@@ -2312,25 +2919,8 @@ void MainWindow::onClassFilterClear()
 
 void MainWindow::onClassFilter_textChanged(const QString &text)
 {
-    // Create the search list
-    m_classFilterText.clear();
-    QStringList list = text.split(";");
-    for(int i = 0;i < list.size();i++)
-    {
-        QString item = list[i].trimmed();
-        if(!item.isEmpty())
-        {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-            QRegularExpression rx(QRegularExpression::wildcardToRegularExpression(item));
-#else
-            QRegExp rx(item);
-            rx.setPatternSyntax(QRegExp::Wildcard);
-#endif
-            m_classFilterText.append(rx);
-        }
-    }
-    
-    fillInClassList();
+    m_classFilterText = text;
+    m_tagBrowserWorker.setClassFilter(m_classFilterText);
 }
 
 void MainWindow::onIncSearch_textChanged(const QString &text)
@@ -2353,174 +2943,52 @@ void MainWindow::onIncSearch_textChanged(const QString &text)
  */
 void MainWindow::onAllTagScansDone()
 {
-    // Get all tags
-    m_tagList.clear();
-    for(int k = 0;k < m_sourceFiles.size();k++)
+    if(!m_firstTagScanDone)
     {
-        FileInfo &info = m_sourceFiles[k];
-
-        // Find the tag
-        QList<Tag> thisTagList;
-        m_tagManager.getTags(info.m_fullName, &thisTagList);
-        m_tagList += thisTagList;
+        m_firstTagScanDone = true;
+        TraceLog::getInstance().addComplete("tags", "Tag scan", m_tagScanTraceStart);
+        checkStartupDone();
     }
 
-    fillInClassList();
-    fillInFuncList();
-}
-
-
-void MainWindow::fillInClassList()
-{
-    // Get all classes
-    QStringList classList;
-    for(int i = 0;i < m_tagList.size();i++)
+    // The browser index is rebuilt in the background when the tags have changed
+    if(m_tagManager.getGeneration() != m_tagBrowserGeneration)
     {
-        const Tag &tag = m_tagList[i];
-        QString className = tag.getClassName();
-        if(!className.isEmpty())
-            classList += tag.getClassName();
-    }
-    classList.removeDuplicates();
-    classList.sort();
-    
-    // Insert the classes in the class widget
-    QTreeWidget *classWidget = m_ui.treeWidget_classes;
-    classWidget->clear();
-    int totalClassFuncCount = 0;
-    for(int ci = 0;ci < classList.size();ci++)
-    {
-        QString className = classList[ci];
-
-        bool isMatch = true;
-        
-        // Does the filter match the name?
-        for(int j = 0;j < m_classFilterText.size() && isMatch == true;j++)
-        {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-            QRegularExpression &rx = m_classFilterText[j];
-            if(!rx.match(className).hasMatch())
-                isMatch = false;
-#else
-            QRegExp &rx = m_classFilterText[j];
-            if(rx.indexIn(className) == -1)
-                isMatch = false;
-#endif
-        }
+        m_tagBrowserGeneration = m_tagManager.getGeneration();
 
-        if(isMatch)
-        {
-            // Insert the class
-            QTreeWidgetItem *classItem = new QTreeWidgetItem;
-            classItem->setText(0, className);
-            QBrush blueBrush (Qt::blue);
-            classItem->setForeground( 0, blueBrush);
-            classWidget->addTopLevelItem(classItem);
-
-
-            // Add all functions to the class in the class widget
-            for(int i = 0;i < m_tagList.size();i++)
-            {
-                const Tag &tag = m_tagList[i];
-                if(tag.isFunc() && tag.getClassName() == className)
-                {
-                    QTreeWidgetItem *item = new QTreeWidgetItem;
-                    item->setText(0, tag.getName() + tag.getSignature());
-                    item->setData(0, Qt::UserRole, tag.getLineNo());
-                    item->setText(1, getFilenamePart(tag.getFilePath()));
-                    item->setData(1, Qt::UserRole, tag.getFilePath());
-                    item->setText(2, QString::number(tag.getLineNo()));
-                    classItem->addChild(item);
-
-                }
-            }
-            totalClassFuncCount += m_tagList.size();
-        }
-    
+        QList<QList<Tag> > tagLists;
+        for(int k = 0;k < m_sourceFiles.size();k++)
+            tagLists.append(m_tagManager.getTagList(m_sourceFiles[k].m_fullName));
+        m_tagBrowserWorker.setTags(tagLists);
     }
-
-    // Expand class treewidget?
-    if(totalClassFuncCount < CLASS_LIST_AUTO_EXPAND_COUNT)
-    {
-        for(int j = classWidget->topLevelItemCount()-1;j >= 0;--j)
-        {
-            QTreeWidgetItem * classItem = classWidget->topLevelItem(j);
-            classItem->setExpanded(true);
-        }
-    }
-    
 }
 
-void MainWindow::fillInFuncList()
+
+/**
+ * @brief Called when the function and/or class list has been filtered.
+ */
+void MainWindow::onTagBrowserResult(TagBrowserResult result)
 {
-    QTreeWidget *funcWidget = m_ui.treeWidget_functions;
-    funcWidget->clear();
+    m_functionListModel.setResult(result);
+    m_classTreeModel.setResult(result);
 
-    // Add all functions to the treewidget
-    for(int i = 0;i < m_tagList.size();i++)
+    // Expand class view?
+    if((result.m_changed & TagBrowserResult::CLASSES) &&
+        result.m_classFuncCount < CLASS_LIST_AUTO_EXPAND_COUNT)
     {
-        const Tag &tag = m_tagList[i];
-        if(tag.isFunc())
-        {
-            bool isMatch = true;
-
-            // Does the filter match the name?
-            QString name = tag.getLongName();
-            for(int j = 0;j < m_funcFilterText.size() && isMatch == true;j++)
-            {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-                QRegularExpression &rx = m_funcFilterText[j];
-                if(!rx.match(name).hasMatch())
-                    isMatch = false;
-#else
-                QRegExp &rx = m_funcFilterText[j];
-                if(rx.indexIn(name) == -1)
-                    isMatch = false;
-#endif
-            }
-
-            // Add the item if it matches
-            if(isMatch)
-            {
-                QTreeWidgetItem *item = new QTreeWidgetItem;
-                if(tag.getClassName().isEmpty())
-                    item->setText(0, " " + name);
-                else
-                    item->setText(0, name);
-                item->setData(0, Qt::UserRole, tag.getLineNo());
-                item->setText(1, getFilenamePart(tag.getFilePath()));
-                item->setData(1, Qt::UserRole, tag.getFilePath());
-                item->setText(2, QString::number(tag.getLineNo()));
-                    
-                funcWidget->addTopLevelItem(item);
-            }
-        }
+        m_ui.treeView_classes->expandAll();
     }
-    funcWidget->sortItems(0, Qt::AscendingOrder);
-
-}
-
-void MainWindow::onFuncWidgetItemSelected(QTreeWidgetItem * item, int column)
-{
-    Q_UNUSED(column);
-
-    // Get the linenumber and file where the function is defined in            
-    QString filePath = item->data(1, Qt::UserRole).toString();
-    int lineNo = item->data(0, Qt::UserRole).toInt();
-
-    open(filePath, lineNo);
 }
 
 
-void MainWindow::onClassWidgetItemSelected(QTreeWidgetItem * item, int column)
+void MainWindow::onTagBrowserItemClicked(const QModelIndex &index)
 {
-    Q_UNUSED(column);
-
-    debugMsg("%s(item:%p column:%d)", __func__, item, column);
+    // Get the linenumber and file where the function is defined in
+    QString filePath = index.sibling(index.row(), FunctionListModel::COLUMN_FILENAME).data(Qt::UserRole).toString();
+    int lineNo = index.sibling(index.row(), FunctionListModel::COLUMN_NAME).data(Qt::UserRole).toInt();
 
-    // Get the linenumber and file where the function is defined in            
-    QString filePath = item->data(1, Qt::UserRole).toString();
-    int lineNo = item->data(0, Qt::UserRole).toInt();
+    // A class was clicked?
+    if(filePath.isEmpty())
+        return;
 
     open(filePath, lineNo);
 }
@@ -13,12 +13,7 @@
 #include <QApplication>
 #include <QMap>
 #include <QLabel>
-
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-#include <QRegularExpression>
-#else  
-#include <QRegExp>
-#endif
+#include <QTimer>
 
 #include "consolewidget.h"
 #include "ui_mainwindow.h"
@@ -30,6 +25,12 @@
 #include "watchvarctl.h"
 #include "codeviewtab.h"
 #include "tagmanager.h"
+#include "threadlistmodel.h"
+#include "stackgroups.h"
+#include "profiler.h"
+#include "symbolindex.h"
+#include "tagbrowser.h"
+#include "sourcewatcher.h"
 #include "log.h"
 
 
@@ -63,10 +64,17 @@ public:
     void ICore_onLocalVarChanged(QStringList varNames);
     void ICore_onWatchVarChanged(VarWatch &watch);
     void ICore_onConsoleStream(QString text);
+    void ICore_onLogPointOutput(QString text);
+    void ICore_onSampleStopped();
     void ICore_onBreakpointsChanged();
     void ICore_onThreadListChanged();
+    void ICore_onThreadCreated(int threadId);
+    void ICore_onThreadExited(int threadId);
+    void ICore_onThreadDetailsChanged(int threadId);
+    void ICore_onThreadDetailsInvalidated();
     void ICore_onCurrentThreadChanged(int threadId);
     void ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList);
+    void ICore_onStackFramesLoaded(QList<StackFrameEntry> stackFrameList);
     void ICore_onFrameVarReset();
     void ICore_onFrameVarChanged(QString name, QString value);
     void ICore_onMessage(QString message);
@@ -75,7 +83,8 @@ public:
     void ICore_onTargetOutput(QString msg);
     void ICore_onStateChanged(TargetState state);
     void ICore_onSourceFileListChanged();
-    void ICore_onSourceFileChanged(QString filename);
+    void ICore_onLibrariesChanged();
+    void ICore_onReady(int readyTime);
 
     void ICodeView_onRowDoubleClick(int lineNo);
     void ICodeView_onContextMenu(QPoint pos, int lineNo, QStringList text);
@@ -86,19 +95,18 @@ public:
     
     
     
-    void ILogger_onWarnMsg(QString text);
-    void ILogger_onErrorMsg(QString text);
-    void ILogger_onInfoMsg(QString text);
-    void ILogger_onCriticalMsg(QString text);
+    void ILogger_onMessages(const QList<LogMessage> &msgList);
 
     
 private:
     void showEvent(QShowEvent *);
     void closeEvent(QCloseEvent *e);
+    void paintEvent(QPaintEvent *e);
+    void checkStartupDone();
 
     void showWidgets();
-    void fillInFuncList();
-    void fillInClassList();
+    void updateThreadGroups();
+    void insertStackFrameItems(QList<StackFrameEntry> stackFrameList, int firstFrameIdx);
     
 public:
         
@@ -142,7 +150,12 @@ public slots:
     void onIncSearch_textChanged(const QString &text);
     void onFolderViewItemActivated ( QTreeWidgetItem * item, int column );
     void onThreadWidgetSelectionChanged( );
+    void onGroupThreadsCheckBoxStateChanged(int state);
+    void onThreadGroupsProgress(int doneCount, int totalCount);
+    void onThreadGroupsFinished();
+    void onThreadGroupsItemClicked(QTreeWidgetItem *item, int column);
     void onStackWidgetSelectionChanged();
+    void onStackWidgetScrolled(int value);
     void onQuit();
     void onNext();
     void onStepIn();
@@ -163,7 +176,10 @@ public slots:
     void onCodeViewContextMenuShowDefinition();
     void onCodeViewContextMenuShowCurrentLocation();
     void onSettings();
+    void onAddSymbolIndex();
+    void onSymbolIndexFinished(bool success);
     void onCodeViewContextMenuToggleBreakpoint();
+    void onCodeViewContextMenuAddLogPoint();
     void onCodeViewTab_tabCloseRequested ( int index );
     void onCodeViewTab_currentChanged( int tabIdx);
     void onCodeViewTab_launchContextMenu(const QPoint&);
@@ -181,6 +197,9 @@ public slots:
     void onViewTargetOutput();
     void onViewGedeOutput();
     void onViewGdbOutput();
+    void onViewLogPoints();
+    void onViewProfiler();
+    void onViewLibraries();
     void onViewFileBrowser();
     void onViewFuncFilter();
     void onViewClassFilter();
@@ -191,21 +210,33 @@ public slots:
     void onBreakpointsGoTo();
     void onBreakpointsWidgetContextMenu(const QPoint& pt);
 
+    void onLibrariesUpdateTimeout();
+    void onLibrariesWidgetItemDoubleClicked(QTreeWidgetItem *item, int column);
+    void onLibrariesWidgetContextMenu(const QPoint& pt);
+    void onLibrariesLoadSelected();
+    void onLibrariesLoadAll();
+
     void onAllTagScansDone();
-    void onFuncWidgetItemSelected(QTreeWidgetItem * item, int column);
-    void onClassWidgetItemSelected(QTreeWidgetItem * item, int column);
+    void onSourceFilesModified(QStringList filePathList);
+    void onTagBrowserResult(TagBrowserResult result);
+    void onTagBrowserItemClicked(const QModelIndex &index);
 
     
+    void onNewLogMessages(QList<LogMessage> msgList);
     void onNewInfoMsg(QString text);
     void onNewWarnMsg(QString text);
     void onNewErrorMsg(QString text);
     void onNewCritMsg(QString text);
 
+    void onLogPointFlushTimeout();
+
+    void onProfilerSampleToggled(bool checked);
+    void onProfilerClear();
+    void onProfilerUpdated();
+    void onFlameGraphFunctionClicked(QString path, int lineNo);
+
 signals:
-    void newInfoMsg(QString text);
-    void newWarnMsg(QString text);
-    void newErrorMsg(QString text);
-    void newCritMsg(QString text);
+    void newLogMessages(QList<LogMessage> msgList);
     
 private:
     QByteArray m_gui_default_mainwindowState;
@@ -223,19 +254,18 @@ private:
     int m_currentLine; //!< The linenumber (first=1) which the program counter points to.
     QList<StackFrameEntry> m_stackFrameList;
     QMenu m_popupMenu;
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-    QVector<QRegularExpression> m_funcFilterText; //!< Filter for the function list.
-    QVector<QRegularExpression> m_classFilterText; //!< Filter for the class list.
-#else
-    QVector<QRegExp> m_funcFilterText; //!< Filter for the function list.
-    QVector<QRegExp> m_classFilterText; //!< Filter for the class list.
-#endif
+    QString m_funcFilterText; //!< Filter for the function list.
+    QString m_classFilterText; //!< Filter for the class list.
 
     
     Settings m_cfg;
     TagManager m_tagManager;
     QList<FileInfo> m_sourceFiles;
-    QList<Tag> m_tagList; // Current list of tags
+    TagBrowserWorker m_tagBrowserWorker;
+    FunctionListModel m_functionListModel;
+    ClassTreeModel m_classTreeModel;
+    int m_tagBrowserGeneration; //!< The tag generation that the browser index was built from.
+    SourceWatcher m_sourceWatcher;
     
     AutoVarCtl m_autoVarCtl;
     WatchVarCtl m_watchVarCtl;
@@ -244,6 +274,16 @@ private:
     QFont m_gedeOutputFont;
     QLabel m_statusLineWidget;
     Locator m_locator;
+    ThreadListModel m_threadListModel;
+    StackGroupCollector m_stackGroupCollector;
+    bool m_firstPaintDone;
+    QStringList m_logPointPending; //!< Log point messages not yet added to the log point window.
+    QTimer m_logPointFlushTimer;
+    Profiler m_profiler;
+    QTimer m_librariesUpdateTimer; //!< Updates the library window once for a burst of loaded libraries.
+    SymbolIndexGenerator m_symbolIndexGenerator;
+    bool m_firstTagScanDone;
+    qint64 m_tagScanTraceStart; //!< Trace timestamp of when the tag scan was started.
 };
 
 
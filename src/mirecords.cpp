@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "mirecords.h"
+
+#include <stdlib.h>
+
+#include "util.h"
+
+
+// The field names are hashed once. Each decode() walks the children of
+// the node once and compares the hashes, so no paths are split.
+static const TreeKey g_keyLevel("level");
+static const TreeKey g_keyFunc("func");
+static const TreeKey g_keyFullname("fullname");
+static const TreeKey g_keyLine("line");
+static const TreeKey g_keyArgs("args");
+static const TreeKey g_keyReason("reason");
+static const TreeKey g_keySignalName("signal-name");
+static const TreeKey g_keyFrame("frame");
+static const TreeKey g_keyName("name");
+static const TreeKey g_keyValue("value");
+static const TreeKey g_keyInScope("in_scope");
+static const TreeKey g_keyTypeChanged("type_changed");
+static const TreeKey g_keyNewType("new_type");
+static const TreeKey g_keyNewNumChildren("new_num_children");
+static const TreeKey g_keyNumber("number");
+static const TreeKey g_keyOriginalLocation("original-location");
+static const TreeKey g_keyAddr("addr");
+static const TreeKey g_keyId("id");
+static const TreeKey g_keyTargetId("target-id");
+static const TreeKey g_keyDetails("details");
+static const TreeKey g_keyThreadId("thread-id");
+static const TreeKey g_keyStoppedThreads("stopped-threads");
+static const TreeKey g_keyState("state");
+static const TreeKey g_keyType("type");
+static const TreeKey g_keyFrom("from");
+static const TreeKey g_keyTo("to");
+static const TreeKey g_keyHostName("host-name");
+static const TreeKey g_keySymbolsLoaded("symbols-loaded");
+static const TreeKey g_keyLowAddress("low-address");
+static const TreeKey g_keyHighAddress("high-address");
+static const TreeKey g_keyRanges("ranges");
+
+
+void MiFrameRecord::decode(const TreeNode *frameNode)
+{
+    for(int i = 0;i < frameNode->getChildCount();i++)
+    {
+        TreeNode *child = frameNode->getChild(i);
+        if(child->is(g_keyLevel))
+            m_level = child->getDataInt();
+        else if(child->is(g_keyFunc))
+            m_func = child->getData();
+        else if(child->is(g_keyFullname))
+            m_fullname = child->getData();
+        else if(child->is(g_keyLine))
+            m_line = child->getDataInt();
+        else if(child->is(g_keyAddr))
+            m_addr = stringToLongLong(child->getData());
+        else if(child->is(g_keyFrom))
+            m_from = child->getData();
+        else if(child->is(g_keyArgs))
+            m_argsNode = child;
+    }
+}
+
+
+void MiStoppedRecord::decode(Tree &tree)
+{
+    for(int i = 0;i < tree.getRootChildCount();i++)
+    {
+        TreeNode *child = tree.getChildAt(i);
+        if(child->is(g_keyReason))
+            m_reason = child->getData();
+        else if(child->is(g_keySignalName))
+            m_signalName = child->getData();
+        else if(child->is(g_keyThreadId))
+            m_threadId = child->getDataInt();
+        else if(child->is(g_keyStoppedThreads))
+        {
+            // Either "all" or a list of thread ids
+            if(child->getChildCount() == 0)
+                m_allStopped = child->getData() == "all";
+            for(int j = 0;j < child->getChildCount();j++)
+                m_stoppedThreads.append(child->getChild(j)->getDataInt());
+        }
+        else if(child->is(g_keyFrame))
+        {
+            m_hasFrame = true;
+            m_frame.decode(child);
+        }
+    }
+}
+
+
+void MiChangelistEntry::decode(const TreeNode *node)
+{
+    for(int i = 0;i < node->getChildCount();i++)
+    {
+        TreeNode *child = node->getChild(i);
+        if(child->is(g_keyName))
+            m_name = child->getData();
+        else if(child->is(g_keyValue))
+            m_value = child->getData();
+        else if(child->is(g_keyInScope))
+            m_inScope = child->getData();
+        else if(child->is(g_keyTypeChanged))
+            m_typeChanged = child->getData();
+        else if(child->is(g_keyNewType))
+            m_newType = child->getData();
+        else if(child->is(g_keyNewNumChildren))
+            m_newNumChildren = child->getDataInt();
+    }
+}
+
+
+void MiBreakpointRecord::decode(const TreeNode *bkptNode)
+{
+    for(int i = 0;i < bkptNode->getChildCount();i++)
+    {
+        TreeNode *child = bkptNode->getChild(i);
+        if(child->is(g_keyNumber))
+            m_number = child->getDataInt();
+        else if(child->is(g_keyLine))
+            m_line = child->getDataInt();
+        else if(child->is(g_keyFullname))
+            m_fullname = child->getData();
+        else if(child->is(g_keyOriginalLocation))
+            m_originalLocation = child->getData();
+        else if(child->is(g_keyFunc))
+            m_func = child->getData();
+        else if(child->is(g_keyAddr))
+            m_addr = stringToLongLong(child->getData());
+        else if(child->is(g_keyType))
+            m_type = child->getData();
+    }
+}
+
+
+void MiThreadRecord::decode(const TreeNode *threadNode)
+{
+    for(int i = 0;i < threadNode->getChildCount();i++)
+    {
+        TreeNode *child = threadNode->getChild(i);
+        if(child->is(g_keyId))
+            m_id = atoi(stringToCStr(child->getData()));
+        else if(child->is(g_keyTargetId))
+            m_targetId = child->getData();
+        else if(child->is(g_keyDetails))
+            m_details = child->getData();
+        else if(child->is(g_keyState))
+            m_running = child->getData() == "running";
+        else if(child->is(g_keyFrame))
+            m_frame.decode(child);
+    }
+}
+
+
+void MiLibraryRecord::decode(const TreeNode *libNode)
+{
+    for(int i = 0;i < libNode->getChildCount();i++)
+    {
+        TreeNode *child = libNode->getChild(i);
+        if(child->is(g_keyId))
+            m_id = child->getData();
+        else if(child->is(g_keyHostName))
+            m_hostName = child->getData();
+        else if(child->is(g_keySymbolsLoaded))
+            m_symbolsLoaded = child->getDataInt() != 0;
+        // Older GDB versions
+        else if(child->is(g_keyLowAddress))
+            m_fromAddr = stringToLongLong(child->getData());
+        else if(child->is(g_keyHighAddress))
+            m_toAddr = stringToLongLong(child->getData());
+        // Newer GDB versions report a list of ranges
+        else if(child->is(g_keyRanges))
+        {
+            for(int j = 0;j < child->getChildCount();j++)
+            {
+                TreeNode *rangeNode = child->getChild(j);
+                unsigned long long fromAddr = stringToLongLong(rangeNode->getChildDataString("from"));
+                unsigned long long toAddr = stringToLongLong(rangeNode->getChildDataString("to"));
+                if(fromAddr != 0 && (m_fromAddr == 0 || fromAddr < m_fromAddr))
+                    m_fromAddr = fromAddr;
+                if(toAddr > m_toAddr)
+                    m_toAddr = toAddr;
+            }
+        }
+    }
+}
+
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__MIRECORDS_H
+#define FILE__MIRECORDS_H
+
+#include <QString>
+#include <QList>
+
+#include "tree.h"
+
+
+/**
+ * @brief The fields of a 'frame' tuple.
+ */
+class MiFrameRecord
+{
+public:
+    MiFrameRecord() : m_level(0), m_line(0), m_addr(0), m_argsNode(NULL) {};
+
+    void decode(const TreeNode *frameNode);
+
+    int m_level;
+    QString m_func;
+    QString m_fullname;
+    QString m_from; //!< The shared library of the frame (only set if there is no source).
+    int m_line; //!< 0 if not known.
+    unsigned long long m_addr;
+    TreeNode *m_argsNode; //!< The 'args' list (or NULL).
+};
+
+
+/**
+ * @brief The fields of a '*stopped' record.
+ */
+class MiStoppedRecord
+{
+public:
+    MiStoppedRecord() : m_threadId(0), m_allStopped(false), m_hasFrame(false) {};
+
+    void decode(Tree &tree);
+
+    QString m_reason;
+    QString m_signalName;
+    int m_threadId; //!< The thread that caused the stop (0 if not known).
+    bool m_allStopped; //!< True if 'stopped-threads' is "all".
+    QList<int> m_stoppedThreads; //!< The stopped threads if not all of them.
+    bool m_hasFrame;
+    MiFrameRecord m_frame;
+};
+
+
+/**
+ * @brief An entry in the 'changelist' of a -var-update result.
+ */
+class MiChangelistEntry
+{
+public:
+    MiChangelistEntry() : m_newNumChildren(0) {};
+
+    void decode(const TreeNode *node);
+
+    QString m_name;
+    QString m_value;
+    QString m_inScope;
+    QString m_typeChanged;
+    QString m_newType;
+    int m_newNumChildren;
+};
+
+
+/**
+ * @brief The fields of a 'bkpt' tuple.
+ */
+class MiBreakpointRecord
+{
+public:
+    MiBreakpointRecord() : m_number(0), m_line(0), m_addr(0) {};
+
+    void decode(const TreeNode *bkptNode);
+
+    int m_number;
+    int m_line;
+    QString m_fullname;
+    QString m_originalLocation;
+    QString m_func;
+    long long m_addr;
+    QString m_type; //!< "breakpoint", "dprintf", ...
+};
+
+
+/**
+ * @brief An entry in the 'threads' list of a -thread-info result.
+ */
+class MiThreadRecord
+{
+public:
+    MiThreadRecord() : m_id(0), m_running(false) {};
+
+    void decode(const TreeNode *threadNode);
+
+    int m_id;
+    bool m_running; //!< True if 'state' is "running".
+    QString m_targetId;
+    QString m_details;
+    MiFrameRecord m_frame;
+};
+
+
+/**
+ * @brief The fields of a =library-loaded record or an entry in the
+ * 'shared-libraries' list of a -file-list-shared-libraries result.
+ */
+class MiLibraryRecord
+{
+public:
+    MiLibraryRecord() : m_symbolsLoaded(false), m_fromAddr(0), m_toAddr(0) {};
+
+    void decode(const TreeNode *libNode);
+
+    QString m_id;
+    QString m_hostName;
+    bool m_symbolsLoaded;
+    unsigned long long m_fromAddr; //!< Lowest address of the code (0 if not known).
+    unsigned long long m_toAddr;
+};
+
+
+#endif // FILE__MIRECORDS_H
+
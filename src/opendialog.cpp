@@ -80,6 +80,11 @@ OpenDialog::OpenDialog(QWidget *parent)
         int baudRate = baudRates[idx];
         m_ui.comboBox_baudRate->addItem(QString::asprintf("%d", baudRate), QVariant(baudRate));
     }
+
+    // Add the ways a log point can be printed
+    m_ui.comboBox_dprintfStyle->addItem("GDB", QVariant(QString("gdb")));
+    m_ui.comboBox_dprintfStyle->addItem("Target (call printf)", QVariant(QString("call")));
+    m_ui.comboBox_dprintfStyle->addItem("Agent (gdbserver)", QVariant(QString("agent")));
 }
 
 
@@ -313,6 +318,8 @@ void OpenDialog::onConnectionTypeCoreDump(bool checked)
     
     m_ui.lineEdit_initialBreakpoint->setEnabled(checked ? false : true);
     m_ui.checkBox_reloadBreakpoints->setEnabled(checked ? false : true);
+    m_ui.checkBox_nonStop->setEnabled(checked ? false : true);
+    m_ui.comboBox_dprintfStyle->setEnabled(checked ? false : true);
 }
 
 
@@ -382,6 +389,10 @@ void OpenDialog::saveConfig(Settings *cfg)
         cfg->m_reloadBreakpoints = true;
     else
         cfg->m_reloadBreakpoints = false;
+    cfg->m_nonStop = dlg.m_ui.checkBox_nonStop->checkState() == Qt::Checked ? true : false;
+    cfg->m_lazySharedLibs = dlg.m_ui.checkBox_lazySharedLibs->checkState() == Qt::Checked ? true : false;
+    cfg->m_gdbIndexCache = dlg.m_ui.checkBox_gdbIndexCache->checkState() == Qt::Checked ? true : false;
+    cfg->m_dprintfStyle = dlg.m_ui.comboBox_dprintfStyle->currentData().toString();
     
     cfg->m_projDir = getProjectDir();
 
@@ -426,6 +437,12 @@ void OpenDialog::loadConfig(Settings &cfg)
     dlg.setGdbPath(cfg.m_gdbPath);
 
     dlg.m_ui.checkBox_reloadBreakpoints->setChecked(cfg.m_reloadBreakpoints);
+    dlg.m_ui.checkBox_nonStop->setChecked(cfg.m_nonStop);
+    dlg.m_ui.checkBox_lazySharedLibs->setChecked(cfg.m_lazySharedLibs);
+    dlg.m_ui.checkBox_gdbIndexCache->setChecked(cfg.m_gdbIndexCache);
+    int dprintfStyleIdx = dlg.m_ui.comboBox_dprintfStyle->findData(QVariant(cfg.m_dprintfStyle));
+    if(dprintfStyleIdx != -1)
+        dlg.m_ui.comboBox_dprintfStyle->setCurrentIndex(dprintfStyleIdx);
 
     dlg.setCoreDumpFile(cfg.m_coreDumpFile);
 
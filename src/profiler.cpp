@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "profiler.h"
+
+#include <algorithm>
+
+#include "config.h"
+#include "log.h"
+
+
+SampleProfile::SampleProfile()
+{
+    clear();
+}
+
+
+SampleProfile::~SampleProfile()
+{
+}
+
+
+void SampleProfile::clear()
+{
+    m_strings.clear();
+    m_stringLookup.clear();
+    m_functions.clear();
+    m_functionLookup.clear();
+    m_nodes.clear();
+    m_childLookup.clear();
+    m_lineHits.clear();
+    m_sampleCount = 0;
+
+    Node root;
+    root.m_funcIdx = -1;
+    root.m_parentIdx = -1;
+    root.m_count = 0;
+    m_nodes.append(root);
+}
+
+
+int SampleProfile::internString(const QString &str)
+{
+    QHash<QString, int>::const_iterator it = m_stringLookup.constFind(str);
+    if(it != m_stringLookup.constEnd())
+        return it.value();
+
+    int strIdx = m_strings.size();
+    m_strings.append(str);
+    m_stringLookup.insert(str, strIdx);
+    return strIdx;
+}
+
+
+int SampleProfile::internFunction(const StackFrameEntry &entry)
+{
+    int nameIdx = internString(entry.m_functionName);
+    int pathIdx = internString(entry.m_sourcePath);
+    quint64 key = ((quint64)nameIdx << 32) | (quint32)pathIdx;
+
+    QHash<quint64, int>::const_iterator it = m_functionLookup.constFind(key);
+    if(it != m_functionLookup.constEnd())
+    {
+        Function &func = m_functions[it.value()];
+        if(entry.m_line > 0 && (func.m_lineNo <= 0 || entry.m_line < func.m_lineNo))
+            func.m_lineNo = entry.m_line;
+        return it.value();
+    }
+
+    Function func;
+    func.m_nameIdx = nameIdx;
+    func.m_pathIdx = pathIdx;
+    func.m_lineNo = entry.m_line;
+    int funcIdx = m_functions.size();
+    m_functions.append(func);
+    m_functionLookup.insert(key, funcIdx);
+    return funcIdx;
+}
+
+
+/**
+ * @brief Returns the child node for a function (creates it if needed).
+ */
+int SampleProfile::getChild(int parentIdx, int funcIdx)
+{
+    quint64 key = ((quint64)parentIdx << 32) | (quint32)funcIdx;
+    QHash<quint64, int>::const_iterator it = m_childLookup.constFind(key);
+    if(it != m_childLookup.constEnd())
+        return it.value();
+
+    Node node;
+    node.m_funcIdx = funcIdx;
+    node.m_parentIdx = parentIdx;
+    node.m_count = 0;
+    int nodeIdx = m_nodes.size();
+    m_nodes.append(node);
+    m_nodes[parentIdx].m_children.append(nodeIdx);
+    m_childLookup.insert(key, nodeIdx);
+    return nodeIdx;
+}
+
+
+/**
+ * @brief Adds the backtrace of one thread.
+ * @param frames  The frames (oldest frame first).
+ */
+void SampleProfile::addStack(const QList<StackFrameEntry> &frames)
+{
+    int nodeIdx = 0;
+    m_nodes[0].m_count++;
+
+    // Lines that are already counted for this backtrace (recursion)
+    QVector<quint64> countedLines;
+
+    for(int i = 0;i < frames.size();i++)
+    {
+        const StackFrameEntry &entry = frames[i];
+        int funcIdx = internFunction(entry);
+
+        nodeIdx = getChild(nodeIdx, funcIdx);
+        m_nodes[nodeIdx].m_count++;
+
+        if(entry.m_sourcePath.isEmpty() || entry.m_line <= 0)
+            continue;
+        int pathIdx = m_functions[funcIdx].m_pathIdx;
+        quint64 lineKey = ((quint64)pathIdx << 32) | (quint32)entry.m_line;
+        if(countedLines.contains(lineKey))
+            continue;
+        countedLines.append(lineKey);
+        m_lineHits[pathIdx][entry.m_line]++;
+    }
+}
+
+
+/**
+ * @brief Returns the number of backtraces that passed each line in a file.
+ */
+QHash<int, int> SampleProfile::getLineHits(QString path) const
+{
+    QHash<QString, int>::const_iterator it = m_stringLookup.constFind(path);
+    if(it == m_stringLookup.constEnd())
+        return QHash<int, int>();
+    return m_lineHits.value(it.value());
+}
+
+
+
+Profiler::Profiler()
+    : m_active(false)
+    ,m_sampleRate(20)
+    ,m_maxOverhead(10)
+    ,m_maxDepth(64)
+    ,m_lastStopTime(0)
+{
+    m_sampleTimer.setSingleShot(true);
+    connect(&m_sampleTimer, SIGNAL(timeout()), this, SLOT(onSampleTimeout()));
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(PROFILER_UPDATE_INTERVAL);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(onUpdateTimeout()));
+}
+
+
+Profiler::~Profiler()
+{
+}
+
+
+void Profiler::setConfig(Settings *cfg)
+{
+    m_sampleRate = std::max(1, cfg->m_sampleRate);
+    m_maxOverhead = std::min(std::max(1, cfg->m_sampleMaxOverhead), 99);
+    m_maxDepth = std::max(1, cfg->m_sampleMaxDepth);
+}
+
+
+/**
+ * @brief Starts to take samples (when the target is running).
+ */
+void Profiler::start()
+{
+    if(m_active)
+        return;
+
+    infoMsg("Sampling %d times per second", m_sampleRate);
+    m_active = true;
+    m_lastStopTime = 0;
+    m_sampleTimer.start(getInterval());
+}
+
+
+void Profiler::stop()
+{
+    if(!m_active)
+        return;
+
+    m_active = false;
+    m_sampleTimer.stop();
+    infoMsg("Took %d samples", m_profile.getSampleCount());
+    emit updated();
+}
+
+
+void Profiler::clear()
+{
+    m_profile.clear();
+    emit updated();
+}
+
+
+/**
+ * @brief Returns the number of ms to wait before taking the next sample.
+ */
+int Profiler::getInterval() const
+{
+    int interval = 1000 / m_sampleRate;
+
+    // Keep the time stopped below the max overhead of the total time
+    int minInterval = (m_lastStopTime * (100 - m_maxOverhead)) / m_maxOverhead;
+
+    return std::max(interval, minInterval);
+}
+
+
+void Profiler::onSampleTimeout()
+{
+    Core &core = Core::getInstance();
+
+    if(!m_active)
+        return;
+
+    // Nothing to sample while the target is stopped
+    if(!core.isRunning())
+        m_stopTimer.invalidate();
+    else if(core.sampleStop() == 0)
+    {
+        // Measure from the first interrupt if the last one has not stopped the target yet
+        if(!m_stopTimer.isValid())
+            m_stopTimer.start();
+    }
+
+    // In case the target stops for another reason than the sample
+    m_sampleTimer.start(getInterval());
+}
+
+
+/**
+ * @brief Called when the target has been interrupted to take a sample.
+ *
+ * The target is resumed by Core when this returns.
+ */
+void Profiler::onSampleStopped()
+{
+    Core &core = Core::getInstance();
+
+    // An interrupt sent before the profiler was stopped
+    if(!m_active)
+    {
+        m_stopTimer.invalidate();
+        return;
+    }
+
+    // One extra frame to know if the backtrace is deeper than the max depth
+    QMap<int, QList<StackFrameEntry> > stacks;
+    core.gdbGetThreadStacks(core.getThreadIdList(), m_maxDepth+1, &stacks);
+
+    m_profile.addSample();
+    QMap<int, QList<StackFrameEntry> >::iterator it = stacks.begin();
+    for(;it != stacks.end();++it)
+    {
+        QList<StackFrameEntry> &frames = it.value();
+
+        // Only the innermost frames are known so put them below a root of their own
+        if(frames.size() > m_maxDepth)
+        {
+            while(frames.size() > m_maxDepth)
+                frames.removeFirst();
+            StackFrameEntry truncatedEntry;
+            truncatedEntry.m_functionName = PROFILER_TRUNCATED_NAME;
+            truncatedEntry.m_line = 0;
+            frames.prepend(truncatedEntry);
+        }
+        m_profile.addStack(frames);
+    }
+
+    m_lastStopTime = m_stopTimer.isValid() ? (int)m_stopTimer.elapsed() : 0;
+    m_stopTimer.invalidate();
+
+    if(m_active)
+        m_sampleTimer.start(getInterval());
+
+    if(!m_updateTimer.isActive())
+        m_updateTimer.start();
+}
+
+
+void Profiler::onUpdateTimeout()
+{
+    emit updated();
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__PROFILER_H
+#define FILE__PROFILER_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "core.h"
+
+
+/**
+ * @brief The backtraces collected by the profiler.
+ *
+ * The strings and functions are interned so that each sample only adds a
+ * few integers. The backtraces are merged into a prefix tree where each
+ * node is a function called from the function of the parent node.
+ */
+class SampleProfile
+{
+public:
+    SampleProfile();
+    virtual ~SampleProfile();
+
+    /**
+     * @brief A function seen in a backtrace.
+     */
+    class Function
+    {
+    public:
+        int m_nameIdx; //!< Index in the string table.
+        int m_pathIdx; //!< Index in the string table.
+        int m_lineNo; //!< The first line seen in the function.
+    };
+
+    /**
+     * @brief A node in the prefix tree of the backtraces.
+     */
+    class Node
+    {
+    public:
+        int m_funcIdx; //!< -1 for the root node.
+        int m_parentIdx;
+        int m_count; //!< Number of backtraces passing through this node.
+        QVector<int> m_children;
+    };
+
+    void clear();
+    void addStack(const QList<StackFrameEntry> &frames);
+    void addSample() { m_sampleCount++; };
+
+    int getSampleCount() const { return m_sampleCount; };
+    int getStackCount() const { return m_nodes[0].m_count; };
+
+    int getNodeCount() const { return m_nodes.size(); };
+    const Node &getNode(int nodeIdx) const { return m_nodes[nodeIdx]; };
+    const Function &getFunction(int funcIdx) const { return m_functions[funcIdx]; };
+    QString getString(int strIdx) const { return m_strings[strIdx]; };
+
+    QHash<int, int> getLineHits(QString path) const;
+
+private:
+    int internString(const QString &str);
+    int internFunction(const StackFrameEntry &entry);
+    int getChild(int parentIdx, int funcIdx);
+
+private:
+    QStringList m_strings;
+    QHash<QString, int> m_stringLookup;
+    QVector<Function> m_functions;
+    QHash<quint64, int> m_functionLookup; //!< (nameIdx, pathIdx) to function index.
+    QVector<Node> m_nodes; //!< The first node is the root.
+    QHash<quint64, int> m_childLookup; //!< (parent node, function index) to node index.
+    QHash<int, QHash<int, int> > m_lineHits; //!< Backtraces per line for each path index.
+    int m_sampleCount;
+};
+
+
+/**
+ * @brief Samples the backtraces of the target while it is running.
+ *
+ * The target is interrupted at a fixed rate. The backtraces of all threads
+ * are fetched in one batch and the target is resumed directly. The rate is
+ * lowered if the target would otherwise be stopped more than the max
+ * overhead.
+ */
+class Profiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    Profiler();
+    virtual ~Profiler();
+
+    void setConfig(Settings *cfg);
+
+    void start();
+    void stop();
+    bool isActive() const { return m_active; };
+
+    void clear();
+
+    const SampleProfile &getProfile() const { return m_profile; };
+
+    void onSampleStopped();
+
+signals:
+    void updated();
+
+private slots:
+    void onSampleTimeout();
+    void onUpdateTimeout();
+
+private:
+    int getInterval() const;
+
+private:
+    SampleProfile m_profile;
+    bool m_active;
+    int m_sampleRate;
+    int m_maxOverhead;
+    int m_maxDepth;
+    int m_lastStopTime; //!< Number of ms the target was stopped for the last sample.
+    QTimer m_sampleTimer;
+    QTimer m_updateTimer;
+    QElapsedTimer m_stopTimer;
+};
+
+#endif // FILE__PROFILER_H
@@ -251,15 +251,6 @@ bool RustTagScanner::isSpecialChar(char c) const
         return false;
 }
 
-bool RustTagScanner::isSpecialChar(TextField *field) const
-{
-    if(field->m_text.size() == 1)
-    {
-        return isSpecialChar(field->m_text[0].toLatin1());
-    }
-    return false;
-}
-
 
 
 
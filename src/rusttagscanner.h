@@ -9,8 +9,10 @@
 #ifndef FILE__RUSTTAGS_H
 #define FILE__RUSTTAGS_H
 
+#include <QHash>
+
 #include "tagscanner.h"
-#include "syntaxhighlighter.h"
+#include "settings.h"
 
 
 /**
@@ -38,7 +40,6 @@ private:
 
     bool isKeyword(QString text) const;
     bool isSpecialChar(char c) const;
-    bool isSpecialChar(TextField *field) const;
 
 private:
     class Token
@@ -10,6 +10,9 @@
 #include "settings.h"
 
 #include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
 #ifdef QT_WIDGETS_LIB
 #include <QStyleFactory>
 #endif
@@ -25,6 +28,82 @@
 QString Settings::g_projConfigFilename = PROJECT_CONFIG_FILENAME;
 
 
+/**
+ * @brief A parsed config file.
+ */
+class IniSnapshot
+{
+public:
+    QDateTime m_lastModified;
+    qint64 m_size;
+    Ini m_ini;
+};
+
+static QHash<QString, IniSnapshot*> g_iniSnapshots; //!< Config file path to its parsed content.
+
+
+/**
+ * @brief Loads a config file. The file is only parsed if it has changed since the last time.
+ * @return 0 on success.
+ */
+static int loadIniSnapshot(QString filename, Ini *ini)
+{
+    QFileInfo fileInfo(filename);
+    IniSnapshot *snapshot = g_iniSnapshots.value(filename, NULL);
+    if(!fileInfo.exists())
+    {
+        delete snapshot;
+        g_iniSnapshots.remove(filename);
+        return 1;
+    }
+
+    if(snapshot && snapshot->m_lastModified == fileInfo.lastModified() && snapshot->m_size == fileInfo.size())
+    {
+        *ini = snapshot->m_ini;
+        return 0;
+    }
+
+    if(ini->appendLoad(filename))
+        return 1;
+
+    if(!snapshot)
+    {
+        snapshot = new IniSnapshot;
+        g_iniSnapshots.insert(filename, snapshot);
+    }
+    snapshot->m_lastModified = fileInfo.lastModified();
+    snapshot->m_size = fileInfo.size();
+    snapshot->m_ini = *ini;
+    return 0;
+}
+
+
+/**
+ * @brief Saves a config file and keeps the content as the parsed snapshot of it.
+ * @return 0 on success.
+ */
+static int saveIniSnapshot(QString filename, Ini *ini)
+{
+    if(ini->save(filename))
+    {
+        delete g_iniSnapshots.take(filename);
+        return 1;
+    }
+
+    QFileInfo fileInfo(filename);
+    IniSnapshot *snapshot = g_iniSnapshots.value(filename, NULL);
+    if(!snapshot)
+    {
+        snapshot = new IniSnapshot;
+        g_iniSnapshots.insert(filename, snapshot);
+    }
+    snapshot->m_lastModified = fileInfo.lastModified();
+    snapshot->m_size = fileInfo.size();
+    snapshot->m_ini = *ini;
+    return 0;
+}
+
+
 Settings::Settings()
 : m_globalProjConfig(false),
     m_connectionMode(MODE_LOCAL)
@@ -38,12 +117,20 @@ Settings::Settings()
     m_viewWindowTargetOutput = true;
     m_viewWindowGedeOutput = true;
     m_viewWindowGdbOutput = true;
+    m_viewWindowLogPoints = true;
+    m_viewWindowProfiler = true;
+    m_viewWindowLibraries = true;
     m_viewWindowFileBrowser = true;
     m_enableDebugLog = false;
     m_tabIndentCount = 4;
     m_viewFuncFilter = true;
     m_viewClassFilter = true;
     m_focusOnStop = true;
+    m_nonStop = false;
+    m_dprintfStyle = "gdb";
+    m_lazySharedLibs = false;
+    m_gdbIndexCache = false;
+    m_lastReadyTime = 0;
     
     // Set cleanlooks as default on Debian
     DistroType distroType = DISTRO_UNKNOWN;
@@ -132,7 +219,10 @@ void Settings::loadDefaultsAdvanced()
     m_sourceIgnoreDirs.clear();
     m_sourceIgnoreDirs.append("/build");
     m_sourceIgnoreDirs.append("/usr");
-    
+
+    m_sampleRate = 20;
+    m_sampleMaxOverhead = 10;
+    m_sampleMaxDepth = 64;
 }
 
 
@@ -160,12 +250,23 @@ QString Settings::getProjectConfigPath() const
 }
 
 
+/**
+* @brief Returns the directory where GDB caches the symbol index of the project.
+*/
+QString Settings::getIndexCacheDir() const
+{
+    if(m_globalProjConfig)
+        return QDir::homePath() + "/"  GLOBAL_CONFIG_DIR + "/" + GDB_INDEX_CACHE_DIR;
+    return QDir::current().absoluteFilePath(GDB_INDEX_CACHE_DIR);
+}
+
+
 void Settings::loadGlobalConfig()
 {
     // Load from file
     QString globalConfigFilename = QDir::homePath() + "/"  GLOBAL_CONFIG_DIR + "/" + GLOBAL_CONFIG_FILENAME;
     Ini tmpIni;
-    if(tmpIni.appendLoad(globalConfigFilename))
+    if(loadIniSnapshot(globalConfigFilename, &tmpIni))
         infoMsg("Failed to load global ini '%s'. File will be created.", stringToCStr(globalConfigFilename));
     infoMsg("Loading %s", qPrintable(globalConfigFilename));
 
@@ -178,6 +279,10 @@ void Settings::loadGlobalConfig()
 
     m_variablePopupDelay = tmpIni.getInt("Gui/VariablePopupDelay", m_variablePopupDelay);
 
+    m_sampleRate = tmpIni.getInt("Profiler/SampleRate", m_sampleRate);
+    m_sampleMaxOverhead = tmpIni.getInt("Profiler/MaxOverhead", m_sampleMaxOverhead);
+    m_sampleMaxDepth = tmpIni.getInt("Profiler/MaxDepth", m_sampleMaxDepth);
+
     switch(tmpIni.getInt("Gui/CurrentLineStyle", m_currentLineStyle))
     {
         case HOLLOW_RECT: m_currentLineStyle = HOLLOW_RECT;break;
@@ -234,6 +339,9 @@ void Settings::loadGlobalConfig()
     m_viewWindowTargetOutput = tmpIni.getBool("GuiState/EnableWindowTargetOutput", m_viewWindowTargetOutput);
     m_viewWindowGedeOutput = tmpIni.getBool("GuiState/EnableWindowGedeOutput", m_viewWindowGedeOutput);
     m_viewWindowGdbOutput = tmpIni.getBool("GuiState/EnableWindowGdbOutput", m_viewWindowGdbOutput);
+    m_viewWindowLogPoints = tmpIni.getBool("GuiState/EnableWindowLogPoints", m_viewWindowLogPoints);
+    m_viewWindowProfiler = tmpIni.getBool("GuiState/EnableWindowProfiler", m_viewWindowProfiler);
+    m_viewWindowLibraries = tmpIni.getBool("GuiState/EnableWindowLibraries", m_viewWindowLibraries);
     m_viewWindowFileBrowser = tmpIni.getBool("GuiState/EnableWindowFileBrowser", m_viewWindowFileBrowser);
     m_viewFuncFilter = tmpIni.getBool("GuiState/EnableFuncFilter", m_viewFuncFilter);
     m_viewClassFilter = tmpIni.getBool("GuiState/EnableClassFilter", m_viewClassFilter);
@@ -274,7 +382,7 @@ void Settings::loadProjectConfig(QString filepath)
 
     // Load from file
     Ini tmpIni;
-    if(tmpIni.appendLoad(filepath))
+    if(loadIniSnapshot(filepath, &tmpIni))
         infoMsg("Failed to load project ini '%s'. File will be created.", stringToCStr(filepath));
     else
     {
@@ -306,6 +414,11 @@ void Settings::loadProjectConfig(QString filepath)
     m_runningPid = tmpIni.getInt("RunningPid", 0);
         
     m_reloadBreakpoints = tmpIni.getBool("ReuseBreakpoints", false);
+    m_nonStop = tmpIni.getBool("NonStop", false);
+    m_dprintfStyle = tmpIni.getString("DprintfStyle", "gdb");
+    m_lazySharedLibs = tmpIni.getBool("LazySharedLibraries", false);
+    m_gdbIndexCache = tmpIni.getBool("GdbIndexCache", false);
+    m_lastReadyTime = tmpIni.getInt("LastReadyTime", 0);
 
     m_initialBreakpoint = tmpIni.getString("InitialBreakpoint","main");
 
@@ -355,7 +468,7 @@ void Settings::saveProjectConfig()
 
     Ini tmpIni;
 
-    tmpIni.appendLoad(filepath);
+    loadIniSnapshot(filepath, &tmpIni);
 
     //
     tmpIni.setBool("Download", m_download);
@@ -376,6 +489,11 @@ void Settings::saveProjectConfig()
     tmpIni.setStringList("LastProgramArguments", tmpArgs);
     
     tmpIni.setBool("ReuseBreakpoints", m_reloadBreakpoints);
+    tmpIni.setBool("NonStop", m_nonStop);
+    tmpIni.setString("DprintfStyle", m_dprintfStyle);
+    tmpIni.setBool("LazySharedLibraries", m_lazySharedLibs);
+    tmpIni.setBool("GdbIndexCache", m_gdbIndexCache);
+    tmpIni.setInt("LastReadyTime", m_lastReadyTime);
 
     tmpIni.setString("InitialBreakpoint",m_initialBreakpoint);
 
@@ -398,7 +516,7 @@ void Settings::saveProjectConfig()
     tmpIni.setStringList("Breakpoints", breakpointStringList);
 
 
-    if(tmpIni.save(filepath))
+    if(saveIniSnapshot(filepath, &tmpIni))
         infoMsg("Failed to save '%s'", stringToCStr(filepath));
 
 }
@@ -410,7 +528,7 @@ void Settings::saveGlobalConfig()
 
     Ini tmpIni;
 
-    tmpIni.appendLoad(globalConfigFilename);
+    loadIniSnapshot(globalConfigFilename, &tmpIni);
 
     tmpIni.setBool("General/GlobalProjConfig", m_globalProjConfig);
     
@@ -420,6 +538,10 @@ void Settings::saveGlobalConfig()
 
     tmpIni.setInt("Gui/VariablePopupDelay", m_variablePopupDelay);
 
+    tmpIni.setInt("Profiler/SampleRate", m_sampleRate);
+    tmpIni.setInt("Profiler/MaxOverhead", m_sampleMaxOverhead);
+    tmpIni.setInt("Profiler/MaxDepth", m_sampleMaxDepth);
+
     tmpIni.setBool("Gui/ShowLineNo", m_showLineNo);
     
     tmpIni.setString("Gui/Style", m_guiStyleName);
@@ -462,6 +584,9 @@ void Settings::saveGlobalConfig()
     tmpIni.setBool("GuiState/EnableWindowTargetOutput", m_viewWindowTargetOutput);
     tmpIni.setBool("GuiState/EnableWindowGedeOutput", m_viewWindowGedeOutput);
     tmpIni.setBool("GuiState/EnableWindowGdbOutput", m_viewWindowGdbOutput);
+    tmpIni.setBool("GuiState/EnableWindowLogPoints", m_viewWindowLogPoints);
+    tmpIni.setBool("GuiState/EnableWindowProfiler", m_viewWindowProfiler);
+    tmpIni.setBool("GuiState/EnableWindowLibraries", m_viewWindowLibraries);
     tmpIni.setBool("GuiState/EnableWindowFileBrowser", m_viewWindowFileBrowser);
     tmpIni.setBool("GuiState/EnableFuncFilter", m_viewFuncFilter);
     tmpIni.setBool("GuiState/EnableClassFilter", m_viewClassFilter);
@@ -495,7 +620,7 @@ void Settings::saveGlobalConfig()
     tmpIni.setInt("ProgramConsole/DelKey", m_progConDelKey);
     tmpIni.setBool("FocusOnStop",m_focusOnStop);
 
-    if(tmpIni.save(globalConfigFilename))
+    if(saveIniSnapshot(globalConfigFilename, &tmpIni))
         infoMsg("Failed to save '%s'", stringToCStr(globalConfigFilename));
 
 }
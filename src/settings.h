@@ -64,6 +64,7 @@ class Settings
         
         static void setProjectConfig(QString filename);
         QString getProjectConfigPath() const;
+        QString getIndexCacheDir() const;
         
         void loadProjectConfig(QString path);
 
@@ -102,6 +103,11 @@ class Settings
         QStringList m_sourceIgnoreDirs;
 
         bool m_reloadBreakpoints;
+        bool m_nonStop; //!< Only stop the thread that hit a breakpoint (GDB non-stop mode).
+        QString m_dprintfStyle; //!< How log points are printed ("gdb", "call" or "agent").
+        bool m_lazySharedLibs; //!< Only load the symbols of a shared library when needed.
+        bool m_gdbIndexCache; //!< Let GDB cache the symbol index of the program in getIndexCacheDir().
+        int m_lastReadyTime; //!< Number of ms from start until the target stopped the last session (0 if not known).
         QString m_initialBreakpoint;
         
         QList<SettingsBreakpoint> m_breakpoints;
@@ -132,6 +138,9 @@ class Settings
         bool m_viewWindowTargetOutput;
         bool m_viewWindowGedeOutput;
         bool m_viewWindowGdbOutput;
+        bool m_viewWindowLogPoints;
+        bool m_viewWindowProfiler;
+        bool m_viewWindowLibraries;
         bool m_viewWindowFileBrowser;
         bool m_viewFuncFilter;
         bool m_viewClassFilter;
@@ -165,6 +174,10 @@ class Settings
         int m_maxTabs; //!< Max number of opened tabs at the same time
 
         int m_variablePopupDelay; //!< Number of milliseconds before the variables value should be displayed in a popup.
+
+        int m_sampleRate; //!< Number of samples per second taken by the profiler.
+        int m_sampleMaxOverhead; //!< Max percentage of the time the target may be stopped by the profiler.
+        int m_sampleMaxDepth; //!< Max number of frames to get for each thread in a sample.
         QStringList m_gotoRuiList;
 
         bool m_focusOnStop; //!< Raise and focus the window when breakpoint hit
@@ -89,6 +89,10 @@ void SettingsDialog::loadConfig()
 {
     m_ui.spinBox_variableInfoWindowDelay->setValue(m_cfg->m_variablePopupDelay);
 
+    m_ui.spinBox_sampleRate->setValue(m_cfg->m_sampleRate);
+    m_ui.spinBox_sampleMaxOverhead->setValue(m_cfg->m_sampleMaxOverhead);
+    m_ui.spinBox_sampleMaxDepth->setValue(m_cfg->m_sampleMaxDepth);
+
     m_settingsFontFamily = m_cfg->m_fontFamily;
     m_settingsFontSize = m_cfg->m_fontSize;
     m_settingsMemoryFontFamily = m_cfg->m_memoryFontFamily;
@@ -176,6 +180,10 @@ void SettingsDialog::getConfig(Settings *cfg)
 {
     m_cfg->m_variablePopupDelay = m_ui.spinBox_variableInfoWindowDelay->value();
 
+    cfg->m_sampleRate = m_ui.spinBox_sampleRate->value();
+    cfg->m_sampleMaxOverhead = m_ui.spinBox_sampleMaxOverhead->value();
+    cfg->m_sampleMaxDepth = m_ui.spinBox_sampleMaxDepth->value();
+
     cfg->m_fontFamily = m_settingsFontFamily;
     cfg->m_fontSize = m_settingsFontSize;
 
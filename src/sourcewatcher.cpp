@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "sourcewatcher.h"
+
+#include <QFileInfo>
+
+#include "config.h"
+#include "util.h"
+#include "log.h"
+
+
+SourceWatcher::SourceWatcher()
+    : m_unwatchedWarned(false)
+{
+    m_delayTimer.setSingleShot(true);
+    m_delayTimer.setInterval(SOURCE_WATCHER_DELAY);
+    connect(&m_delayTimer, SIGNAL(timeout()), this, SLOT(onDelayTimeout()));
+
+    connect(&m_watcher, SIGNAL(directoryChanged(const QString &)), this, SLOT(onDirectoryChanged(const QString &)));
+    connect(&m_watcher, SIGNAL(fileChanged(const QString &)), this, SLOT(onFileChanged(const QString &)));
+}
+
+
+SourceWatcher::~SourceWatcher()
+{
+}
+
+
+QDateTime SourceWatcher::getModTime(QString filePath) const
+{
+    QFileInfo info(filePath);
+    if(!info.exists())
+        return QDateTime();
+    return info.lastModified();
+}
+
+
+/**
+ * @brief Starts to watch files and directories and remembers the files that failed.
+ */
+void SourceWatcher::addWatches(QStringList pathList)
+{
+    QStringList failedPaths = m_watcher.addPaths(pathList);
+
+    QSet<QString> failedSet;
+    for(int i = 0;i < failedPaths.size();i++)
+        failedSet.insert(failedPaths[i]);
+    int failedFileCount = 0;
+    for(int i = 0;i < pathList.size();i++)
+    {
+        QString path = pathList[i];
+        if(!m_modTimes.contains(path))
+            continue;
+        if(failedSet.contains(path))
+        {
+            m_unwatchedFiles.insert(path);
+            failedFileCount++;
+        }
+        else
+        {
+            m_watchedFiles.insert(path);
+            m_unwatchedFiles.remove(path);
+        }
+    }
+    if(failedPaths.isEmpty())
+        return;
+
+    if(!m_unwatchedWarned)
+    {
+        m_unwatchedWarned = true;
+        warnMsg("Failed to watch %d source files and directories (is fs.inotify.max_user_watches too low?). "
+                "Changes to them are only detected when the program is restarted.", failedPaths.size());
+    }
+    debugMsg("Failed to watch %d source files", failedFileCount);
+}
+
+
+/**
+ * @brief Checks the files that could not be watched.
+ *
+ * Emits filesChanged() for the ones modified since last time.
+ */
+void SourceWatcher::checkUnwatched()
+{
+    QStringList changedFiles;
+    QSet<QString>::const_iterator it = m_unwatchedFiles.constBegin();
+    for(;it != m_unwatchedFiles.constEnd();++it)
+    {
+        QString filePath = *it;
+        QHash<QString, QDateTime>::iterator modIt = m_modTimes.find(filePath);
+        if(modIt == m_modTimes.end())
+            continue;
+
+        QDateTime modTime = getModTime(filePath);
+        if(modTime == modIt.value())
+            continue;
+        modIt.value() = modTime;
+
+        if(modTime.isValid())
+            changedFiles.append(filePath);
+    }
+
+    // Retry in case some watches has been freed
+    if(!m_unwatchedFiles.isEmpty())
+        addWatches(m_unwatchedFiles.values());
+
+    if(!changedFiles.isEmpty())
+    {
+        debugMsg("%d unwatched source files changed", changedFiles.size());
+        emit filesChanged(changedFiles);
+    }
+}
+
+
+/**
+ * @brief Sets the files to watch.
+ *
+ * Only the files not already watched are read, so this is cheap to call
+ * each time the list of source files is reloaded.
+ */
+void SourceWatcher::setFiles(QStringList filePathList)
+{
+    QSet<QString> newFiles;
+    QStringList addFiles;
+    QStringList addDirs;
+    for(int i = 0;i < filePathList.size();i++)
+    {
+        QString filePath = filePathList[i];
+        newFiles.insert(filePath);
+        if(m_modTimes.contains(filePath))
+            continue;
+
+        m_modTimes.insert(filePath, getModTime(filePath));
+        addFiles.append(filePath);
+
+        QString dirPath;
+        dividePath(filePath, NULL, &dirPath);
+        if(dirPath.isEmpty())
+            continue;
+        if(!m_filesByDir.contains(dirPath))
+            addDirs.append(dirPath);
+        m_filesByDir[dirPath].append(filePath);
+    }
+
+    // Stop watching removed files
+    QStringList removeFiles;
+    QStringList removeDirs;
+    QHash<QString, QDateTime>::iterator it = m_modTimes.begin();
+    while(it != m_modTimes.end())
+    {
+        QString filePath = it.key();
+        if(newFiles.contains(filePath))
+        {
+            ++it;
+            continue;
+        }
+        it = m_modTimes.erase(it);
+        m_unwatchedFiles.remove(filePath);
+        if(m_watchedFiles.remove(filePath))
+            removeFiles.append(filePath);
+
+        QString dirPath;
+        dividePath(filePath, NULL, &dirPath);
+        QHash<QString, QStringList>::iterator dirIt = m_filesByDir.find(dirPath);
+        if(dirIt == m_filesByDir.end())
+            continue;
+        dirIt.value().removeAll(filePath);
+        if(dirIt.value().isEmpty())
+        {
+            m_filesByDir.erase(dirIt);
+            removeDirs.append(dirPath);
+        }
+    }
+
+    removeFiles += removeDirs;
+    if(!removeFiles.isEmpty())
+        m_watcher.removePaths(removeFiles);
+    if(!addFiles.isEmpty())
+    {
+        addFiles += addDirs;
+        addWatches(addFiles);
+    }
+
+    debugMsg("Watching %d source files in %d directories", m_modTimes.size(), m_filesByDir.size());
+}
+
+
+void SourceWatcher::onDirectoryChanged(const QString &dirPath)
+{
+    m_pendingDirs.insert(dirPath);
+    m_delayTimer.start();
+}
+
+
+void SourceWatcher::onFileChanged(const QString &filePath)
+{
+    m_pendingFiles.insert(filePath);
+    m_delayTimer.start();
+}
+
+
+/**
+ * @brief Checks the files with events once the changes have settled.
+ */
+void SourceWatcher::onDelayTimeout()
+{
+    QSet<QString> checkFiles = m_pendingFiles;
+    QSet<QString>::const_iterator dirIt = m_pendingDirs.constBegin();
+    for(;dirIt != m_pendingDirs.constEnd();++dirIt)
+    {
+        QStringList dirFiles = m_filesByDir.value(*dirIt);
+        for(int i = 0;i < dirFiles.size();i++)
+            checkFiles.insert(dirFiles[i]);
+    }
+    m_pendingFiles.clear();
+    m_pendingDirs.clear();
+
+    QStringList changedFiles;
+    QStringList rewatchFiles;
+    QSet<QString>::const_iterator it = checkFiles.constBegin();
+    for(;it != checkFiles.constEnd();++it)
+    {
+        QString filePath = *it;
+        QHash<QString, QDateTime>::iterator modIt = m_modTimes.find(filePath);
+        if(modIt == m_modTimes.end())
+            continue;
+
+        QDateTime modTime = getModTime(filePath);
+        if(modTime == modIt.value())
+            continue;
+        modIt.value() = modTime;
+
+        if(modTime.isValid())
+            changedFiles.append(filePath);
+    }
+
+    if(!changedFiles.isEmpty())
+    {
+        // The watch is lost if the file was replaced so watch them again
+        QStringList removeFiles;
+        for(int i = 0;i < changedFiles.size();i++)
+        {
+            QString filePath = changedFiles[i];
+            if(m_watchedFiles.remove(filePath))
+                removeFiles.append(filePath);
+            rewatchFiles.append(filePath);
+        }
+        if(!removeFiles.isEmpty())
+            m_watcher.removePaths(removeFiles);
+        addWatches(rewatchFiles);
+
+        debugMsg("%d source files changed", changedFiles.size());
+        emit filesChanged(changedFiles);
+    }
+}
+
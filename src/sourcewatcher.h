@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__SOURCEWATCHER_H
+#define FILE__SOURCEWATCHER_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+
+/**
+ * @brief Reports when the source files are modified.
+ *
+ * The directories of the files are watched to catch editors that save by
+ * replacing the file, and the files themselves to catch editors that write
+ * in place (inotify on Linux). Only the files in a directory with an event
+ * are checked. The events are collected until there has been no change for
+ * SOURCE_WATCHER_DELAY ms, so a save or a checkout is reported once.
+ *
+ * Files that can not be watched (eg: fs.inotify.max_user_watches is
+ * reached) are only checked when checkUnwatched() is called.
+ */
+class SourceWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    SourceWatcher();
+    virtual ~SourceWatcher();
+
+    void setFiles(QStringList filePathList);
+    void checkUnwatched();
+
+signals:
+    void filesChanged(QStringList filePathList);
+
+private slots:
+    void onDirectoryChanged(const QString &dirPath);
+    void onFileChanged(const QString &filePath);
+    void onDelayTimeout();
+
+private:
+    QDateTime getModTime(QString filePath) const;
+    void addWatches(QStringList pathList);
+
+private:
+    QFileSystemWatcher m_watcher;
+    QHash<QString, QDateTime> m_modTimes; //!< The watched files and when they were last modified.
+    QHash<QString, QStringList> m_filesByDir; //!< The watched files in each directory.
+    QSet<QString> m_pendingDirs; //!< Directories with events not yet checked.
+    QSet<QString> m_pendingFiles; //!< Files with events not yet checked.
+    QSet<QString> m_watchedFiles; //!< Files that the watcher has added.
+    QSet<QString> m_unwatchedFiles; //!< Files that the watcher failed to add.
+    bool m_unwatchedWarned;
+    QTimer m_delayTimer;
+};
+
+#endif // FILE__SOURCEWATCHER_H
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "stackgroups.h"
+
+#include <algorithm>
+
+#include "config.h"
+#include "log.h"
+
+
+static bool compareGroupSize(const StackGroup *g1, const StackGroup *g2)
+{
+    return g1->m_threadIds.size() > g2->m_threadIds.size();
+}
+
+
+StackGroupCollector::StackGroupCollector()
+    : m_totalCount(0)
+{
+    m_timer.setSingleShot(false);
+    m_timer.setInterval(0);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+
+StackGroupCollector::~StackGroupCollector()
+{
+    clear();
+}
+
+
+void StackGroupCollector::clear()
+{
+    for(int i = 0;i < m_groups.size();i++)
+        delete m_groups[i];
+    m_groups.clear();
+    m_groupLookup.clear();
+}
+
+
+/**
+ * @brief Starts to collect the backtraces of all threads.
+ */
+void StackGroupCollector::start()
+{
+    Core &core = Core::getInstance();
+
+    clear();
+    m_pendingThreadIds = core.getThreadIdList();
+    m_totalCount = m_pendingThreadIds.size();
+
+    m_timer.start();
+}
+
+
+void StackGroupCollector::abort()
+{
+    m_timer.stop();
+    m_pendingThreadIds.clear();
+}
+
+
+void StackGroupCollector::onTimeout()
+{
+    Core &core = Core::getInstance();
+
+    if(core.isRunning())
+    {
+        abort();
+        return;
+    }
+
+    // Get the next batch of threads
+    QList<int> batch = m_pendingThreadIds.mid(0, THREAD_GROUP_BATCH_SIZE);
+    m_pendingThreadIds = m_pendingThreadIds.mid(batch.size());
+
+    QMap<int, QList<StackFrameEntry> > stacks;
+    core.gdbGetThreadStacks(batch, THREAD_GROUP_MAX_DEPTH, &stacks);
+
+    QMap<int, QList<StackFrameEntry> >::const_iterator it = stacks.constBegin();
+    for(;it != stacks.constEnd();++it)
+        addStack(it.key(), it.value());
+
+    emit progress(m_totalCount - m_pendingThreadIds.size(), m_totalCount);
+
+    if(m_pendingThreadIds.isEmpty())
+    {
+        m_timer.stop();
+
+        std::stable_sort(m_groups.begin(), m_groups.end(), compareGroupSize);
+
+        debugMsg("%d threads in %d groups", m_totalCount, m_groups.size());
+        emit finished();
+    }
+}
+
+
+void StackGroupCollector::addStack(int threadId, const QList<StackFrameEntry> &frames)
+{
+    uint hash = hashStack(frames);
+
+    // Already got a thread with the same stack?
+    QMultiHash<uint, StackGroup*>::const_iterator it = m_groupLookup.constFind(hash);
+    for(;it != m_groupLookup.constEnd() && it.key() == hash;++it)
+    {
+        StackGroup *group = it.value();
+        if(isSameStack(group->m_frames, frames))
+        {
+            group->m_threadIds.append(threadId);
+            return;
+        }
+    }
+
+    StackGroup *group = new StackGroup;
+    group->m_hash = hash;
+    group->m_frames = frames;
+    group->m_threadIds.append(threadId);
+    m_groups.append(group);
+    m_groupLookup.insert(hash, group);
+}
+
+
+uint StackGroupCollector::hashStack(const QList<StackFrameEntry> &frames)
+{
+    uint hash = frames.size();
+    for(int i = 0;i < frames.size();i++)
+    {
+        const StackFrameEntry &entry = frames[i];
+        hash = hash*31 + qHash(entry.m_functionName);
+        hash = hash*31 + qHash(entry.m_sourcePath);
+        hash = hash*31 + (uint)entry.m_line;
+    }
+    return hash;
+}
+
+
+bool StackGroupCollector::isSameStack(const QList<StackFrameEntry> &a, const QList<StackFrameEntry> &b)
+{
+    if(a.size() != b.size())
+        return false;
+    for(int i = 0;i < a.size();i++)
+    {
+        if(a[i].m_line != b[i].m_line ||
+            a[i].m_functionName != b[i].m_functionName ||
+            a[i].m_sourcePath != b[i].m_sourcePath)
+            return false;
+    }
+    return true;
+}
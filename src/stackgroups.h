@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__STACKGROUPS_H
+#define FILE__STACKGROUPS_H
+
+#include <QObject>
+#include <QList>
+#include <QMultiHash>
+#include <QTimer>
+
+#include "core.h"
+
+
+/**
+ * @brief A set of threads that all have the same backtrace.
+ */
+class StackGroup
+{
+public:
+    StackGroup() : m_hash(0) {};
+
+    uint m_hash;
+    QList<StackFrameEntry> m_frames; //!< The backtrace (oldest frame first).
+    QList<int> m_threadIds; //!< The threads with this backtrace.
+};
+
+
+/**
+ * @brief Collects the backtrace of all threads and groups the threads with identical backtraces.
+ *
+ * The backtraces are requested from GDB in batches from the event loop
+ * so that the GUI stays responsive even with thousands of threads.
+ */
+class StackGroupCollector : public QObject
+{
+    Q_OBJECT
+
+public:
+    StackGroupCollector();
+    virtual ~StackGroupCollector();
+
+    void start();
+    void abort();
+    bool isBusy() const { return m_timer.isActive(); };
+
+    QList<StackGroup*> getGroups() const { return m_groups; };
+
+signals:
+    void progress(int doneCount, int totalCount);
+    void finished();
+
+private slots:
+    void onTimeout();
+
+private:
+    void clear();
+    void addStack(int threadId, const QList<StackFrameEntry> &frames);
+    static uint hashStack(const QList<StackFrameEntry> &frames);
+    static bool isSameStack(const QList<StackFrameEntry> &a, const QList<StackFrameEntry> &b);
+
+private:
+    QList<int> m_pendingThreadIds; //!< Threads to get backtraces for.
+    int m_totalCount;
+    QList<StackGroup*> m_groups;
+    QMultiHash<uint, StackGroup*> m_groupLookup; //!< Stack hash to group.
+    QTimer m_timer;
+};
+
+#endif // FILE__STACKGROUPS_H
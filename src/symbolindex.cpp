@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "symbolindex.h"
+
+#include <QProcessEnvironment>
+#include <QStringList>
+
+#include "config.h"
+#include "util.h"
+#include "log.h"
+
+
+SymbolIndexGenerator::SymbolIndexGenerator()
+{
+    m_process.setProcessChannelMode(QProcess::MergedChannels);
+    connect(&m_process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+}
+
+
+SymbolIndexGenerator::~SymbolIndexGenerator()
+{
+    if(isBusy())
+    {
+        m_process.kill();
+        m_process.waitForFinished(1000);
+    }
+}
+
+
+/**
+ * @brief Returns the name of the symbol index section in a program (or empty if it has none).
+ */
+QString SymbolIndexGenerator::getIndexSection(QString programPath)
+{
+    QStringList sectionNames = readElfSectionNames(programPath);
+    if(sectionNames.contains(".gdb_index"))
+        return ".gdb_index";
+    if(sectionNames.contains(".debug_names"))
+        return ".debug_names";
+    return "";
+}
+
+
+/**
+ * @brief Starts to add a symbol index section to a program.
+ * @param gdbPath   The GDB used to create the index.
+ * @return 0 if started.
+ */
+int SymbolIndexGenerator::start(QString gdbPath, QString programPath)
+{
+    if(isBusy() || programPath.isEmpty())
+        return -1;
+
+    if(!exeExists(GDB_ADD_INDEX_CMD))
+    {
+        warnMsg("Unable to find '%s' (it is shipped with GDB)", GDB_ADD_INDEX_CMD);
+        return -1;
+    }
+
+    QString existingSection = getIndexSection(programPath);
+    if(!existingSection.isEmpty())
+    {
+        infoMsg("%s already has a %s section", stringToCStr(programPath), stringToCStr(existingSection));
+        return -1;
+    }
+
+    // .debug_names is the index defined by DWARF 5
+    QStringList args;
+    m_sectionName = ".gdb_index";
+    if(readElfDwarfVersion(programPath) >= 5)
+    {
+        args.append("-dwarf-5");
+        m_sectionName = ".debug_names";
+    }
+    args.append(programPath);
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("GDB", gdbPath);
+    m_process.setProcessEnvironment(env);
+
+    infoMsg("Adding a %s section to %s", stringToCStr(m_sectionName), stringToCStr(programPath));
+    m_programPath = programPath;
+    m_timer.start();
+    m_process.start(GDB_ADD_INDEX_CMD, args);
+    return 0;
+}
+
+
+void SymbolIndexGenerator::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QString output = QString(m_process.readAll()).trimmed();
+
+    bool success = false;
+    if(exitStatus == QProcess::NormalExit && exitCode == 0 && !getIndexSection(m_programPath).isEmpty())
+        success = true;
+
+    if(success)
+    {
+        infoMsg("Added %s to %s in %d ms. It is used the next time the program is loaded.",
+                stringToCStr(m_sectionName), stringToCStr(m_programPath), (int)m_timer.elapsed());
+    }
+    else
+        warnMsg("Failed to add a symbol index to %s: %s", stringToCStr(m_programPath), stringToCStr(output));
+
+    emit finished(success);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__SYMBOLINDEX_H
+#define FILE__SYMBOLINDEX_H
+
+#include <QObject>
+#include <QProcess>
+#include <QElapsedTimer>
+
+
+/**
+ * @brief Adds a symbol index section to a program in the background.
+ *
+ * GDB reads the index instead of scanning all the debug info when the
+ * program is loaded. The 'gdb-add-index' script that is shipped with GDB
+ * does the actual work.
+ */
+class SymbolIndexGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    SymbolIndexGenerator();
+    virtual ~SymbolIndexGenerator();
+
+    int start(QString gdbPath, QString programPath);
+    bool isBusy() const { return m_process.state() != QProcess::NotRunning; };
+
+    static QString getIndexSection(QString programPath);
+
+signals:
+    void finished(bool success);
+
+private slots:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    QProcess m_process;
+    QString m_programPath;
+    QString m_sectionName; //!< The section that is being added.
+    QElapsedTimer m_timer;
+};
+
+#endif // FILE__SYMBOLINDEX_H
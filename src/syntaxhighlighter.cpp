@@ -9,3 +9,592 @@
 
 #include "syntaxhighlighter.h"
 
+#include <assert.h>
+#include <algorithm>
+
+#include "config.h"
+#include "log.h"
+
+
+KeywordTable::KeywordTable()
+    : m_mask(0)
+    ,m_seed(0)
+    ,m_maxLength(0)
+    ,m_caseSensitive(true)
+{
+}
+
+
+static inline ushort toLowerChar(QChar c)
+{
+    ushort u = c.unicode();
+    if(u < 128)
+        return (u >= 'A' && u <= 'Z') ? (ushort)(u + ('a'-'A')) : u;
+    return c.toLower().unicode();
+}
+
+
+unsigned int KeywordTable::hash(const QChar *str, int len, unsigned int seed) const
+{
+    unsigned int h = 2166136261u ^ (seed * 16777619u);
+    for(int i = 0;i < len;i++)
+    {
+        h ^= m_caseSensitive ? str[i].unicode() : toLowerChar(str[i]);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+
+/**
+ * @brief Creates the table.
+ *
+ * Searches for a seed that gives each keyword a slot of its own. The table
+ * is made larger if no seed is found, up to a limit where a QSet is used
+ * instead.
+ */
+void KeywordTable::init(QStringList keywordList, bool caseSensitive)
+{
+    m_caseSensitive = caseSensitive;
+    m_maxLength = 0;
+    m_slots.clear();
+    m_fallbackSet.clear();
+
+    QStringList list;
+    for(int i = 0;i < keywordList.size();i++)
+    {
+        QString keyword = caseSensitive ? keywordList[i] : keywordList[i].toLower();
+        if(!keyword.isEmpty())
+            list.append(keyword);
+    }
+    list.removeDuplicates();
+    if(list.isEmpty())
+        return;
+
+    for(int i = 0;i < list.size();i++)
+        m_maxLength = std::max(m_maxLength, (int)list[i].length());
+
+    unsigned int size = 8;
+    while(size < (unsigned int)list.size()*2)
+        size *= 2;
+    unsigned int maxSize = std::min((quint64)list.size()*list.size()*4, (quint64)KEYWORD_TABLE_MAX_SIZE);
+    maxSize = std::max(size, maxSize);
+    for(;size <= maxSize;size *= 2)
+    {
+        for(unsigned int seed = 1;seed < 1000;seed++)
+        {
+            QVector<QString> slotList(size);
+            bool collision = false;
+            for(int i = 0;i < list.size() && !collision;i++)
+            {
+                const QString &keyword = list[i];
+                unsigned int slotIdx = hash(keyword.constData(), keyword.length(), seed) & (size-1);
+                if(slotList[slotIdx].isEmpty())
+                    slotList[slotIdx] = keyword;
+                else
+                    collision = true;
+            }
+            if(collision)
+                continue;
+
+            m_slots = slotList;
+            m_mask = size-1;
+            m_seed = seed;
+            return;
+        }
+    }
+
+    debugMsg("No perfect hash found for %d keywords", list.size());
+    for(int i = 0;i < list.size();i++)
+        m_fallbackSet.insert(list[i]);
+}
+
+
+/**
+ * @brief Checks if a string is one of the keywords.
+ */
+bool KeywordTable::contains(const QChar *str, int len) const
+{
+    if(len == 0 || len > m_maxLength)
+        return false;
+
+    if(!m_fallbackSet.isEmpty())
+    {
+        QString word(str, len);
+        return m_fallbackSet.contains(m_caseSensitive ? word : word.toLower());
+    }
+
+    const QString &keyword = m_slots[hash(str, len, m_seed) & m_mask];
+    if(keyword.length() != len)
+        return false;
+    const QChar *keywordStr = keyword.constData();
+    for(int i = 0;i < len;i++)
+    {
+        ushort u = m_caseSensitive ? str[i].unicode() : toLowerChar(str[i]);
+        if(u != keywordStr[i].unicode())
+            return false;
+    }
+    return true;
+}
+
+
+
+SyntaxLanguage::SyntaxLanguage()
+    : m_lineCommentAtStartOnly(false)
+    ,m_hasPreprocessor(false)
+    ,m_hasCharLiterals(true)
+    ,m_hasStringEscapes(true)
+    ,m_hasArrow(false)
+    ,m_hasRemComment(false)
+{
+    for(int i = 0;i < 128;i++)
+    {
+        m_charClass[i] = CC_WORD;
+        m_isSpecial[i] = false;
+        m_isWordEnd[i] = false;
+    }
+    m_charClass[(int)' '] = CC_SPACE;
+    m_charClass[(int)'\t'] = CC_SPACE;
+    m_charClass[(int)'\n'] = CC_NEWLINE;
+    m_charClass[(int)'\''] = CC_QUOTE;
+    m_charClass[(int)'"'] = CC_DQUOTE;
+
+    m_isWordEnd[(int)' '] = true;
+    m_isWordEnd[(int)'\t'] = true;
+    m_isWordEnd[(int)'\n'] = true;
+    m_isWordEnd[(int)'"'] = true;
+}
+
+
+/**
+ * @brief Sets the characters that are tokens of their own and ends words.
+ */
+void SyntaxLanguage::setSpecialChars(const char *chars)
+{
+    for(int i = 0;chars[i] != '\0';i++)
+    {
+        int c = (unsigned char)chars[i];
+        if(c >= 128)
+            continue;
+        m_isSpecial[c] = true;
+        m_isWordEnd[c] = true;
+        if(c == '#')
+            m_charClass[c] = CC_HASH;
+        else if(c == '<')
+            m_charClass[c] = CC_LT;
+        else if(c == '>')
+            m_charClass[c] = CC_GT;
+        else
+            m_charClass[c] = CC_SPECIAL;
+    }
+}
+
+
+/**
+ * @brief Sets the comment delimiters (an empty string if the language has none).
+ *
+ * Must be called after setSpecialChars().
+ */
+void SyntaxLanguage::setComments(const char *lineComment, const char *blockStart, const char *blockEnd)
+{
+    m_lineComment = lineComment;
+    m_blockCommentStart = blockStart;
+    m_blockCommentEnd = blockEnd;
+    assert(m_lineComment.length() <= 2);
+    assert(m_blockCommentStart.isEmpty() || m_blockCommentStart.length() == 2);
+    assert(m_blockCommentStart.length() == m_blockCommentEnd.length());
+
+    if(!m_lineComment.isEmpty() && m_lineComment[0].unicode() < 128)
+        m_charClass[m_lineComment[0].unicode()] = CC_COMMENT;
+    if(!m_blockCommentStart.isEmpty() && m_blockCommentStart[0].unicode() < 128)
+        m_charClass[m_blockCommentStart[0].unicode()] = CC_COMMENT;
+}
+
+
+
+SyntaxHighlighter::SyntaxHighlighter(const SyntaxLanguage *lang)
+    : m_lang(lang)
+{
+    for(int i = 0;i < TextField::TYPE_COUNT;i++)
+        m_colors[i] = Qt::white;
+    reset();
+}
+
+
+SyntaxHighlighter::~SyntaxHighlighter()
+{
+}
+
+
+/**
+ * @brief Removes all the rows.
+ */
+void SyntaxHighlighter::reset()
+{
+    m_text.clear();
+    m_fields.clear();
+    m_rowStart.clear();
+    m_rowStart.append(0);
+}
+
+
+/**
+ * @brief Sets the configuration to use.
+ */
+void SyntaxHighlighter::setConfig(Settings *cfg)
+{
+    if(cfg == NULL)
+        return;
+
+    for(int i = 0;i < TextField::TYPE_COUNT;i++)
+        m_colors[i] = cfg->m_clrForeground;
+    m_colors[TextField::COMMENT] = cfg->m_clrComment;
+    m_colors[TextField::STRING] = cfg->m_clrString;
+    m_colors[TextField::INC_STRING] = cfg->m_clrIncString;
+    m_colors[TextField::KEYWORD] = cfg->m_clrKeyword;
+    m_colors[TextField::CPP_KEYWORD] = cfg->m_clrCppKeyword;
+    m_colors[TextField::NUMBER] = cfg->m_clrNumber;
+}
+
+
+/**
+ * @brief Checks if a character is a special character.
+ * @return Returns true if the character is a special character (Eg: '(').
+*/
+bool SyntaxHighlighter::isSpecialChar(char c) const
+{
+    int u = (unsigned char)c;
+    return u < 128 ? m_lang->m_isSpecial[u] : false;
+}
+
+
+/**
+ * @brief Checks if a field is a special character (eg: '>').
+ */
+bool SyntaxHighlighter::isSpecialChar(const TextField &field) const
+{
+    if(field.m_length == 1)
+        return isSpecialChar(m_text[field.m_start].toLatin1());
+    return false;
+}
+
+
+/**
+ * @brief Checks if a string is a keyword.
+ */
+bool SyntaxHighlighter::isKeyword(QString text) const
+{
+    return m_lang->m_keywords.contains(text.constData(), text.length());
+}
+
+
+/**
+ * @brief Returns the fields of a row.
+ * @param rowIdx       The row to get (0=first row).
+ * @return fieldCount  The number of fields in the row.
+ */
+const TextField *SyntaxHighlighter::getRow(unsigned int rowIdx, int *fieldCount) const
+{
+    assert(rowIdx < getRowCount());
+
+    int first = m_rowStart[rowIdx];
+    *fieldCount = m_rowStart[rowIdx+1] - first;
+    return m_fields.constData() + first;
+}
+
+
+/**
+ * @brief Returns the text of a row.
+ */
+QString SyntaxHighlighter::getRowText(unsigned int rowIdx) const
+{
+    int fieldCount = 0;
+    const TextField *fields = getRow(rowIdx, &fieldCount);
+    if(fieldCount == 0)
+        return QString();
+    const TextField &lastField = fields[fieldCount-1];
+    return m_text.mid(fields[0].m_start, lastField.m_start + lastField.m_length - fields[0].m_start);
+}
+
+
+void SyntaxHighlighter::addField(int start, int end, TextField::Type type)
+{
+    if(end <= start)
+        return;
+    TextField field;
+    field.m_start = start;
+    field.m_length = end-start;
+    field.m_type = type;
+    m_fields.append(field);
+}
+
+
+/**
+ * @brief Checks if the text of a field is a string (case insensitive).
+ */
+bool SyntaxHighlighter::fieldEquals(const TextField &field, const char *str) const
+{
+    const QChar *text = m_text.constData() + field.m_start;
+    int i;
+    for(i = 0;i < field.m_length && str[i] != '\0';i++)
+    {
+        if(toLowerChar(text[i]) != (ushort)str[i])
+            return false;
+    }
+    return i == field.m_length && str[i] == '\0';
+}
+
+
+/**
+ * @brief Returns the index of the last field in the current row that is not spaces or a comment (or -1).
+ */
+int SyntaxHighlighter::getLastNonSpaceField(int rowFirstField) const
+{
+    for(int j = m_fields.size()-1;j >= rowFirstField;j--)
+    {
+        const TextField &field = m_fields[j];
+        if(field.m_type != TextField::SPACES && field.m_type != TextField::COMMENT)
+            return j;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Splits a text into rows of colored fields.
+ *
+ * Each token is read by a tight loop over the character class table of the
+ * language. Fields only refer to the text, so nothing is copied.
+ */
+void SyntaxHighlighter::colorize(QString text)
+{
+    const SyntaxLanguage &lang = *m_lang;
+
+    reset();
+    m_text = text;
+    m_fields.reserve(m_text.length()/3);
+
+    const QChar *str = m_text.constData();
+    const int len = m_text.length();
+    const bool hasLineComment2 = lang.m_lineComment.length() == 2;
+    const bool hasBlockComment = !lang.m_blockCommentStart.isEmpty();
+    const QChar blockEnd0 = hasBlockComment ? lang.m_blockCommentEnd[0] : QChar();
+    const QChar blockEnd1 = hasBlockComment ? lang.m_blockCommentEnd[1] : QChar();
+
+    int rowFirstField = 0;
+    bool isCppRow = false;
+    bool isRowStart = true; // Only spaces so far in the row?
+    bool inBlockComment = false;
+    int i = 0;
+    while(i < len)
+    {
+        const int start = i;
+        const QChar c = str[i];
+        const unsigned char cc = lang.getCharClass(c);
+
+        if(cc == SyntaxLanguage::CC_NEWLINE)
+        {
+            i++;
+            m_rowStart.append(m_fields.size());
+            rowFirstField = m_fields.size();
+            isCppRow = false;
+            isRowStart = true;
+            continue;
+        }
+
+        // Inside a comment that started on an earlier row?
+        if(inBlockComment)
+        {
+            while(i < len && str[i] != '\n')
+            {
+                if(str[i] == blockEnd0 && i+1 < len && str[i+1] == blockEnd1)
+                {
+                    i += 2;
+                    inBlockComment = false;
+                    break;
+                }
+                i++;
+            }
+            addField(start, i, TextField::COMMENT);
+            isRowStart = false;
+            continue;
+        }
+
+        if(cc == SyntaxLanguage::CC_SPACE)
+        {
+            while(i < len && lang.getCharClass(str[i]) == SyntaxLanguage::CC_SPACE)
+                i++;
+            addField(start, i, TextField::SPACES);
+            continue;
+        }
+
+        bool isWord = false;
+        switch(cc)
+        {
+            case SyntaxLanguage::CC_COMMENT:
+            {
+                QChar next = i+1 < len ? str[i+1] : QChar();
+                if(lang.m_lineComment.length() == 1 && c == lang.m_lineComment[0])
+                {
+                    if(lang.m_lineCommentAtStartOnly && !isRowStart)
+                    {
+                        isWord = true;
+                        break;
+                    }
+                    while(i < len && str[i] != '\n')
+                        i++;
+                    addField(start, i, TextField::COMMENT);
+                }
+                else if(hasLineComment2 && c == lang.m_lineComment[0] && next == lang.m_lineComment[1])
+                {
+                    while(i < len && str[i] != '\n')
+                        i++;
+                    addField(start, i, TextField::COMMENT);
+                }
+                else if(hasBlockComment && c == lang.m_blockCommentStart[0] && next == lang.m_blockCommentStart[1])
+                {
+                    inBlockComment = true;
+                    i += 2;
+                    while(i < len && str[i] != '\n')
+                    {
+                        if(str[i] == blockEnd0 && i+1 < len && str[i+1] == blockEnd1)
+                        {
+                            i += 2;
+                            inBlockComment = false;
+                            break;
+                        }
+                        i++;
+                    }
+                    addField(start, i, TextField::COMMENT);
+                }
+                else if(lang.m_isSpecial[c.unicode()])
+                {
+                    i++;
+                    addField(start, i, TextField::WORD);
+                }
+                else
+                    isWord = true;
+            };break;
+            case SyntaxLanguage::CC_QUOTE:
+            case SyntaxLanguage::CC_DQUOTE:
+            {
+                if(cc == SyntaxLanguage::CC_QUOTE && !lang.m_hasCharLiterals)
+                {
+                    isWord = true;
+                    break;
+                }
+
+                // Read until the end quote or the end of the row
+                bool isEscaped = false;
+                i++;
+                while(i < len && str[i] != '\n')
+                {
+                    QChar c2 = str[i++];
+                    if(isEscaped)
+                        isEscaped = false;
+                    else if(c2 == '\\' && lang.m_hasStringEscapes)
+                        isEscaped = true;
+                    else if(c2 == c)
+                        break;
+                }
+                if(cc == SyntaxLanguage::CC_DQUOTE && isCppRow)
+                    addField(start, i, TextField::INC_STRING);
+                else
+                    addField(start, i, TextField::STRING);
+            };break;
+            case SyntaxLanguage::CC_HASH:
+            {
+                i++;
+                if(lang.m_hasPreprocessor)
+                {
+                    // Only spaces before the '#' at the line?
+                    isCppRow = getLastNonSpaceField(rowFirstField) == -1;
+                    addField(start, i, isCppRow ? TextField::CPP_KEYWORD : TextField::WORD);
+                }
+                else
+                    addField(start, i, TextField::WORD);
+            };break;
+            case SyntaxLanguage::CC_LT:
+            {
+                i++;
+
+                // Is it a include string?
+                int lastFieldIdx = isCppRow ? getLastNonSpaceField(rowFirstField) : -1;
+                if(lastFieldIdx != -1 && fieldEquals(m_fields[lastFieldIdx], "include"))
+                {
+                    bool isEscaped = false;
+                    while(i < len && str[i] != '\n')
+                    {
+                        QChar c2 = str[i++];
+                        if(isEscaped)
+                            isEscaped = false;
+                        else if(c2 == '\\' && lang.m_hasStringEscapes)
+                            isEscaped = true;
+                        else if(c2 == '>')
+                            break;
+                    }
+                    addField(start, i, TextField::INC_STRING);
+                }
+                else
+                    addField(start, i, TextField::WORD);
+            };break;
+            case SyntaxLanguage::CC_GT:
+            {
+                i++;
+
+                // An '->' token?
+                if(lang.m_hasArrow && m_fields.size() > rowFirstField)
+                {
+                    TextField &lastField = m_fields.last();
+                    if(lastField.m_length == 1 && lastField.m_start+1 == start && str[lastField.m_start] == '-')
+                    {
+                        lastField.m_length++;
+                        break;
+                    }
+                }
+                addField(start, i, TextField::WORD);
+            };break;
+            case SyntaxLanguage::CC_SPECIAL:
+            {
+                i++;
+                addField(start, i, TextField::WORD);
+            };break;
+            default:
+            {
+                isWord = true;
+            };break;
+        }
+
+        if(isWord)
+        {
+            i++;
+            while(i < len && !lang.isWordEnd(str[i]))
+                i++;
+
+            TextField::Type type = c.isDigit() ? TextField::NUMBER : TextField::WORD;
+            if(isCppRow && lang.m_cppKeywords.contains(str+start, i-start))
+                type = TextField::CPP_KEYWORD;
+            else if(lang.m_keywords.contains(str+start, i-start))
+                type = TextField::KEYWORD;
+            else if(lang.m_hasRemComment && i-start == 3)
+            {
+                TextField word;
+                word.m_start = start;
+                word.m_length = i-start;
+                word.m_type = type;
+
+                // The rest of the row is a comment?
+                if(fieldEquals(word, "rem"))
+                {
+                    while(i < len && str[i] != '\n')
+                        i++;
+                    type = TextField::COMMENT;
+                }
+            }
+            addField(start, i, type);
+        }
+        isRowStart = false;
+    }
+    m_rowStart.append(m_fields.size());
+}
+
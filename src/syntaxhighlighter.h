@@ -11,40 +11,154 @@
 
 #include <QVector>
 #include <QString>
+#include <QStringList>
+#include <QSet>
 #include <QColor>
-#include <QHash>
 
 #include "settings.h"
 
 
+/**
+ * @brief A token in a row.
+ *
+ * The text of the token is not stored in the field but in the text given to
+ * SyntaxHighlighter::colorize(). Use SyntaxHighlighter::getText() to get it.
+ */
 struct TextField
 {
-    QColor m_color;
-    QString m_text;
-    enum {COMMENT, WORD, NUMBER, KEYWORD, CPP_KEYWORD, INC_STRING, STRING, SPACES} m_type;
+    enum Type {COMMENT, WORD, NUMBER, KEYWORD, CPP_KEYWORD, INC_STRING, STRING, SPACES, TYPE_COUNT};
+
+    int m_start; //!< Index of the first character in the text.
+    int m_length;
+    Type m_type;
 
-    bool isHash() const { return m_text == "#" ? true : false; };
     bool isSpaces() const { return m_type == SPACES ? true : false; };
-    int getLength() { return m_text.length(); };
+    int getLength() const { return m_length; };
+};
+
+
+/**
+ * @brief A set of keywords with a perfect hash.
+ *
+ * The hash seed and table size are searched for when the table is created
+ * so that each keyword has a slot of its own. A lookup is one hash and at
+ * most one compare.
+ */
+class KeywordTable
+{
+public:
+    KeywordTable();
+
+    void init(QStringList keywordList, bool caseSensitive);
+    bool contains(const QChar *str, int len) const;
+
+private:
+    unsigned int hash(const QChar *str, int len, unsigned int seed) const;
+
+private:
+    QVector<QString> m_slots; //!< Empty for unused slots.
+    QSet<QString> m_fallbackSet; //!< Used instead of m_slots if no seed was found.
+    unsigned int m_mask;
+    unsigned int m_seed;
+    int m_maxLength;
+    bool m_caseSensitive;
+};
+
+
+/**
+ * @brief Describes how to split the text of a language into tokens.
+ */
+class SyntaxLanguage
+{
+public:
+    enum CharClass {
+        CC_WORD = 0,
+        CC_SPACE,
+        CC_NEWLINE,
+        CC_SPECIAL, //!< A single character token (Eg: '(').
+        CC_QUOTE, //!< '\''
+        CC_DQUOTE, //!< '"'
+        CC_HASH, //!< '#'
+        CC_LT, //!< '<'
+        CC_GT, //!< '>'
+        CC_COMMENT //!< The first character of a comment.
+    };
+
+    SyntaxLanguage();
+
+    void setSpecialChars(const char *chars);
+    void setComments(const char *lineComment, const char *blockStart, const char *blockEnd);
+
+    unsigned char getCharClass(QChar c) const
+    {
+        ushort u = c.unicode();
+        return u < 128 ? m_charClass[u] : (unsigned char)CC_WORD;
+    };
+
+    bool isWordEnd(QChar c) const
+    {
+        ushort u = c.unicode();
+        return u < 128 ? m_isWordEnd[u] : false;
+    };
+
+    unsigned char m_charClass[128];
+    bool m_isSpecial[128]; //!< True for characters set with setSpecialChars().
+    bool m_isWordEnd[128]; //!< True for characters that ends a word.
+
+    QString m_lineComment; //!< Eg: "//".
+    QString m_blockCommentStart; //!< Eg: "/*".
+    QString m_blockCommentEnd; //!< Eg: "*/".
+    bool m_lineCommentAtStartOnly; //!< True if the line comment must be first on the row (Fortran).
+    bool m_hasPreprocessor; //!< '#' first on a row starts a preprocessor row.
+    bool m_hasCharLiterals; //!< '\'' starts a character literal.
+    bool m_hasStringEscapes; //!< '\' escapes the next character in strings.
+    bool m_hasArrow; //!< "->" is a token.
+    bool m_hasRemComment; //!< The word "rem" starts a comment (Basic).
+
+    KeywordTable m_keywords;
+    KeywordTable m_cppKeywords;
 };
 
 
+/**
+ * @brief Splits a text into colored tokens.
+ *
+ * The same lexer is used for all languages. What differs is the
+ * SyntaxLanguage table given by the subclass. The tokens of all rows are
+ * stored after each other in one array.
+ */
 class SyntaxHighlighter
 {
 public:
-    SyntaxHighlighter(){};
-    virtual ~SyntaxHighlighter(){};
-    
-    virtual void colorize(QString text) = 0;
-
-    virtual QVector<TextField*> getRow(unsigned int rowIdx) = 0;
-    virtual unsigned int getRowCount() = 0;
-    virtual void reset() = 0;
-
-    virtual bool isKeyword(QString text) const = 0;
-    virtual bool isSpecialChar(char c) const = 0;
-    virtual bool isSpecialChar(TextField *field) const = 0;
-    virtual void setConfig(Settings *cfg) = 0;
+    SyntaxHighlighter(const SyntaxLanguage *lang);
+    virtual ~SyntaxHighlighter();
+
+    void colorize(QString text);
+
+    const TextField *getRow(unsigned int rowIdx, int *fieldCount) const;
+    unsigned int getRowCount() const { return m_rowStart.size()-1; };
+    QString getText(const TextField &field) const { return m_text.mid(field.m_start, field.m_length); };
+    QString getRowText(unsigned int rowIdx) const;
+    void reset();
+
+    const QColor &getColor(const TextField &field) const { return m_colors[field.m_type]; };
+
+    bool isKeyword(QString text) const;
+    bool isSpecialChar(char c) const;
+    bool isSpecialChar(const TextField &field) const;
+    void setConfig(Settings *cfg);
+
+private:
+    void addField(int start, int end, TextField::Type type);
+    bool fieldEquals(const TextField &field, const char *str) const;
+    int getLastNonSpaceField(int rowFirstField) const;
+
+private:
+    const SyntaxLanguage *m_lang;
+    QString m_text;
+    QVector<TextField> m_fields;
+    QVector<int> m_rowStart; //!< Index in m_fields of the first field of each row (and one after the last row).
+    QColor m_colors[TextField::TYPE_COUNT];
 };
 
 #endif // #ifndef FILE__SYNTAXHIGHLIGHTER
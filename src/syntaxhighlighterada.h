@@ -10,12 +10,6 @@
 #define  FILE__SYNTAXHIGHLIGHTERADA_H
 
 
-#include <QVector>
-#include <QString>
-#include <QColor>
-#include <QHash>
-
-#include "settings.h"
 #include "syntaxhighlighter.h"
 
 
@@ -25,37 +19,9 @@ class SyntaxHighlighterAda : public SyntaxHighlighter
 public:
     SyntaxHighlighterAda();
     virtual ~SyntaxHighlighterAda();
-    
-    void colorize(QString text);
-
-    QVector<TextField*> getRow(unsigned int rowIdx);
-    unsigned int getRowCount() { return m_rows.size(); };
-    void reset();
-
-    bool isKeyword(QString text) const;
-    bool isSpecialChar(char c) const;
-    bool isSpecialChar(TextField *field) const;
-    void setConfig(Settings *cfg);
-
-private:
-    class Row
-    {
-    public:
-        Row();
-
-        TextField *getLastNonSpaceField();
-        void appendField(TextField* field);
-        int getCharCount();
-        
-        QVector<TextField*>  m_fields;
-    };
-private:
-    void pickColor(TextField *field);
 
 private:
-    Settings *m_cfg;
-    QVector <Row*> m_rows;
-    QHash <QString, bool> m_keywords;
+    static const SyntaxLanguage *getLanguage();
 };
 
-#endif // #ifndef FILE__SYNTAXHIGHLIGHTER_H
+#endif // #ifndef FILE__SYNTAXHIGHLIGHTERADA_H
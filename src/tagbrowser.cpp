@@ -0,0 +1,516 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "tagbrowser.h"
+
+#include <QBrush>
+#include <QHash>
+#include <QMap>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+#include "util.h"
+#include "log.h"
+#include "tracelog.h"
+
+
+/**
+ * @brief Number of rows to filter between checking for a newer request.
+ */
+#define STALE_CHECK_INTERVAL 4096
+
+
+class FunctionNameLess
+{
+public:
+    bool operator()(const TagBrowserIndex::Function &a, const TagBrowserIndex::Function &b) const
+    {
+        return a.m_name < b.m_name;
+    }
+};
+
+
+/**
+ * @brief Builds the index from the tags of a set of files.
+ */
+void TagBrowserIndex::build(const QList<QList<Tag> > &tagLists)
+{
+    m_functions.clear();
+    m_classes.clear();
+
+    QHash<QString, QString> fileNames;
+    QMap<QString, QVector<int> > classFuncs;
+    for(int k = 0;k < tagLists.size();k++)
+    {
+        const QList<Tag> &tagList = tagLists[k];
+        for(int i = 0;i < tagList.size();i++)
+        {
+            const Tag &tag = tagList[i];
+            if(!tag.m_className.isEmpty() && !classFuncs.contains(tag.m_className))
+                classFuncs.insert(tag.m_className, QVector<int>());
+            if(!tag.isFunc())
+                continue;
+
+            Function func;
+            func.m_memberName = tag.getName() + tag.getSignature();
+            if(tag.m_className.isEmpty())
+                func.m_name = " " + func.m_memberName; // Free functions are listed first
+            else
+                func.m_name = tag.getLongName();
+            func.m_key = tag.getLongName().toLower();
+            func.m_filePath = tag.m_filepath;
+            QHash<QString, QString>::const_iterator it = fileNames.constFind(tag.m_filepath);
+            if(it == fileNames.constEnd())
+                it = fileNames.insert(tag.m_filepath, getFilenamePart(tag.m_filepath));
+            func.m_fileName = it.value();
+            func.m_lineNo = tag.getLineNo();
+            func.m_className = tag.m_className;
+            m_functions.append(func);
+        }
+    }
+    std::sort(m_functions.begin(), m_functions.end(), FunctionNameLess());
+
+    for(int funcIdx = 0;funcIdx < m_functions.size();funcIdx++)
+    {
+        const Function &func = m_functions[funcIdx];
+        if(!func.m_className.isEmpty())
+            classFuncs[func.m_className].append(funcIdx);
+    }
+
+    m_classes.reserve(classFuncs.size());
+    QMap<QString, QVector<int> >::const_iterator it = classFuncs.constBegin();
+    for(;it != classFuncs.constEnd();++it)
+    {
+        Class cls;
+        cls.m_name = it.key();
+        cls.m_key = it.key().toLower();
+        cls.m_funcIdxs = it.value();
+        m_classes.append(cls);
+    }
+}
+
+
+
+TagBrowserFilter::TagBrowserFilter(QString text)
+{
+    QStringList list = text.split(";");
+    for(int i = 0;i < list.size();i++)
+    {
+        QString item = list[i].trimmed().toLower();
+        if(item.isEmpty())
+            continue;
+        bool isPlain = !item.contains('*') && !item.contains('?');
+        m_patterns.append(isPlain ? item : ("*" + item + "*"));
+        m_isPlain.append(isPlain);
+    }
+}
+
+
+/**
+ * @brief Checks if a wildcard pattern matches all of a string.
+ */
+static bool wildcardMatch(const QString &str, const QString &pattern)
+{
+    int strLen = str.length();
+    int patLen = pattern.length();
+    int s = 0;
+    int p = 0;
+    int starP = -1; // Position of the last '*' in the pattern
+    int starS = 0; // Position in str that the last '*' matches to
+    while(s < strLen)
+    {
+        if(p < patLen && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            s++;
+            p++;
+        }
+        else if(p < patLen && pattern[p] == '*')
+        {
+            starP = p++;
+            starS = s;
+        }
+        else if(starP != -1)
+        {
+            // Let the last '*' match one more character
+            p = starP + 1;
+            s = ++starS;
+        }
+        else
+            return false;
+    }
+    while(p < patLen && pattern[p] == '*')
+        p++;
+    return p == patLen;
+}
+
+
+bool TagBrowserFilter::matches(const QString &key) const
+{
+    for(int i = 0;i < m_patterns.size();i++)
+    {
+        if(m_isPlain[i])
+        {
+            if(!key.contains(m_patterns[i]))
+                return false;
+        }
+        else if(!wildcardMatch(key, m_patterns[i]))
+            return false;
+    }
+    return true;
+}
+
+
+
+TagBrowserWorker::TagBrowserWorker()
+    : m_quit(false)
+    ,m_requestSeq(0)
+    ,m_doneSeq(0)
+    ,m_changed(0)
+    ,m_hasNewTags(false)
+{
+    qRegisterMetaType<TagBrowserResult>("TagBrowserResult");
+}
+
+
+TagBrowserWorker::~TagBrowserWorker()
+{
+    m_mutex.lock();
+    m_quit = true;
+    m_mutex.unlock();
+    m_wait.wakeAll();
+    wait();
+}
+
+
+void TagBrowserWorker::setTags(const QList<QList<Tag> > &tagLists)
+{
+    m_mutex.lock();
+    m_newTags = tagLists;
+    m_hasNewTags = true;
+    m_mutex.unlock();
+    queueRequest(TagBrowserResult::FUNCTIONS | TagBrowserResult::CLASSES);
+}
+
+
+void TagBrowserWorker::setFuncFilter(QString text)
+{
+    m_mutex.lock();
+    m_funcFilter = text;
+    m_mutex.unlock();
+    queueRequest(TagBrowserResult::FUNCTIONS);
+}
+
+
+void TagBrowserWorker::setClassFilter(QString text)
+{
+    m_mutex.lock();
+    m_classFilter = text;
+    m_mutex.unlock();
+    queueRequest(TagBrowserResult::CLASSES);
+}
+
+
+void TagBrowserWorker::queueRequest(int changed)
+{
+    m_mutex.lock();
+    m_changed |= changed;
+    m_requestSeq++;
+    m_mutex.unlock();
+
+    if(!isRunning())
+        start();
+    m_wait.wakeAll();
+}
+
+
+/**
+ * @brief Checks if a newer request has been queued.
+ */
+bool TagBrowserWorker::isStale(int requestSeq)
+{
+    QMutexLocker locker(&m_mutex);
+    return requestSeq != m_requestSeq || m_quit;
+}
+
+
+void TagBrowserWorker::run()
+{
+    m_mutex.lock();
+    while(!m_quit)
+    {
+        if(m_doneSeq == m_requestSeq)
+        {
+            m_wait.wait(&m_mutex);
+            continue;
+        }
+
+        // Take the latest request
+        int requestSeq = m_requestSeq;
+        int changed = m_changed;
+        bool hasNewTags = m_hasNewTags;
+        QList<QList<Tag> > tagLists = m_newTags;
+        m_hasNewTags = false;
+        m_newTags.clear();
+        TagBrowserFilter funcFilter(m_funcFilter);
+        TagBrowserFilter classFilter(m_classFilter);
+        m_mutex.unlock();
+
+        if(hasNewTags)
+        {
+            TraceScope traceScope("tags", "Build browser index");
+            m_index = QSharedPointer<TagBrowserIndex>(new TagBrowserIndex);
+            m_index->build(tagLists);
+            tagLists.clear();
+        }
+
+        TagBrowserResult result;
+        result.m_index = m_index;
+        result.m_changed = changed;
+        bool isDone = !m_index.isNull();
+        if(isDone && (changed & TagBrowserResult::FUNCTIONS))
+        {
+            const QVector<TagBrowserIndex::Function> &functions = m_index->m_functions;
+            for(int i = 0;i < functions.size() && isDone;i++)
+            {
+                if(funcFilter.matches(functions[i].m_key))
+                    result.m_funcRows.append(i);
+                if(i % STALE_CHECK_INTERVAL == STALE_CHECK_INTERVAL-1 && isStale(requestSeq))
+                    isDone = false;
+            }
+        }
+        if(isDone && (changed & TagBrowserResult::CLASSES))
+        {
+            const QVector<TagBrowserIndex::Class> &classes = m_index->m_classes;
+            for(int i = 0;i < classes.size() && isDone;i++)
+            {
+                if(classFilter.matches(classes[i].m_key))
+                {
+                    result.m_classRows.append(i);
+                    result.m_classFuncCount += classes[i].m_funcIdxs.size();
+                }
+                if(i % STALE_CHECK_INTERVAL == STALE_CHECK_INTERVAL-1 && isStale(requestSeq))
+                    isDone = false;
+            }
+        }
+
+        m_mutex.lock();
+        if(requestSeq == m_requestSeq)
+        {
+            m_doneSeq = requestSeq;
+            m_changed = 0;
+            if(isDone)
+                emit resultReady(result);
+        }
+    }
+    m_mutex.unlock();
+}
+
+
+/**
+ * @brief Returns the data of a function row.
+ * @param name  The text to show in the name column.
+ */
+static QVariant getFunctionData(const TagBrowserIndex::Function &func, QString name, int column, int role)
+{
+    if(role == Qt::UserRole)
+    {
+        // Where to open the function
+        if(column == FunctionListModel::COLUMN_NAME)
+            return func.m_lineNo;
+        if(column == FunctionListModel::COLUMN_FILENAME)
+            return func.m_filePath;
+        return QVariant();
+    }
+    if(role != Qt::DisplayRole)
+        return QVariant();
+
+    if(column == FunctionListModel::COLUMN_NAME)
+        return name;
+    if(column == FunctionListModel::COLUMN_FILENAME)
+        return func.m_fileName;
+    if(column == FunctionListModel::COLUMN_LINE)
+        return QString::number(func.m_lineNo);
+    return QVariant();
+}
+
+
+static QVariant getHeaderData(int section, Qt::Orientation orientation, int role)
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    if(section == FunctionListModel::COLUMN_NAME)
+        return QString("Name");
+    if(section == FunctionListModel::COLUMN_FILENAME)
+        return QString("Filename");
+    if(section == FunctionListModel::COLUMN_LINE)
+        return QString("Line");
+    return QVariant();
+}
+
+
+
+FunctionListModel::FunctionListModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+
+FunctionListModel::~FunctionListModel()
+{
+}
+
+
+int FunctionListModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+
+int FunctionListModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return COLUMN_COUNT;
+}
+
+
+QVariant FunctionListModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+
+    const TagBrowserIndex::Function &func = m_index->m_functions[m_rows[index.row()]];
+    return getFunctionData(func, func.m_name, index.column(), role);
+}
+
+
+QVariant FunctionListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    return getHeaderData(section, orientation, role);
+}
+
+
+void FunctionListModel::setResult(const TagBrowserResult &result)
+{
+    if(!(result.m_changed & TagBrowserResult::FUNCTIONS))
+        return;
+
+    beginResetModel();
+    m_index = result.m_index;
+    m_rows = result.m_funcRows;
+    endResetModel();
+}
+
+
+
+ClassTreeModel::ClassTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+
+ClassTreeModel::~ClassTreeModel()
+{
+}
+
+
+/**
+ * The index of a function points to the row of its class in m_rows.
+ */
+QModelIndex ClassTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if(row < 0 || column < 0 || column >= COLUMN_COUNT)
+        return QModelIndex();
+
+    if(!parent.isValid())
+    {
+        if(row >= m_rows.size())
+            return QModelIndex();
+        return createIndex(row, column);
+    }
+
+    if(parent.internalPointer() != NULL || parent.row() >= m_rows.size())
+        return QModelIndex();
+    const TagBrowserIndex::Class &cls = m_index->m_classes[m_rows[parent.row()]];
+    if(row >= cls.m_funcIdxs.size())
+        return QModelIndex();
+    return createIndex(row, column, (void*)(m_rows.constData() + parent.row()));
+}
+
+
+QModelIndex ClassTreeModel::parent(const QModelIndex &index) const
+{
+    if(!index.isValid() || index.internalPointer() == NULL)
+        return QModelIndex();
+
+    int classRow = (const int*)index.internalPointer() - m_rows.constData();
+    return createIndex(classRow, 0);
+}
+
+
+int ClassTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if(!parent.isValid())
+        return m_rows.size();
+    if(parent.internalPointer() != NULL || parent.column() != 0)
+        return 0;
+    return m_index->m_classes[m_rows[parent.row()]].m_funcIdxs.size();
+}
+
+
+int ClassTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+
+QVariant ClassTreeModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid())
+        return QVariant();
+
+    if(index.internalPointer() == NULL)
+    {
+        const TagBrowserIndex::Class &cls = m_index->m_classes[m_rows[index.row()]];
+        if(index.column() != COLUMN_NAME)
+            return QVariant();
+        if(role == Qt::DisplayRole)
+            return cls.m_name;
+        if(role == Qt::ForegroundRole)
+            return QBrush(Qt::blue);
+        return QVariant();
+    }
+
+    int classIdx = *(const int*)index.internalPointer();
+    int funcIdx = m_index->m_classes[classIdx].m_funcIdxs[index.row()];
+    const TagBrowserIndex::Function &func = m_index->m_functions[funcIdx];
+    return getFunctionData(func, func.m_memberName, index.column(), role);
+}
+
+
+QVariant ClassTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    return getHeaderData(section, orientation, role);
+}
+
+
+void ClassTreeModel::setResult(const TagBrowserResult &result)
+{
+    if(!(result.m_changed & TagBrowserResult::CLASSES))
+        return;
+
+    beginResetModel();
+    m_index = result.m_index;
+    m_rows = result.m_classRows;
+    endResetModel();
+}
+
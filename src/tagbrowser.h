@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__TAGBROWSER_H
+#define FILE__TAGBROWSER_H
+
+#include <QAbstractItemModel>
+#include <QAbstractTableModel>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QMetaType>
+
+#include "tagscanner.h"
+
+
+/**
+ * @brief The functions and classes of a set of tags.
+ *
+ * Built once for each set of tags and not changed after that, so it can be
+ * shared between the worker thread and the models. All names are also
+ * stored in lower case to be matched against the filters.
+ */
+class TagBrowserIndex
+{
+public:
+    class Function
+    {
+    public:
+        QString m_name; //!< Eg: "MyClass::func(int a)".
+        QString m_memberName; //!< Eg: "func(int a)".
+        QString m_key; //!< m_name in lower case.
+        QString m_filePath;
+        QString m_fileName;
+        int m_lineNo;
+        QString m_className;
+    };
+
+    class Class
+    {
+    public:
+        QString m_name;
+        QString m_key; //!< m_name in lower case.
+        QVector<int> m_funcIdxs; //!< The member functions.
+    };
+
+    void build(const QList<QList<Tag> > &tagLists);
+
+    QVector<Function> m_functions; //!< Sorted by name.
+    QVector<Class> m_classes; //!< Sorted by name.
+};
+
+
+/**
+ * @brief The rows to show in the class and function browser.
+ */
+class TagBrowserResult
+{
+public:
+    enum { FUNCTIONS = 0x1, CLASSES = 0x2 };
+
+    TagBrowserResult() : m_changed(0), m_classFuncCount(0) {};
+
+    QSharedPointer<const TagBrowserIndex> m_index;
+    int m_changed; //!< FUNCTIONS and/or CLASSES.
+    QVector<int> m_funcRows; //!< Index in m_index->m_functions for each row.
+    QVector<int> m_classRows; //!< Index in m_index->m_classes for each row.
+    int m_classFuncCount; //!< Total number of functions in the classes in m_classRows.
+};
+
+Q_DECLARE_METATYPE(TagBrowserResult)
+
+
+/**
+ * @brief A set of ';' separated wildcard patterns that all must be found in a name.
+ *
+ * The patterns are matched case insensitive against a name in lower case.
+ */
+class TagBrowserFilter
+{
+public:
+    TagBrowserFilter(QString text);
+
+    bool isEmpty() const { return m_patterns.isEmpty(); };
+    bool matches(const QString &key) const;
+
+private:
+    QStringList m_patterns;
+    QVector<bool> m_isPlain; //!< True if the pattern has no wildcards.
+};
+
+
+/**
+ * @brief Builds the index and filters the browser rows in a separate thread.
+ *
+ * Only the latest request matters. A request that is replaced by a newer
+ * one before it is done is dropped without emitting a result.
+ */
+class TagBrowserWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    TagBrowserWorker();
+    virtual ~TagBrowserWorker();
+
+    void run();
+
+    void setTags(const QList<QList<Tag> > &tagLists);
+    void setFuncFilter(QString text);
+    void setClassFilter(QString text);
+
+signals:
+    void resultReady(TagBrowserResult result);
+
+private:
+    void queueRequest(int changed);
+    bool isStale(int requestSeq);
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_wait;
+    bool m_quit;
+    int m_requestSeq; //!< Incremented for each request.
+    int m_doneSeq; //!< The last request that was handled.
+    int m_changed; //!< The lists changed since the last emitted result.
+    bool m_hasNewTags;
+    QList<QList<Tag> > m_newTags;
+    QString m_funcFilter;
+    QString m_classFilter;
+
+    QSharedPointer<TagBrowserIndex> m_index; //!< Only accessed by the worker thread.
+};
+
+
+/**
+ * @brief Flat list of all the functions that matches the function filter.
+ */
+class FunctionListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    FunctionListModel(QObject *parent = NULL);
+    virtual ~FunctionListModel();
+
+    enum { COLUMN_NAME = 0, COLUMN_FILENAME, COLUMN_LINE, COLUMN_COUNT };
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    void setResult(const TagBrowserResult &result);
+
+private:
+    QSharedPointer<const TagBrowserIndex> m_index;
+    QVector<int> m_rows;
+};
+
+
+/**
+ * @brief The classes that matches the class filter with their functions as children.
+ */
+class ClassTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    ClassTreeModel(QObject *parent = NULL);
+    virtual ~ClassTreeModel();
+
+    enum { COLUMN_NAME = 0, COLUMN_FILENAME, COLUMN_LINE, COLUMN_COUNT };
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    void setResult(const TagBrowserResult &result);
+
+private:
+    QSharedPointer<const TagBrowserIndex> m_index;
+    QVector<int> m_rows;
+};
+
+
+#endif // FILE__TAGBROWSER_H
@@ -15,6 +15,7 @@
 #include "mainwindow.h"
 #include "log.h"
 #include "util.h"
+#include "tracelog.h"
 
 
 ScannerWorker::ScannerWorker()
@@ -111,7 +112,7 @@ void ScannerWorker::scan(QString filePath)
 
     assert(m_dbgMainThread != QThread::currentThreadId ());
     
-    
+    TraceScope traceScope("tags", "Scan file", filePath);
     m_scanner.scan(filePath, taglist);
 
 
@@ -120,6 +121,7 @@ void ScannerWorker::scan(QString filePath)
 
 
 TagManager::TagManager(Settings &cfg)
+    : m_generation(0)
 {
 #ifndef NDEBUG
     m_dbgMainThread = QThread::currentThreadId ();
@@ -169,6 +171,7 @@ void TagManager::onScanDone(QString filePath, QList<Tag> *tags)
     }
 
     m_db[filePath] = info;
+    m_generation++;
 
     if(m_worker.isIdle())
         emit onAllScansDone();
@@ -202,6 +205,26 @@ int TagManager::queueScan(QStringList filePathList)
 
 
 
+/**
+ * @brief Forgets the tags of files that has been modified.
+ *
+ * The files are scanned again by the next scan() or queueScan().
+ */
+void TagManager::invalidate(QStringList filePathList)
+{
+    assert(m_dbgMainThread == QThread::currentThreadId ());
+    for(int i = 0;i < filePathList.size();i++)
+    {
+        QMap<QString, ScannerResult*>::iterator it = m_db.find(filePathList[i]);
+        if(it == m_db.end())
+            continue;
+        delete it.value();
+        m_db.erase(it);
+        m_generation++;
+    }
+}
+
+
 void TagManager::scan(QString filePath, QList<Tag> *tagList)
 {
     if(!m_db.contains(filePath))
@@ -212,6 +235,7 @@ void TagManager::scan(QString filePath, QList<Tag> *tagList)
         m_tagScanner.scan(res->m_filePath, &res->m_tagList);
 
         m_db[filePath] = res;
+        m_generation++;
     }
 
     *tagList = m_db[filePath]->m_tagList;
@@ -232,6 +256,22 @@ void TagManager::getTags(QString filePath, QList<Tag> *tagList)
 }
 
 
+/**
+ * @brief Returns the tags of a file without copying them.
+ *
+ * The list is valid until the file is scanned again.
+ */
+const QList<Tag> &TagManager::getTagList(QString filePath) const
+{
+    static const QList<Tag> emptyList;
+
+    QMap<QString, ScannerResult*>::const_iterator it = m_db.constFind(filePath);
+    if(it == m_db.constEnd())
+        return emptyList;
+    return it.value()->m_tagList;
+}
+
+
 /**
  * @brief Lookup tags with a specific name.
  * @param name       The name of the tag (Eg: "main" or "Class::myFunc").
@@ -257,7 +297,7 @@ void TagManager::lookupTag(QString name, QList<Tag> *tagList)
     {
         for(int j = 0;j < info->m_tagList.size();j++)
         {
-            Tag &tag = info->m_tagList[j];
+            const Tag &tag = info->m_tagList[j];
             
             if(tag.getName() == funcName && className == tag.getClassName())
                 tagList->append(tag);
@@ -68,13 +68,14 @@ class TagManager : public QObject
     Q_OBJECT
 
 private:
-    TagManager(){};
+    TagManager() : m_generation(0) {};
 public:
     TagManager(Settings &cfg);
     virtual ~TagManager();
 
 
     int queueScan(QStringList filePathList);
+    void invalidate(QStringList filePathList);
     void scan(QString filePath, QList<Tag> *tagList);
 
     void waitAll();
@@ -82,6 +83,8 @@ public:
     void abort();
 
     void getTags(QString filePath, QList<Tag> *tagList);
+    const QList<Tag> &getTagList(QString filePath) const;
+    int getGeneration() const { return m_generation; };
 
     void lookupTag(QString name, QList<Tag> *tagList);
 
@@ -100,6 +103,7 @@ private:
     Qt::HANDLE m_dbgMainThread;
 #endif
     QMap<QString, ScannerResult*> m_db;
+    int m_generation; //!< Incremented each time the tags in m_db has changed.
 
     Settings m_cfg;
 };
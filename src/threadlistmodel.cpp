@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "threadlistmodel.h"
+
+#include <algorithm>
+
+#include "core.h"
+#include "log.h"
+
+
+ThreadListModel::ThreadListModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    m_fetchTimer.setSingleShot(true);
+    m_fetchTimer.setInterval(0);
+    connect(&m_fetchTimer, SIGNAL(timeout()), this, SLOT(onFetchTimeout()));
+}
+
+
+ThreadListModel::~ThreadListModel()
+{
+}
+
+
+int ThreadListModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return m_threadIds.size();
+}
+
+
+int ThreadListModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return COLUMN_COUNT;
+}
+
+
+QVariant ThreadListModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_threadIds.size())
+        return QVariant();
+
+    int threadId = m_threadIds[index.row()];
+    if(role == Qt::UserRole)
+        return threadId;
+    if(role != Qt::DisplayRole)
+        return QVariant();
+
+    Core &core = Core::getInstance();
+    ThreadInfo tinfo;
+    if(!core.getThreadInfo(threadId, &tinfo))
+        return QVariant();
+
+    // Only visible rows are asked for, so fetch the details for those.
+    // Stopped threads can be queried while others run in non-stop mode.
+    if(tinfo.m_detailsGeneration != core.getThreadDetailsGeneration() && !tinfo.m_running &&
+        (!core.isRunning() || core.isNonStop()))
+    {
+        m_pendingFetch.insert(threadId);
+        if(!m_fetchTimer.isActive())
+            m_fetchTimer.start();
+    }
+
+    if(index.column() == COLUMN_NAME)
+    {
+        if(tinfo.m_name.isEmpty())
+            return QString("Thread %1").arg(threadId);
+        return tinfo.m_name;
+    }
+    if(tinfo.m_running && core.isNonStop())
+        return QString("Running");
+    return tinfo.m_details;
+}
+
+
+QVariant ThreadListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    if(section == COLUMN_NAME)
+        return QString("Name");
+    if(section == COLUMN_DETAILS)
+        return QString("Details");
+    return QVariant();
+}
+
+
+/**
+ * @brief Rereads all threads from Core.
+ */
+void ThreadListModel::reload()
+{
+    Core &core = Core::getInstance();
+
+    beginResetModel();
+    m_threadIds = core.getThreadIdList().toVector();
+    std::sort(m_threadIds.begin(), m_threadIds.end());
+    m_pendingFetch.clear();
+    endResetModel();
+}
+
+
+/**
+ * @brief Returns the row of a thread or -1 if not found.
+ */
+int ThreadListModel::findRow(int threadId) const
+{
+    QVector<int>::const_iterator it = std::lower_bound(m_threadIds.constBegin(), m_threadIds.constEnd(), threadId);
+    if(it == m_threadIds.constEnd() || *it != threadId)
+        return -1;
+    return it - m_threadIds.constBegin();
+}
+
+
+int ThreadListModel::getThreadId(int row) const
+{
+    if(row < 0 || row >= m_threadIds.size())
+        return -1;
+    return m_threadIds[row];
+}
+
+
+void ThreadListModel::addThread(int threadId)
+{
+    QVector<int>::iterator it = std::lower_bound(m_threadIds.begin(), m_threadIds.end(), threadId);
+    if(it != m_threadIds.end() && *it == threadId)
+    {
+        updateThread(threadId);
+        return;
+    }
+    int row = it - m_threadIds.begin();
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_threadIds.insert(row, threadId);
+    endInsertRows();
+}
+
+
+void ThreadListModel::removeThread(int threadId)
+{
+    int row = findRow(threadId);
+    if(row == -1)
+        return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_threadIds.remove(row);
+    m_pendingFetch.remove(threadId);
+    endRemoveRows();
+}
+
+
+/**
+ * @brief Called when the details of a thread has been fetched.
+ */
+void ThreadListModel::updateThread(int threadId)
+{
+    int row = findRow(threadId);
+    if(row == -1)
+        return;
+    emit dataChanged(index(row, 0), index(row, COLUMN_COUNT-1));
+}
+
+
+/**
+ * @brief Marks the details of all threads as outdated.
+ */
+void ThreadListModel::invalidateDetails()
+{
+    if(m_threadIds.isEmpty())
+        return;
+
+    // The view will only ask for the visible rows, which will be refetched.
+    emit dataChanged(index(0, 0), index(m_threadIds.size()-1, COLUMN_COUNT-1));
+}
+
+
+void ThreadListModel::onFetchTimeout()
+{
+    Core &core = Core::getInstance();
+
+    QList<int> threadIdList = m_pendingFetch.values();
+    m_pendingFetch.clear();
+    std::sort(threadIdList.begin(), threadIdList.end());
+
+    debugMsg("Fetching details for %d threads", threadIdList.size());
+
+    core.gdbGetThreadDetails(threadIdList);
+}
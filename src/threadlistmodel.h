@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__THREADLISTMODEL_H
+#define FILE__THREADLISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QSet>
+#include <QTimer>
+
+
+/**
+ * @brief Model of the threads in the target.
+ *
+ * The rows are sorted by thread id and are only inserted or removed when
+ * a thread is created or exits. The details of a thread are fetched from
+ * GDB first when the row is displayed.
+ */
+class ThreadListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    ThreadListModel(QObject *parent = NULL);
+    virtual ~ThreadListModel();
+
+    enum { COLUMN_NAME = 0, COLUMN_DETAILS, COLUMN_COUNT };
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    void reload();
+    void addThread(int threadId);
+    void removeThread(int threadId);
+    void updateThread(int threadId);
+    void invalidateDetails();
+
+    int findRow(int threadId) const;
+    int getThreadId(int row) const;
+
+private slots:
+    void onFetchTimeout();
+
+private:
+    QVector<int> m_threadIds; //!< Thread id for each row (sorted).
+    mutable QSet<int> m_pendingFetch; //!< Threads to fetch details for.
+    mutable QTimer m_fetchTimer;
+};
+
+#endif // FILE__THREADLISTMODEL_H
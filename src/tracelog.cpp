@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "tracelog.h"
+
+#include <QFile>
+#include <QThread>
+#include <QMutexLocker>
+#include <unistd.h>
+
+#include "log.h"
+#include "util.h"
+
+
+TraceLog::TraceLog()
+    : m_enabled(0)
+{
+}
+
+
+TraceLog& TraceLog::getInstance()
+{
+    static TraceLog inst;
+    return inst;
+}
+
+
+/**
+ * @brief Starts to record events.
+ * @param filename   The file to write the events to when save() is called.
+ */
+void TraceLog::start(QString filename)
+{
+    m_filename = filename;
+    m_timer.start();
+
+    // Published last so a thread that sees it enabled also sees the timer
+    m_enabled.storeRelease(1);
+}
+
+
+/**
+ * @brief Returns the time (in microseconds) since the recording started.
+ */
+qint64 TraceLog::getTimestamp()
+{
+    if(!isEnabled())
+        return 0;
+    return m_timer.nsecsElapsed() / 1000;
+}
+
+
+/**
+ * @brief Returns a small number identifying the calling thread.
+ */
+int TraceLog::getThreadIdx()
+{
+    quintptr threadHandle = (quintptr)QThread::currentThreadId();
+    QHash<quintptr, int>::const_iterator it = m_threadIdx.constFind(threadHandle);
+    if(it != m_threadIdx.constEnd())
+        return it.value();
+    int idx = m_threadIdx.size() + 1;
+    m_threadIdx.insert(threadHandle, idx);
+    return idx;
+}
+
+
+QString TraceLog::escapeString(QString str)
+{
+    QString escaped;
+    for(int i = 0;i < str.size();i++)
+    {
+        QChar c = str[i];
+        if(c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if(c == '\n')
+            escaped += "\\n";
+        else if(c == '\r')
+            escaped += "\\r";
+        else if(c == '\t')
+            escaped += "\\t";
+        else if(c.unicode() < 0x20)
+            escaped += QString::asprintf("\\u%04x", c.unicode());
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+
+/**
+ * @brief Adds an event that started at startTime and ends now.
+ * @param detail   Optional extra info (eg: the GDB command).
+ */
+void TraceLog::addComplete(const char *category, QString name, qint64 startTime, QString detail)
+{
+    if(!isEnabled())
+        return;
+
+    qint64 endTime = getTimestamp();
+
+    QMutexLocker locker(&m_mutex);
+    if(!isEnabled())
+        return;
+
+    QString event = QString("{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6")
+                        .arg(escapeString(name)).arg(category)
+                        .arg(startTime).arg(endTime-startTime)
+                        .arg((int)getpid()).arg(getThreadIdx());
+    if(!detail.isEmpty())
+        event += ",\"args\":{\"detail\":\"" + escapeString(detail) + "\"}";
+    event += "}";
+    m_events.append(event);
+}
+
+
+/**
+ * @brief Adds an event marking a point in time.
+ */
+void TraceLog::addInstant(const char *category, QString name)
+{
+    if(!isEnabled())
+        return;
+
+    qint64 timestamp = getTimestamp();
+
+    QMutexLocker locker(&m_mutex);
+    if(!isEnabled())
+        return;
+
+    QString event = QString("{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"i\",\"s\":\"p\",\"ts\":%3,\"pid\":%4,\"tid\":%5}")
+                        .arg(escapeString(name)).arg(category)
+                        .arg(timestamp).arg((int)getpid()).arg(getThreadIdx());
+    m_events.append(event);
+}
+
+
+/**
+ * @brief Writes the recorded events to the file and stops the recording.
+ * @return 0 on success.
+ */
+int TraceLog::save()
+{
+    if(!isEnabled())
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+
+    m_enabled.storeRelease(0);
+
+    QFile file(m_filename);
+    if(!file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+    {
+        errorMsg("Failed to write trace to '%s'", stringToCStr(m_filename));
+        return -1;
+    }
+    file.write("{\"traceEvents\":[\n");
+    for(int i = 0;i < m_events.size();i++)
+    {
+        file.write(m_events[i].toUtf8());
+        file.write(i+1 < m_events.size() ? ",\n" : "\n");
+    }
+    file.write("],\"displayTimeUnit\":\"ms\"}\n");
+    file.close();
+
+    infoMsg("Wrote %d trace events to '%s'", m_events.size(), stringToCStr(m_filename));
+    m_events.clear();
+    return 0;
+}
+
+
+TraceScope::TraceScope(const char *category, const char *name, QString detail)
+    : m_category(category)
+    ,m_name(name)
+    ,m_startTime(-1)
+{
+    TraceLog &trace = TraceLog::getInstance();
+    if(trace.isEnabled())
+    {
+        m_detail = detail;
+        m_startTime = trace.getTimestamp();
+    }
+}
+
+
+TraceScope::~TraceScope()
+{
+    if(m_startTime >= 0)
+        TraceLog::getInstance().addComplete(m_category, m_name, m_startTime, m_detail);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__TRACELOG_H
+#define FILE__TRACELOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QHash>
+#include <QAtomicInt>
+
+
+/**
+ * @brief Records timed events and writes them as a Chrome trace event file.
+ *
+ * The file can be opened in chrome://tracing or https://ui.perfetto.dev.
+ */
+class TraceLog
+{
+private:
+    TraceLog();
+    
+public:
+    static TraceLog& getInstance();
+
+    void start(QString filename);
+    bool isEnabled() const { return m_enabled.loadAcquire() != 0; };
+
+    qint64 getTimestamp();
+    void addComplete(const char *category, QString name, qint64 startTime, QString detail = "");
+    void addInstant(const char *category, QString name);
+
+    int save();
+
+private:
+    int getThreadIdx();
+    static QString escapeString(QString str);
+
+private:
+    QAtomicInt m_enabled; //!< Read without the mutex by the worker threads.
+    QString m_filename;
+    QElapsedTimer m_timer;
+    QMutex m_mutex;
+    QStringList m_events; //!< The events in JSON format.
+    QHash<quintptr, int> m_threadIdx; //!< Thread handle to the tid shown in the trace.
+};
+
+
+/**
+ * @brief Adds a trace event covering the lifetime of the object.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name, QString detail = "");
+    ~TraceScope();
+
+private:
+    const char *m_category;
+    const char *m_name;
+    QString m_detail;
+    qint64 m_startTime;
+};
+
+#endif // FILE__TRACELOG_H
@@ -9,13 +9,45 @@
 #include "tree.h"
 
 #include <QList>
-#include <assert.h>
+#include <stdlib.h>
 
 #include "log.h"
 #include "util.h"
 
+TreeKey::TreeKey(QString name)
+    : m_name(name)
+    ,m_hash(qHash(name))
+    ,m_index(-1)
+{
+    if(name.startsWith('#'))
+    {
+        int idx = atoi(stringToCStr(name.mid(1)))-1;
+        if(idx >= 0)
+            m_index = idx;
+    }
+}
+
+
+TreePath::TreePath(QString path)
+{
+    int startPos = 0;
+    while(startPos <= path.length())
+    {
+        int endPos = path.indexOf('/', startPos);
+        if(endPos == -1)
+            endPos = path.length();
+        if(endPos > startPos)
+            m_keys.append(TreeKey(path.mid(startPos, endPos-startPos)));
+        startPos = endPos+1;
+    }
+    if(m_keys.isEmpty())
+        m_keys.append(TreeKey(""));
+}
+
+
 TreeNode::TreeNode()
     : m_parent(NULL)
+    ,m_nameHash(qHash(QString()))
 {
 
 }
@@ -23,6 +55,7 @@ TreeNode::TreeNode()
 TreeNode::TreeNode(QString name)
     : m_parent(NULL)
     ,m_name(name)
+    ,m_nameHash(qHash(name))
 {
     
 }
@@ -41,7 +74,6 @@ void TreeNode::addChild(TreeNode *child)
     child->m_parent = this;
    
     m_children.push_back(child);
-    m_childMap[child->m_name] = child;
 
 }
 
@@ -54,6 +86,7 @@ void TreeNode::copy(const TreeNode &other)
 
     // Set name and data
     m_name = other.m_name;
+    m_nameHash = other.m_nameHash;
     m_data = other.m_data;
 
     // Copy all children
@@ -156,75 +189,63 @@ long long TreeNode::getChildDataLongLong(QString childPath, long long defaultVal
 }
 
     
+int TreeNode::getChildDataInt(const TreePath &path, int defaultValue) const
+{
+    TreeNode *child = findChild(path);
+    if(child)
+        return child->getDataInt(defaultValue);
+    return defaultValue;
+}
+
+
+QString TreeNode::getChildDataString(const TreePath &path) const
+{
+    TreeNode *child = findChild(path);
+    if(child)
+        return child->m_data;
+    return "";
+}
+
+
 TreeNode *TreeNode::findChild(QString path) const
 {
-    QString childName;
-    QString restPath;
-    int indexPos;
-
-    // Find the seperator in the string 
-    indexPos = path.indexOf('/');
-    if(indexPos == 0)
-        return findChild(path.mid(1));
-
-    // Get the first child name
-    if(indexPos == -1)
-        childName = path;
-    else
-    {
-        childName = path.left(indexPos);
-        restPath = path.mid(indexPos+1);
-    }
+    return findChild(TreePath(path));
+}
+
 
-    if(childName.startsWith('#'))
+/**
+ * @brief Finds a direct child.
+ *
+ * If several children has the same name, the last one is returned.
+ */
+TreeNode *TreeNode::findChild(const TreeKey &key) const
+{
+    if(key.m_index >= 0)
     {
-        QString numStr = childName.mid(1);
-        int idx = atoi(stringToCStr(numStr))-1;
-        if(0 <= idx  && idx < getChildCount())
-        {
-            TreeNode *child = getChild(idx);
-            if(restPath.isEmpty())
-                return child;
-            else
-                return child->findChild(restPath);
-        }
+        if(key.m_index < m_children.size())
+            return m_children[key.m_index];
+        return NULL;
     }
-    else
+
+    for(int i = m_children.size()-1;i >= 0;i--)
     {
-        
-        TreeNode *child;
-
-        if(m_childMap.contains(childName))
-        {
-            child = m_childMap[childName];
-            assert(child->m_name == childName);
-            if(restPath.isEmpty())
-                return child;
-            else
-                return child->findChild(restPath);
-        }
-        else
-        {
-        // Look for the child
-        for(int u = 0;u < getChildCount();u++)
-        {
-            child = getChild(u);
-
-            if(child->getName() == childName)
-            {
-                if(restPath.isEmpty())
-                    return child;
-                else
-                    return child->findChild(restPath);
-            }
-        }
-        }
+        TreeNode *child = m_children[i];
+        if(child->is(key))
+            return child;
     }
-        
     return NULL;
 }
 
 
+TreeNode *TreeNode::findChild(const TreePath &path) const
+{
+    const TreeNode *node = this;
+    for(int i = 0;node != NULL && i < path.getKeyCount();i++)
+        node = node->findChild(path.getKey(i));
+    return (TreeNode*)node;
+}
+
+
 
 QString Tree::getString(QString path) const
 {
@@ -249,6 +270,24 @@ TreeNode* Tree::findChild(QString path) const
 }
 
 
+QString Tree::getString(const TreePath &path) const
+{
+    return m_root.getChildDataString(path);
+}
+
+
+int Tree::getInt(const TreePath &path, int defaultValue) const
+{
+    return m_root.getChildDataInt(path, defaultValue);
+}
+
+
+TreeNode* Tree::findChild(const TreePath &path) const
+{
+    return m_root.findChild(path);
+}
+
+
 
 void Tree::removeAll()
 {
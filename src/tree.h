@@ -16,6 +16,39 @@
 #include <QHash>
 
 
+/**
+ * @brief A child name which has been hashed once.
+ */
+class TreeKey
+{
+public:
+    TreeKey() : m_hash(0), m_index(-1) {};
+    explicit TreeKey(QString name);
+
+    QString m_name;
+    uint m_hash;
+    int m_index; //!< Child index for '#N' names (else -1).
+};
+
+
+/**
+ * @brief A path (Eg: "frame/line") which has been split and hashed once.
+ *
+ * Meant to be created once (Eg: as a static) and then used for many lookups.
+ */
+class TreePath
+{
+public:
+    explicit TreePath(QString path);
+
+    int getKeyCount() const { return m_keys.size(); };
+    const TreeKey &getKey(int i) const { return m_keys[i]; };
+
+private:
+    QVector<TreeKey> m_keys;
+};
+
+
 class TreeNode
 {
 public:
@@ -24,6 +57,13 @@ public:
     virtual ~TreeNode();
     
     TreeNode *findChild(QString path) const;
+    TreeNode *findChild(const TreeKey &key) const;
+    TreeNode *findChild(const TreePath &path) const;
+
+    /**
+     * @brief Returns true if the name of the node is key.
+     */
+    bool is(const TreeKey &key) const { return m_nameHash == key.m_hash && m_name == key.m_name; };
 
     void addChild(TreeNode *child);
     TreeNode *getChild(int i) const { return m_children[i]; };
@@ -34,6 +74,8 @@ public:
     QString getChildDataString(QString childName) const;
     int getChildDataInt(QString path, int defaultValue = 0) const;
     long long getChildDataLongLong(QString path, long long defaultValue = 0) const;
+    QString getChildDataString(const TreePath &path) const;
+    int getChildDataInt(const TreePath &path, int defaultValue = 0) const;
 
     void setData(QString data) { m_data = data; };
     void dump();
@@ -51,9 +93,9 @@ private:
 private:
     TreeNode *m_parent;
     QString m_name;
+    uint m_nameHash;
     QString m_data;
     QVector<TreeNode*> m_children;
-    QHash<QString, TreeNode*> m_childMap;
     
 private:
     TreeNode(const TreeNode &) { };
@@ -77,11 +119,14 @@ public:
     QString getString(QString path) const;
     int getInt(QString path, int defaultValue = 0) const;
     long long getLongLong(QString path) const;
+    QString getString(const TreePath &path) const;
+    int getInt(const TreePath &path, int defaultValue = 0) const;
 
     TreeNode *getChildAt(int idx) { return m_root.getChild(idx);};
     int getRootChildCount() const { return m_root.getChildCount();};
     
     TreeNode* findChild(QString path) const;
+    TreeNode* findChild(const TreePath &path) const;
 
     TreeNode* getRoot() { return &m_root; };
     void copy(const Tree &other);
@@ -18,6 +18,7 @@
 #include <QFile>
 #include <QDir>
 #include <QStringList>
+#include <QVector>
 
 
 
@@ -280,6 +281,187 @@ QByteArray fileToContent(QString filename)
 }
 
 
+static quint64 readElfInt(const char *data, int size, bool bigEndian)
+{
+    quint64 val = 0;
+    for(int i = 0;i < size;i++)
+    {
+        quint8 b = (quint8)data[bigEndian ? i : size-1-i];
+        val = (val << 8) | b;
+    }
+    return val;
+}
+
+
+/**
+ * @brief Reads the section headers (and their names) of an ELF file.
+ * @return 0 on success.
+ */
+int readElfSections(QFile &f, QVector<ElfSection> *sections, bool *bigEndianPtr)
+{
+    QByteArray hdr = f.read(64);
+    if(hdr.size() < 52 || !hdr.startsWith("\x7f" "ELF"))
+        return -1;
+    bool is64 = (hdr[4] == 2);
+    bool bigEndian = (hdr[5] == 2);
+    if(is64 && hdr.size() < 64)
+        return -1;
+    *bigEndianPtr = bigEndian;
+
+    // Find the section headers
+    quint64 shOff = is64 ? readElfInt(hdr.constData()+0x28, 8, bigEndian) : readElfInt(hdr.constData()+0x20, 4, bigEndian);
+    int shEntSize = readElfInt(hdr.constData()+(is64 ? 0x3A : 0x2E), 2, bigEndian);
+    int shNum = readElfInt(hdr.constData()+(is64 ? 0x3C : 0x30), 2, bigEndian);
+    int shStrIdx = readElfInt(hdr.constData()+(is64 ? 0x3E : 0x32), 2, bigEndian);
+    if(shOff == 0 || shNum == 0 || shEntSize < (is64 ? 0x28 : 0x18) || !f.seek(shOff))
+        return -1;
+    QByteArray shTable = f.read(shEntSize*shNum);
+    if(shTable.size() != shEntSize*shNum)
+        return -1;
+
+    QVector<quint64> nameOffsets;
+    for(int secIdx = 0;secIdx < shNum;secIdx++)
+    {
+        const char *sh = shTable.constData() + secIdx*shEntSize;
+        ElfSection sec;
+        sec.m_type = readElfInt(sh+4, 4, bigEndian);
+        sec.m_flags = is64 ? readElfInt(sh+8, 8, bigEndian) : readElfInt(sh+8, 4, bigEndian);
+        sec.m_offset = is64 ? readElfInt(sh+0x18, 8, bigEndian) : readElfInt(sh+0x10, 4, bigEndian);
+        sec.m_size = is64 ? readElfInt(sh+0x20, 8, bigEndian) : readElfInt(sh+0x14, 4, bigEndian);
+        sections->append(sec);
+        nameOffsets.append(readElfInt(sh, 4, bigEndian));
+    }
+
+    // Get the names from the section name string table
+    if(shStrIdx < shNum)
+    {
+        const ElfSection &strSec = (*sections)[shStrIdx];
+        if(strSec.m_size < 16*1024*1024 && f.seek(strSec.m_offset))
+        {
+            QByteArray strTable = f.read(strSec.m_size);
+            for(int secIdx = 0;secIdx < shNum;secIdx++)
+            {
+                if(nameOffsets[secIdx] >= (quint64)strTable.size())
+                    continue;
+                int nameOff = (int)nameOffsets[secIdx];
+                int nameEnd = strTable.indexOf('\0', nameOff);
+                if(nameEnd == -1)
+                    nameEnd = strTable.size();
+                (*sections)[secIdx].m_name = strTable.mid(nameOff, nameEnd-nameOff);
+            }
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Returns the GNU build-id of an ELF file.
+ *
+ * Only the headers and the note sections are read, so it is fast even
+ * for huge executables.
+ * @return The build-id or an empty array if not found.
+ */
+QByteArray readElfBuildId(QString filename)
+{
+    const int SHT_NOTE = 7;
+    const int NT_GNU_BUILD_ID = 3;
+
+    QFile f(filename);
+    if(!f.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QVector<ElfSection> sections;
+    bool bigEndian = false;
+    if(readElfSections(f, &sections, &bigEndian))
+        return QByteArray();
+
+    for(int secIdx = 0;secIdx < sections.size();secIdx++)
+    {
+        const ElfSection &sec = sections[secIdx];
+        if(sec.m_type != SHT_NOTE)
+            continue;
+        if(sec.m_size > 64*1024 || !f.seek(sec.m_offset))
+            continue;
+        QByteArray notes = f.read(sec.m_size);
+
+        // Go through the notes in the section
+        int pos = 0;
+        while(pos + 12 <= notes.size())
+        {
+            quint64 nameSize = readElfInt(notes.constData()+pos, 4, bigEndian);
+            quint64 descSize = readElfInt(notes.constData()+pos+4, 4, bigEndian);
+            quint64 type = readElfInt(notes.constData()+pos+8, 4, bigEndian);
+            if(nameSize > (quint64)notes.size() || descSize > (quint64)notes.size())
+                break;
+            int namePos = pos + 12;
+            int descPos = namePos + ((nameSize + 3) & ~3);
+            if(descPos + (int)descSize > notes.size())
+                break;
+            if(type == NT_GNU_BUILD_ID && notes.mid(namePos, nameSize) == QByteArray("GNU", 4))
+                return notes.mid(descPos, descSize);
+            pos = descPos + ((descSize + 3) & ~3);
+        }
+    }
+    return QByteArray();
+}
+
+
+/**
+ * @brief Returns the names of the sections in an ELF file.
+ */
+QStringList readElfSectionNames(QString filename)
+{
+    QStringList names;
+    QFile f(filename);
+    if(!f.open(QIODevice::ReadOnly))
+        return names;
+
+    QVector<ElfSection> sections;
+    bool bigEndian = false;
+    if(readElfSections(f, &sections, &bigEndian))
+        return names;
+    for(int secIdx = 0;secIdx < sections.size();secIdx++)
+    {
+        if(!sections[secIdx].m_name.isEmpty())
+            names.append(QString(sections[secIdx].m_name));
+    }
+    return names;
+}
+
+
+/**
+ * @brief Returns the DWARF version of the first compilation unit in an ELF file.
+ * @return The version or 0 if the file has no DWARF debug info.
+ */
+int readElfDwarfVersion(QString filename)
+{
+    QFile f(filename);
+    if(!f.open(QIODevice::ReadOnly))
+        return 0;
+
+    QVector<ElfSection> sections;
+    bool bigEndian = false;
+    if(readElfSections(f, &sections, &bigEndian))
+        return 0;
+    for(int secIdx = 0;secIdx < sections.size();secIdx++)
+    {
+        const ElfSection &sec = sections[secIdx];
+        if(sec.m_name != ".debug_info" || sec.m_size < 14 || !f.seek(sec.m_offset))
+            continue;
+
+        // The version follows the unit length (which is 12 bytes in 64-bit DWARF)
+        QByteArray cuHdr = f.read(14);
+        if(cuHdr.size() != 14)
+            return 0;
+        if(readElfInt(cuHdr.constData(), 4, bigEndian) == 0xffffffff)
+            return readElfInt(cuHdr.constData()+12, 2, bigEndian);
+        return readElfInt(cuHdr.constData()+4, 2, bigEndian);
+    }
+    return 0;
+}
+
+
 /**
 * @brief Joins a QStringList into a string.
 */
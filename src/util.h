@@ -11,6 +11,10 @@
 
 #include <QString>
 #include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+class QFile;
 
 #define MIN(a,b) ((a)<(b))
 #define MAX(a,b) ((a)>(b))
@@ -37,6 +41,24 @@ bool exeExists(QString name, bool checkCurrentDir = false);
 
 QByteArray fileToContent(QString filename);
 
+/**
+ * @brief A section in an ELF file.
+ */
+class ElfSection
+{
+public:
+    QByteArray m_name;
+    int m_type;
+    quint64 m_flags;
+    quint64 m_offset; //!< File offset of the content.
+    quint64 m_size;
+};
+
+int readElfSections(QFile &f, QVector<ElfSection> *sections, bool *bigEndianPtr);
+QByteArray readElfBuildId(QString filename);
+QStringList readElfSectionNames(QString filename);
+int readElfDwarfVersion(QString filename);
+
 QStringList splitString(QString str, char separator = ' ');
 QString joingStringList(QStringList arguments, char separator = ' ');
 
@@ -12,3 +12,20 @@
 
 
 
+
+
+/**
+ * @brief Returns the format to switch to when the user double clicks on a value.
+ */
+VarCtl::DispFormat VarCtl::nextDispFormat(DispFormat fmt)
+{
+    switch(fmt)
+    {
+        case DISP_DEC: return DISP_HEX;
+        case DISP_HEX: return DISP_BIN;
+        case DISP_BIN: return DISP_CHAR;
+        case DISP_CHAR: return DISP_DEC;
+        default: break;
+    }
+    return fmt;
+}
@@ -11,7 +11,7 @@
 
 
 #include <QString>
-#include <QMap>
+#include <QHash>
 #include <QObject>
 
 
@@ -38,7 +38,9 @@ public:
         QString lastData;
     }DispInfo;
 
-    typedef QMap<QString, DispInfo>  DispInfoMap;
+    typedef QHash<QString, DispInfo>  DispInfoMap;
+
+    static DispFormat nextDispFormat(DispFormat fmt);
 
 
 
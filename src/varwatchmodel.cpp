@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "varwatchmodel.h"
+
+#include <algorithm>
+#include <QBrush>
+
+#include "core.h"
+#include "log.h"
+
+
+VarWatchModel::VarWatchModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    ,m_nameEditable(false)
+{
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(0);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(onUpdateTimeout()));
+}
+
+
+VarWatchModel::~VarWatchModel()
+{
+    for(int i = 0;i < m_root.m_children.size();i++)
+        forgetItem(m_root.m_children[i]);
+}
+
+
+VarWatchModel::Item* VarWatchModel::getItem(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return const_cast<Item*>(&m_root);
+    return static_cast<Item*>(index.internalPointer());
+}
+
+
+QModelIndex VarWatchModel::indexOf(Item *item, int column) const
+{
+    if(item == NULL || item == &m_root)
+        return QModelIndex();
+    return createIndex(item->m_row, column, item);
+}
+
+
+QModelIndex VarWatchModel::index(int row, int column, const QModelIndex &parent) const
+{
+    Item *parentItem = getItem(parent);
+    if(row < 0 || row >= parentItem->m_children.size() || column < 0 || column >= COLUMN_COUNT)
+        return QModelIndex();
+    return createIndex(row, column, parentItem->m_children[row]);
+}
+
+
+QModelIndex VarWatchModel::parent(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return QModelIndex();
+    return indexOf(getItem(index)->m_parent);
+}
+
+
+int VarWatchModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+    return getItem(parent)->m_children.size();
+}
+
+
+int VarWatchModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+
+/**
+ * @brief Tells if an item can be expanded.
+ *
+ * The children of a watch are first fetched when it is expanded, so ask
+ * Core if there are any.
+ */
+bool VarWatchModel::hasChildren(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return false;
+    Item *item = getItem(parent);
+    if(!item->m_children.isEmpty())
+        return true;
+    if(item == &m_root || item->m_watchId.isEmpty())
+        return false;
+    VarWatch *watch = Core::getInstance().getVarWatchInfo(item->m_watchId);
+    return watch != NULL && watch->hasChildren();
+}
+
+
+/**
+ * @brief Returns the value text to show for an item.
+ */
+QString VarWatchModel::getDisplayString(const QModelIndex &index) const
+{
+    Item *item = getItem(index);
+    if(item->m_watchId.isEmpty())
+        return "";
+    VarWatch *watch = Core::getInstance().getVarWatchInfo(item->m_watchId);
+    if(watch == NULL)
+        return "";
+
+    switch(item->m_dispFormat)
+    {
+        default:
+        case VarCtl::DISP_NATIVE:
+            return watch->getValue(CoreVar::FMT_NATIVE);
+        case VarCtl::DISP_DEC:
+            return watch->getValue(CoreVar::FMT_DEC);
+        case VarCtl::DISP_BIN:
+            return watch->getValue(CoreVar::FMT_BIN);
+        case VarCtl::DISP_HEX:
+            return watch->getValue(CoreVar::FMT_HEX);
+        case VarCtl::DISP_CHAR:
+            return watch->getValue(CoreVar::FMT_CHAR);
+    }
+}
+
+
+QVariant VarWatchModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid())
+        return QVariant();
+    Item *item = getItem(index);
+
+    if(role == Qt::UserRole)
+        return item->m_watchId;
+    if(role == Qt::ForegroundRole)
+    {
+        if(index.column() == COLUMN_VALUE && item->m_changed)
+            return QBrush(Qt::red);
+        return QVariant();
+    }
+    if(role != Qt::DisplayRole && role != Qt::EditRole)
+        return QVariant();
+
+    if(index.column() == COLUMN_NAME)
+        return item->m_name;
+    if(index.column() == COLUMN_VALUE)
+        return getDisplayString(index);
+    if(item->m_watchId.isEmpty())
+        return QVariant();
+    VarWatch *watch = Core::getInstance().getVarWatchInfo(item->m_watchId);
+    if(watch == NULL)
+        return QVariant();
+    return watch->getVarType();
+}
+
+
+/**
+ * @brief Called when the user has edited an item.
+ *
+ * The model is not changed. The owner of the model is notified and is
+ * expected to update the watch in Core.
+ */
+bool VarWatchModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if(!index.isValid() || role != Qt::EditRole)
+        return false;
+
+    if(index.column() == COLUMN_NAME)
+        emit nameEdited(index, value.toString());
+    else if(index.column() == COLUMN_VALUE)
+        emit valueEdited(index, value.toString());
+    else
+        return false;
+    return true;
+}
+
+
+Qt::ItemFlags VarWatchModel::flags(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return Qt::NoItemFlags;
+    Item *item = getItem(index);
+
+    VarWatch *watch = NULL;
+    if(!item->m_watchId.isEmpty())
+        watch = Core::getInstance().getVarWatchInfo(item->m_watchId);
+
+    Qt::ItemFlags f = Qt::ItemIsSelectable;
+    if(watch == NULL || watch->inScope())
+        f |= Qt::ItemIsEnabled;
+    if(index.column() == COLUMN_NAME && m_nameEditable && item->m_parent == &m_root)
+        f |= Qt::ItemIsEditable;
+    else if(index.column() == COLUMN_VALUE && watch != NULL)
+        f |= Qt::ItemIsEditable;
+    return f;
+}
+
+
+QVariant VarWatchModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    if(section == COLUMN_NAME)
+        return QString("Name");
+    if(section == COLUMN_VALUE)
+        return QString("Value");
+    if(section == COLUMN_TYPE)
+        return QString("Type");
+    return QVariant();
+}
+
+
+/**
+ * @brief Adds a top level item.
+ * @param watchId    The watch to show or empty for a placeholder.
+ */
+QModelIndex VarWatchModel::appendRoot(QString watchId, QString name)
+{
+    int row = m_root.m_children.size();
+
+    beginInsertRows(QModelIndex(), row, row);
+    Item *item = new Item;
+    item->m_parent = &m_root;
+    item->m_row = row;
+    item->m_watchId = watchId;
+    item->m_name = name;
+    m_root.m_children.append(item);
+    if(!watchId.isEmpty())
+        m_itemMap[watchId] = item;
+    endInsertRows();
+
+    return indexOf(item);
+}
+
+
+/**
+ * @brief Replaces the watch shown by a top level item.
+ */
+void VarWatchModel::setRoot(int row, QString watchId, QString name)
+{
+    // The row is recreated since it may change from having no children.
+    removeRoot(row);
+
+    beginInsertRows(QModelIndex(), row, row);
+    Item *item = new Item;
+    item->m_parent = &m_root;
+    item->m_watchId = watchId;
+    item->m_name = name;
+    m_root.m_children.insert(row, item);
+    renumber(&m_root, row);
+    if(!watchId.isEmpty())
+        m_itemMap[watchId] = item;
+    endInsertRows();
+}
+
+
+void VarWatchModel::removeRoot(int row)
+{
+    if(row < 0 || row >= m_root.m_children.size())
+        return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    Item *item = m_root.m_children[row];
+    m_root.m_children.remove(row);
+    forgetItem(item);
+    renumber(&m_root, row);
+    endRemoveRows();
+}
+
+
+void VarWatchModel::clear()
+{
+    beginResetModel();
+    for(int i = 0;i < m_root.m_children.size();i++)
+        forgetItem(m_root.m_children[i]);
+    m_root.m_children.clear();
+    m_dirty.clear();
+    endResetModel();
+}
+
+
+/**
+ * @brief Adds a child watch below its parent.
+ * @return The index of the item or an invalid index if the parent is not in the model.
+ */
+QModelIndex VarWatchModel::addChild(VarWatch &watch)
+{
+    QString watchId = watch.getWatchId();
+    Item *item = m_itemMap.value(watchId, NULL);
+    if(item)
+    {
+        updateWatch(watchId);
+        return indexOf(item);
+    }
+
+    int divPos = watchId.lastIndexOf('.');
+    if(divPos == -1)
+        return QModelIndex();
+    Item *parentItem = m_itemMap.value(watchId.left(divPos), NULL);
+    if(parentItem == NULL)
+        return QModelIndex();
+
+    int row = parentItem->m_children.size();
+    beginInsertRows(indexOf(parentItem), row, row);
+    item = new Item;
+    item->m_parent = parentItem;
+    item->m_row = row;
+    item->m_watchId = watchId;
+    item->m_name = watch.getName();
+    parentItem->m_children.append(item);
+    m_itemMap[watchId] = item;
+    endInsertRows();
+
+    return indexOf(item);
+}
+
+
+/**
+ * @brief Marks the value of a watch as changed.
+ *
+ * The view is notified from the event loop so that all watches in a
+ * -var-update are reported together.
+ */
+void VarWatchModel::updateWatch(QString watchId)
+{
+    Item *item = m_itemMap.value(watchId, NULL);
+    if(item == NULL)
+        return;
+
+    // Core removes the children of a watch when its type changes
+    if(!item->m_children.isEmpty() &&
+        Core::getInstance().getVarWatchInfo(item->m_children[0]->m_watchId) == NULL)
+    {
+        removeChildren(item);
+    }
+
+    m_dirty.insert(watchId);
+    if(!m_updateTimer.isActive())
+        m_updateTimer.start();
+}
+
+
+void VarWatchModel::onUpdateTimeout()
+{
+    // Sort the changed rows by parent
+    QHash<Item*, QVector<int> > rowMap;
+    for(QSet<QString>::const_iterator it = m_dirty.constBegin();it != m_dirty.constEnd();++it)
+    {
+        Item *item = m_itemMap.value(*it, NULL);
+        if(item)
+            rowMap[item->m_parent].append(item->m_row);
+    }
+    m_dirty.clear();
+
+    // Report each run of adjacent rows as one range
+    int rangeCount = 0;
+    for(QHash<Item*, QVector<int> >::iterator it = rowMap.begin();it != rowMap.end();++it)
+    {
+        Item *parentItem = it.key();
+        QVector<int> &rows = it.value();
+        std::sort(rows.begin(), rows.end());
+
+        int first = 0;
+        for(int i = 1;i <= rows.size();i++)
+        {
+            if(i < rows.size() && rows[i] == rows[i-1]+1)
+                continue;
+            emit dataChanged(createIndex(rows[first], 0, parentItem->m_children[rows[first]]),
+                             createIndex(rows[i-1], COLUMN_COUNT-1, parentItem->m_children[rows[i-1]]));
+            rangeCount++;
+            first = i;
+        }
+    }
+    debugMsg("Reported changes as %d ranges", rangeCount);
+}
+
+
+QModelIndex VarWatchModel::findIndex(QString watchId, int column) const
+{
+    return indexOf(m_itemMap.value(watchId, NULL), column);
+}
+
+
+QString VarWatchModel::getWatchId(const QModelIndex &index) const
+{
+    return getItem(index)->m_watchId;
+}
+
+
+/**
+ * @brief Returns the path of names to an item (Eg: "myStruct/var2").
+ */
+QString VarWatchModel::getPath(const QModelIndex &index) const
+{
+    Item *item = getItem(index);
+    QString path = item->m_name;
+    for(item = item->m_parent;item != NULL && item != &m_root;item = item->m_parent)
+        path = item->m_name + "/" + path;
+    return path;
+}
+
+
+VarCtl::DispFormat VarWatchModel::getDispFormat(const QModelIndex &index) const
+{
+    return getItem(index)->m_dispFormat;
+}
+
+
+void VarWatchModel::setDispFormat(const QModelIndex &index, VarCtl::DispFormat fmt)
+{
+    Item *item = getItem(index);
+    if(item == &m_root || item->m_dispFormat == fmt)
+        return;
+    item->m_dispFormat = fmt;
+    QModelIndex valueIdx = indexOf(item, COLUMN_VALUE);
+    emit dataChanged(valueIdx, valueIdx);
+}
+
+
+void VarWatchModel::setChanged(const QModelIndex &index, bool changed)
+{
+    Item *item = getItem(index);
+    if(item == &m_root || item->m_changed == changed)
+        return;
+    item->m_changed = changed;
+    QModelIndex valueIdx = indexOf(item, COLUMN_VALUE);
+    emit dataChanged(valueIdx, valueIdx);
+}
+
+
+/**
+ * @brief Deletes an item and its children and removes them from the map.
+ */
+void VarWatchModel::forgetItem(Item *item)
+{
+    for(int i = 0;i < item->m_children.size();i++)
+        forgetItem(item->m_children[i]);
+    if(!item->m_watchId.isEmpty())
+        m_itemMap.remove(item->m_watchId);
+    delete item;
+}
+
+
+void VarWatchModel::removeChildren(Item *item)
+{
+    if(item->m_children.isEmpty())
+        return;
+
+    beginRemoveRows(indexOf(item), 0, item->m_children.size()-1);
+    for(int i = 0;i < item->m_children.size();i++)
+        forgetItem(item->m_children[i]);
+    item->m_children.clear();
+    endRemoveRows();
+}
+
+
+void VarWatchModel::renumber(Item *parent, int fromRow)
+{
+    for(int i = fromRow;i < parent->m_children.size();i++)
+        parent->m_children[i]->m_row = i;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__VARWATCHMODEL_H
+#define FILE__VARWATCHMODEL_H
+
+#include <QAbstractItemModel>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+#include "varctl.h"
+
+class VarWatch;
+
+
+/**
+ * @brief Model of a set of watches and their children.
+ *
+ * The model only stores the structure of the tree and the display state of
+ * each row. The values are read from Core first when a row is displayed.
+ * Changed watches are collected and reported to the view as one
+ * dataChanged() range per run of adjacent rows.
+ */
+class VarWatchModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    VarWatchModel(QObject *parent = NULL);
+    virtual ~VarWatchModel();
+
+    enum { COLUMN_NAME = 0, COLUMN_VALUE, COLUMN_TYPE, COLUMN_COUNT };
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    void setNameEditable(bool editable) { m_nameEditable = editable; };
+
+    QModelIndex appendRoot(QString watchId, QString name);
+    void setRoot(int row, QString watchId, QString name);
+    void removeRoot(int row);
+    void clear();
+
+    QModelIndex addChild(VarWatch &watch);
+    void updateWatch(QString watchId);
+
+    QModelIndex findIndex(QString watchId, int column = COLUMN_NAME) const;
+    QString getWatchId(const QModelIndex &index) const;
+    QString getPath(const QModelIndex &index) const;
+
+    VarCtl::DispFormat getDispFormat(const QModelIndex &index) const;
+    void setDispFormat(const QModelIndex &index, VarCtl::DispFormat fmt);
+    void setChanged(const QModelIndex &index, bool changed);
+
+    QString getDisplayString(const QModelIndex &index) const;
+
+signals:
+    void nameEdited(const QModelIndex &index, QString newName);
+    void valueEdited(const QModelIndex &index, QString newValue);
+
+private slots:
+    void onUpdateTimeout();
+
+private:
+    class Item
+    {
+    public:
+        Item() : m_parent(NULL), m_row(0), m_dispFormat(VarCtl::DISP_NATIVE), m_changed(false) {};
+
+        Item *m_parent;
+        QVector<Item*> m_children;
+        int m_row; //!< Position in m_parent->m_children.
+        QString m_watchId; //!< Empty for the "..." row.
+        QString m_name;
+        VarCtl::DispFormat m_dispFormat;
+        bool m_changed; //!< Value differs from the last stop.
+    };
+
+    Item* getItem(const QModelIndex &index) const;
+    QModelIndex indexOf(Item *item, int column = COLUMN_NAME) const;
+    void forgetItem(Item *item);
+    void removeChildren(Item *item);
+    void renumber(Item *parent, int fromRow);
+
+private:
+    Item m_root;
+    QHash<QString, Item*> m_itemMap; //!< Items indexed by watchId.
+    QSet<QString> m_dirty; //!< Watches to report in the next dataChanged().
+    QTimer m_updateTimer;
+    bool m_nameEditable;
+};
+
+#endif // FILE__VARWATCHMODEL_H
@@ -10,13 +10,14 @@
 #define WATCHVAR_CTL_H
 
 #include <QString>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QMenu>
 #include <QKeyEvent>
 
 
 #include "core.h"
 #include "varctl.h"
+#include "varwatchmodel.h"
 
 
 class WatchVarCtl : public VarCtl
@@ -25,33 +26,26 @@ class WatchVarCtl : public VarCtl
 
 public:
     WatchVarCtl();
-    
-    void setWidget(QTreeWidget *varWidget);
+
+    void setWidget(QTreeView *varWidget);
 
     void ICore_onWatchVarChanged(VarWatch &watch);
     void ICore_onWatchVarChildAdded(VarWatch &watch);
     void ICore_onWatchVarDeleted(VarWatch &watch);
-    
+
     void addNewWatch(QString varName);
     void deleteSelected();
 
     void onKeyPress(QKeyEvent *keyEvent);
 
 private:
-    QString getWatchId(QTreeWidgetItem* item);
-
     void selectedChangeDisplayFormat(VarCtl::DispFormat fmt);
 
-    QString getDisplayString(QString watchId);
-    
-    void sync(QTreeWidgetItem * parentItem, VarWatch &watch);
-    QTreeWidgetItem* priv_findItemByWatchId(QString watchId);
-    
 public slots:
-    void onWatchWidgetItemDoubleClicked(QTreeWidgetItem *item, int column);
-    void onWatchWidgetCurrentItemChanged ( QTreeWidgetItem * current, int column );
-    void onWatchWidgetItemExpanded(QTreeWidgetItem *item );
-    void onWatchWidgetItemCollapsed(QTreeWidgetItem *item);
+    void onWatchWidgetItemDoubleClicked(const QModelIndex &index);
+    void onWatchWidgetNameEdited(const QModelIndex &index, QString newName);
+    void onWatchWidgetValueEdited(const QModelIndex &index, QString newValue);
+    void onWatchWidgetItemExpanded(const QModelIndex &index);
 
     void onContextMenu ( const QPoint &pos);
 
@@ -66,8 +60,8 @@ private:
     void fillInVars();
 
 private:
-    QTreeWidget *m_varWidget;
-    VarCtl::DispInfoMap m_watchVarDispInfo;
+    QTreeView *m_varWidget;
+    VarWatchModel m_model;
     QMenu m_popupMenu;
 
 };
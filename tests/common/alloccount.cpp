@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "alloccount.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <new>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+
+unsigned long long g_allocCount = 0;
+unsigned long long g_allocBytes = 0;
+long long g_liveBytes = 0;
+
+
+#ifdef __GLIBC__
+// Qt allocates most of its data with malloc() so count those as well.
+// Every function that returns a block that is released with free() must
+// be wrapped, or free() subtracts bytes from g_liveBytes that were never added.
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+extern "C" void *__libc_valloc(size_t size);
+extern "C" void *__libc_pvalloc(size_t size);
+extern "C" void __libc_free(void *ptr);
+
+
+static void *countAlloc(void *ptr, size_t size)
+{
+    __sync_fetch_and_add(&g_allocCount, 1);
+    __sync_fetch_and_add(&g_allocBytes, size);
+    if(ptr)
+        __sync_fetch_and_add(&g_liveBytes, (long long)malloc_usable_size(ptr));
+    return ptr;
+}
+
+extern "C" void *malloc(size_t size)
+{
+    return countAlloc(__libc_malloc(size), size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    return countAlloc(__libc_calloc(count, size), count*size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    __sync_fetch_and_add(&g_allocCount, 1);
+    __sync_fetch_and_add(&g_allocBytes, size);
+    long long oldSize = ptr ? (long long)malloc_usable_size(ptr) : 0;
+    void *newPtr = __libc_realloc(ptr, size);
+    if(newPtr)
+        __sync_fetch_and_add(&g_liveBytes, (long long)malloc_usable_size(newPtr) - oldSize);
+    else if(size == 0)
+        __sync_fetch_and_sub(&g_liveBytes, oldSize);
+    return newPtr;
+}
+
+extern "C" void *reallocarray(void *ptr, size_t count, size_t size)
+{
+    if(size != 0 && count > ((size_t)-1)/size)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return realloc(ptr, count*size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    return countAlloc(__libc_memalign(alignment, size), size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    return countAlloc(__libc_memalign(alignment, size), size);
+}
+
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    // Must be a power of two and a multiple of sizeof(void*)
+    if(alignment % sizeof(void*) != 0 || (alignment & (alignment-1)) != 0 || alignment == 0)
+        return EINVAL;
+    void *ptr = countAlloc(__libc_memalign(alignment, size), size);
+    if(!ptr)
+        return ENOMEM;
+    *memptr = ptr;
+    return 0;
+}
+
+extern "C" void *valloc(size_t size)
+{
+    return countAlloc(__libc_valloc(size), size);
+}
+
+extern "C" void *pvalloc(size_t size)
+{
+    return countAlloc(__libc_pvalloc(size), size);
+}
+
+extern "C" void free(void *ptr)
+{
+    if(ptr)
+        __sync_fetch_and_sub(&g_liveBytes, (long long)malloc_usable_size(ptr));
+    __libc_free(ptr);
+}
+
+#else
+
+void *operator new(size_t size)
+{
+    __sync_fetch_and_add(&g_allocCount, 1);
+    __sync_fetch_and_add(&g_allocBytes, size);
+    void *ptr = malloc(size ? size : 1);
+    if(!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) throw()
+{
+    free(ptr);
+}
+
+#endif
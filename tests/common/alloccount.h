@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__ALLOCCOUNT_H
+#define FILE__ALLOCCOUNT_H
+
+/*
+ * Counts the memory allocations of the benchmarks (see alloccount.cpp).
+ *
+ * With glibc all of the malloc() family is counted, otherwise only
+ * operator new.
+ */
+
+extern unsigned long long g_allocCount; //!< Number of allocations.
+extern unsigned long long g_allocBytes; //!< Number of bytes requested.
+extern long long g_liveBytes; //!< Bytes currently allocated (only with glibc).
+
+#endif // FILE__ALLOCCOUNT_H
@@ -0,0 +1,100 @@
+#include <assert.h>
+#include "../../src/dwarflinetable.h"
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_SOURCE_FILENAME   "test_prog.c"
+#define TEST_PROGRAM_FILENAME  "test_prog"
+
+void test_verify_(int lineNo, int t, const char *testStr)
+{
+    if(!t)
+    {
+        fprintf(stderr, "Test failed L%d: '%s'\n", lineNo, testStr);
+        exit(1);
+    }
+}
+#define test_verify(t)  test_verify_(__LINE__, t, #t)
+
+
+// The lines with code are 2,4,5,8,9,11 and 12 (with -O0)
+static const char *g_testSource =
+    "int add(int a, int b)\n"
+    "{\n"
+    "    // A comment\n"
+    "    return a + b;\n"
+    "}\n"
+    "\n"
+    "int main(void)\n"
+    "{\n"
+    "    int x = add(1, 2);\n"
+    "\n"
+    "    return x;\n"
+    "}\n";
+
+
+void writeSource()
+{
+    FILE *f = fopen(TEST_SOURCE_FILENAME, "wb");
+    test_verify(f != NULL);
+    fputs(g_testSource, f);
+    fclose(f);
+}
+
+
+/**
+ * @brief Compiles the test program with a DWARF version and checks its line table.
+ */
+void testDwarfVersion(int dwarfVersion)
+{
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd), "gcc -g -gdwarf-%d -O0 -o %s %s",
+                dwarfVersion, TEST_PROGRAM_FILENAME, TEST_SOURCE_FILENAME);
+    test_verify(system(cmd) == 0);
+
+    char cwd[1024];
+    test_verify(getcwd(cwd, sizeof(cwd)) != NULL);
+    QString sourcePath = QString(cwd) + "/" + TEST_SOURCE_FILENAME;
+
+    DwarfLineTable table;
+    test_verify(table.load(TEST_PROGRAM_FILENAME) == 0);
+    test_verify(table.isLoaded());
+    test_verify(table.getFileCount() >= 1);
+    test_verify(table.hasFile(sourcePath));
+
+    QVector<int> expectedLines;
+    expectedLines.append(2);
+    expectedLines.append(4);
+    expectedLines.append(5);
+    expectedLines.append(8);
+    expectedLines.append(9);
+    expectedLines.append(11);
+    expectedLines.append(12);
+    test_verify(table.getCodeLines(sourcePath) == expectedLines);
+
+    test_verify(table.findCodeLine(sourcePath, 1) == 2);
+    test_verify(table.findCodeLine(sourcePath, 3) == 4);
+    test_verify(table.findCodeLine(sourcePath, 6) == 8);
+    test_verify(table.findCodeLine(sourcePath, 10) == 11);
+    test_verify(table.findCodeLine(sourcePath, 13) == -1);
+    test_verify(table.findCodeLine("/no/such/file.c", 1) == -1);
+
+    unlink(TEST_PROGRAM_FILENAME);
+}
+
+
+int main(int argc, char *argv[])
+{
+    Q_UNUSED(argc);
+    Q_UNUSED(argv);
+
+    writeSource();
+    testDwarfVersion(4);
+    testDwarfVersion(5);
+    unlink(TEST_SOURCE_FILENAME);
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,24 @@
+QT +=  core
+
+TEMPLATE = app
+
+SOURCES += test_dwarflinetable.cpp
+
+
+SOURCES+=../../src/dwarflinetable.cpp
+HEADERS+=../../src/dwarflinetable.h
+
+SOURCES+=../../src/tracelog.cpp
+HEADERS+=../../src/tracelog.h
+SOURCES+=../../src/log.cpp
+HEADERS+=../../src/log.h
+SOURCES+=../../src/util.cpp ../../src/detectdistro.cpp
+HEADERS+=../../src/util.h  ../../src/detectdistro.h
+
+
+
+QMAKE_CXXFLAGS += -I../../src  -g 
+
+
+TARGET=test_dwarflinetable
+
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+/*
+ * A stand-in for gdb that replays a recorded MI session.
+ *
+ * The transcript is the log written by gede when the debug log is enabled
+ * (gede_gdb_log.txt). Each command received on stdin is looked up in the
+ * transcript and the output that gdb gave for it is written to stdout.
+ *
+ * Options can be given on the commandline or in the environment (since
+ * gede starts gdb with only '--interpreter=mi2'):
+ *   --transcript FILE      / FAKEGDB_TRANSCRIPT
+ *   --latency-us N         / FAKEGDB_LATENCY_US     Delay before each response.
+ *   --bytes-per-sec N      / FAKEGDB_BYTES_PER_SEC  Limits the output rate (0=unlimited).
+ *   --strict               / FAKEGDB_STRICT=1       Unknown commands gives an error.
+ */
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QFile>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+
+/**
+ * @brief A command and the output gdb gave after it.
+ */
+class Exchange
+{
+public:
+    QString m_command;
+    QList<QByteArray> m_output;
+};
+
+
+static QList<QByteArray> g_preamble; //!< Output before the first command.
+static QList<Exchange> g_exchanges;
+static int g_nextIdx = 0; //!< Where to start to look for the next command.
+static long g_latencyUs = 0;
+static long g_bytesPerSec = 0;
+static bool g_strict = false;
+
+
+/**
+ * @brief Loads a transcript (in the gede gdb log format).
+ * @return 0 on success.
+ */
+static int loadTranscript(QString filename)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        fprintf(stderr, "fakegdb: failed to open '%s'\n", qPrintable(filename));
+        return 1;
+    }
+
+    while(!file.atEnd())
+    {
+        QByteArray line = file.readLine();
+
+        // Remove the timestamp ("SS.mmm|")
+        int sepPos = line.indexOf('|');
+        if(sepPos == -1)
+            continue;
+        QByteArray text = line.mid(sepPos+1);
+        while(text.endsWith('\n') || text.endsWith('\r'))
+            text.chop(1);
+
+        if(text.startsWith("<< "))
+        {
+            Exchange exchange;
+            exchange.m_command = QString::fromUtf8(text.mid(3)).trimmed();
+            g_exchanges.append(exchange);
+        }
+        else if(text.startsWith(">> "))
+        {
+            if(g_exchanges.isEmpty())
+                g_preamble.append(text.mid(3));
+            else
+                g_exchanges.last().m_output.append(text.mid(3));
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Finds the recorded response for a command.
+ *
+ * An exact match is preferred. Otherwise a command with the same name is used
+ * (eg: '-var-create w12 @ x' matches '-var-create w11 @ x').
+ */
+static const Exchange *findExchange(QString command)
+{
+    QString commandName = command.section(' ', 0, 0);
+    int count = g_exchanges.size();
+
+    for(int pass = 0;pass < 2;pass++)
+    {
+        for(int k = 0;k < count;k++)
+        {
+            int idx = (g_nextIdx + k) % count;
+            const Exchange &exchange = g_exchanges[idx];
+            bool isMatch;
+            if(pass == 0)
+                isMatch = exchange.m_command == command;
+            else
+                isMatch = exchange.m_command.section(' ', 0, 0) == commandName;
+            if(isMatch)
+            {
+                g_nextIdx = idx+1;
+                return &exchange;
+            }
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Writes output (with the configured throughput).
+ */
+static void writeOutput(const QByteArray &data)
+{
+    if(g_bytesPerSec <= 0)
+    {
+        fwrite(data.constData(), 1, data.size(), stdout);
+        fflush(stdout);
+        return;
+    }
+
+    // Write in 10ms slices
+    long sliceSize = g_bytesPerSec / 100;
+    if(sliceSize < 1)
+        sliceSize = 1;
+    for(int pos = 0;pos < data.size();pos += sliceSize)
+    {
+        int len = std::min((int)sliceSize, data.size()-pos);
+        fwrite(data.constData()+pos, 1, len, stdout);
+        fflush(stdout);
+        usleep(10*1000);
+    }
+}
+
+
+static void writeLines(const QList<QByteArray> &lines)
+{
+    QByteArray data;
+    for(int i = 0;i < lines.size();i++)
+    {
+        data += lines[i];
+        data += '\n';
+    }
+    writeOutput(data);
+}
+
+
+int main(int argc, char *argv[])
+{
+    QString transcriptPath = getenv("FAKEGDB_TRANSCRIPT");
+    if(getenv("FAKEGDB_LATENCY_US"))
+        g_latencyUs = atol(getenv("FAKEGDB_LATENCY_US"));
+    if(getenv("FAKEGDB_BYTES_PER_SEC"))
+        g_bytesPerSec = atol(getenv("FAKEGDB_BYTES_PER_SEC"));
+    if(getenv("FAKEGDB_STRICT"))
+        g_strict = atoi(getenv("FAKEGDB_STRICT")) != 0;
+
+    for(int i = 1;i < argc;i++)
+    {
+        const char *curArg = argv[i];
+        if(strcmp(curArg, "--transcript") == 0 && i+1 < argc)
+            transcriptPath = argv[++i];
+        else if(strcmp(curArg, "--latency-us") == 0 && i+1 < argc)
+            g_latencyUs = atol(argv[++i]);
+        else if(strcmp(curArg, "--bytes-per-sec") == 0 && i+1 < argc)
+            g_bytesPerSec = atol(argv[++i]);
+        else if(strcmp(curArg, "--strict") == 0)
+            g_strict = true;
+        else if(strncmp(curArg, "--interpreter", 13) == 0)
+        {
+        }
+        else
+        {
+            fprintf(stderr, "Usage: fakegdb [--transcript FILE] [--latency-us N] [--bytes-per-sec N] [--strict]\n");
+            return 1;
+        }
+    }
+
+    if(!transcriptPath.isEmpty())
+    {
+        if(loadTranscript(transcriptPath))
+            return 1;
+    }
+
+    if(g_preamble.isEmpty())
+        g_preamble.append("(gdb) ");
+    writeLines(g_preamble);
+
+    char line[64*1024];
+    while(fgets(line, sizeof(line), stdin) != NULL)
+    {
+        QString command = QString::fromUtf8(line).trimmed();
+        if(command.isEmpty())
+            continue;
+
+        if(g_latencyUs > 0)
+            usleep(g_latencyUs);
+
+        if(command == "-gdb-exit")
+        {
+            writeOutput("^exit\n");
+            break;
+        }
+
+        const Exchange *exchange = findExchange(command);
+        if(exchange)
+            writeLines(exchange->m_output);
+        else
+        {
+            fprintf(stderr, "fakegdb: no recorded response for '%s'\n", qPrintable(command));
+            if(g_strict)
+                writeOutput("^error,msg=\"fakegdb: no recorded response\"\n(gdb) \n");
+            else
+                writeOutput("^done\n(gdb) \n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+
+
+QT +=  core
+QT -= gui
+
+TEMPLATE = app
+
+SOURCES+=fakegdb.cpp
+
+QMAKE_CXXFLAGS += -g
+
+
+TARGET=fakegdb
+
+
@@ -3,22 +3,132 @@
 #include "syntaxhighlightercxx.h"
 #include "syntaxhighlighterbasic.h"
 #include "syntaxhighlighterfortran.h"
+#include "syntaxhighlighterada.h"
+#include "syntaxhighlightergolang.h"
 #include "log.h"
 #include "util.h"
 
 #include <QCoreApplication>
 #include <QtGlobal>
 #include <QFile>
+#include <string.h>
 
 int dumpUsage()
 {
     printf("Usage: ./hltest SOURCE_FILE.c\n");
+    printf("       ./hltest --test\n");
     printf("Description:\n");
     printf("  Dumps syntax highlight info for a source file\n");
+    printf("  or checks the tokens of a few known snippets (--test).\n");
     return 0;
 }
 
 
+/**
+ * @brief A snippet and the tokens it is expected to give.
+ *
+ * The tokens are written as TYPE:TEXT separated by '|' (spaces are left out)
+ * and the rows are separated by '\n'.
+ */
+struct TestCase
+{
+    const char *m_language;
+    const char *m_text;
+    const char *m_expected;
+};
+
+static const TestCase g_testCases[] =
+{
+    // A Rust lifetime is read as a char literal up to the next quote
+    { "rust", "fn f<'a>(x: &'a i32)",
+        "K:fn|W:f|W:<|S:'a>(x: &'|W:a|K:i32|W:)" },
+
+    // ...and ends at the end of the row if there is none (it used to continue on the next rows)
+    { "rust", "struct S<'a> {\n    x: &'a u8,\n}",
+        "K:struct|W:S|W:<|S:'a> {\nW:x:|W:&'a|K:u8|W:,\nW:}" },
+
+    // An Ada attribute tick inside a word is part of the word
+    { "ada", "Len := X'Length; -- the length\nPut ('A');",
+        "W:Len|W::|W:=|W:X'Length|W:;|C:-- the length\nW:Put|W:(|S:'A'|W:)|W:;" },
+
+    // Go raw strings are not recognized, the backquotes are read as words
+    { "go", "s := `a \"b\"`\nt := 1",
+        "W:s|W::|W:=|W:`a|S:\"b\"|W:`\nW:t|W::|W:=|N:1" },
+
+    // A Fortran comment must be first on the row (after spaces)
+    { "fortran", "! header\n   ! indented\n  x = 1 ! not a comment\n  print *, x",
+        "C:! header\nC:! indented\nW:x|W:=|N:1|W:!|W:not|W:a|W:comment\nK:print|W:*|W:,|W:x" },
+};
+
+
+static SyntaxHighlighter *createHighlighter(QString language)
+{
+    if(language == "rust")
+        return new SyntaxHighlighterRust();
+    if(language == "ada")
+        return new SyntaxHighlighterAda();
+    if(language == "go")
+        return new SyntaxHighlighterGo();
+    if(language == "fortran")
+        return new SyntaxHighlighterFortran();
+    if(language == "basic")
+        return new SyntaxHighlighterBasic();
+    return new SyntaxHighlighterCxx();
+}
+
+
+/**
+ * @brief Returns the tokens of all rows in the format used by TestCase.
+ */
+static QString dumpTokens(SyntaxHighlighter *scanner)
+{
+    static const char typeNames[] = { 'C', 'W', 'N', 'K', 'P', 'I', 'S' };
+    QStringList rowList;
+    for(unsigned int rowIdx = 0;rowIdx < scanner->getRowCount();rowIdx++)
+    {
+        int fieldCount = 0;
+        const TextField *fields = scanner->getRow(rowIdx, &fieldCount);
+        QStringList tokenList;
+        for(int colIdx = 0; colIdx < fieldCount;colIdx++)
+        {
+            const TextField &field = fields[colIdx];
+            if(field.m_type == TextField::SPACES)
+                continue;
+            tokenList += QString("%1:%2").arg(typeNames[field.m_type]).arg(scanner->getText(field));
+        }
+        rowList += tokenList.join("|");
+    }
+    return rowList.join("\n");
+}
+
+
+static int runTests()
+{
+    Settings cfg;
+    int failCount = 0;
+    int caseCount = (int)(sizeof(g_testCases)/sizeof(g_testCases[0]));
+    for(int i = 0;i < caseCount;i++)
+    {
+        const TestCase &testCase = g_testCases[i];
+        SyntaxHighlighter *scanner = createHighlighter(testCase.m_language);
+        scanner->setConfig(&cfg);
+        scanner->colorize(testCase.m_text);
+
+        QString result = dumpTokens(scanner);
+        if(result != testCase.m_expected)
+        {
+            printf("FAIL %s case %d\n", testCase.m_language, i);
+            printf("  Expected: %s\n", qPrintable(QString(testCase.m_expected).replace("\n", "\\n")));
+            printf("  Got:      %s\n", qPrintable(result.replace("\n", "\\n")));
+            failCount++;
+        }
+        delete scanner;
+    }
+    printf("%d of %d cases passed\n", caseCount-failCount, caseCount);
+    return failCount == 0 ? 0 : 1;
+}
+
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc,argv);
@@ -28,7 +138,9 @@ int main(int argc, char *argv[])
     for(int i = 1;i < argc;i++)
     {
         const char *curArg = argv[i];
-        if(curArg[0] == '-')
+        if(strcmp(curArg, "--test") == 0)
+            return runTests();
+        else if(curArg[0] == '-')
             return dumpUsage();
         else
         {
@@ -72,12 +184,13 @@ int main(int argc, char *argv[])
 
     for(unsigned int rowIdx = 0;rowIdx < scanner->getRowCount();rowIdx++)
     {
-        QVector<TextField*> colList = scanner->getRow(rowIdx);
+        int fieldCount = 0;
+        const TextField *fields = scanner->getRow(rowIdx, &fieldCount);
         printf("%3d | ", rowIdx);
-        for(int colIdx = 0; colIdx < colList.size();colIdx++)
+        for(int colIdx = 0; colIdx < fieldCount;colIdx++)
         {
-            TextField* field = colList[colIdx];
-            printf("'\033[1;32m%s\033[1;0m' ", stringToCStr(field->m_text));
+            const TextField &field = fields[colIdx];
+            printf("'\033[1;32m%s\033[1;0m' ", stringToCStr(scanner->getText(field)));
         }
         printf("\n");
     }
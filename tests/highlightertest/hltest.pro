@@ -12,6 +12,9 @@ HEADERS+=../../src/syntaxhighlighterrust.h
 SOURCES+=../../src/syntaxhighlighterfortran.cpp
 HEADERS+=../../src/syntaxhighlighterfortran.h
 
+SOURCES+=../../src/syntaxhighlighterada.cpp ../../src/syntaxhighlightergolang.cpp
+HEADERS+=../../src/syntaxhighlighterada.h ../../src/syntaxhighlightergolang.h
+
 SOURCES+=../../src/parsecharqueue.cpp
 HEADERS+=../../src/parsecharqueue.h
 
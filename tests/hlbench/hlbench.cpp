@@ -0,0 +1,691 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+/*
+ * Benchmarks the syntax highlighters and the tag scanners.
+ *
+ * Each highlighter colorizes a synthetic corpus of its language and any
+ * real source files given with '--corpus'. The tag scanners then scan the
+ * same files. For each run the throughput, the number of allocations per
+ * line and the memory still held by the result are reported.
+ *
+ * With '--json', the results are also written as JSON so that they can be
+ * compared between builds.
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QVector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <sys/resource.h>
+
+#include "syntaxhighlightercxx.h"
+#include "syntaxhighlighterbasic.h"
+#include "syntaxhighlighterfortran.h"
+#include "syntaxhighlighterrust.h"
+#include "syntaxhighlighterada.h"
+#include "syntaxhighlightergolang.h"
+#include "tagscanner.h"
+#include "rusttagscanner.h"
+#include "adatagscanner.h"
+#include "settings.h"
+#include "config.h"
+#include "log.h"
+#include "util.h"
+#include "alloccount.h"
+
+
+#define CORPUS_DIRNAME   "hlbench_corpus"
+
+
+/**
+ * @brief Returns the peak resident set size of the process in kB.
+ */
+static long getPeakRssKb()
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss/1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+
+//----------------------------------------------------------------
+//
+//     -- Languages --
+//
+//----------------------------------------------------------------
+
+static const char g_cxxBlock[] =
+    "#include <stdio.h>\n"
+    "/*\n"
+    " * Block %1.\n"
+    " */\n"
+    "static int func%1(const char *str, int count)\n"
+    "{\n"
+    "    // Count the characters\n"
+    "    int sum = 0x%1;\n"
+    "    for(int i = 0;i < count;i++)\n"
+    "    {\n"
+    "        if(str[i] == '\\n' || str[i] == 'a')\n"
+    "            sum += i * 3.5f;\n"
+    "    }\n"
+    "    printf(\"func%1: %d\\n\", sum);\n"
+    "    return sum;\n"
+    "}\n"
+    "\n"
+    "class Class%1 : public Base\n"
+    "{\n"
+    "public:\n"
+    "    Class%1() : m_value(%1) {};\n"
+    "    virtual ~Class%1() {};\n"
+    "    int getValue() const { return m_ptr->x + m_value; };\n"
+    "private:\n"
+    "    int m_value;\n"
+    "};\n"
+    "#define MACRO%1(x)  ((x)+%1)\n"
+    "\n";
+
+static const char g_rustBlock[] =
+    "/// Function %1\n"
+    "fn func%1(values: &Vec<u32>, name: &str) -> u32 {\n"
+    "    // Sum the values\n"
+    "    let mut sum: u32 = %1;\n"
+    "    for v in values.iter() {\n"
+    "        if *v > 10 { sum += v * 2; }\n"
+    "    }\n"
+    "    println!(\"{}: {}\", name, sum);\n"
+    "    sum\n"
+    "}\n"
+    "\n"
+    "struct Struct%1 {\n"
+    "    value: i64,\n"
+    "    name: String,\n"
+    "}\n"
+    "\n"
+    "impl Struct%1 {\n"
+    "    pub fn new() -> Struct%1 {\n"
+    "        /* The default */\n"
+    "        Struct%1 { value: %1, name: String::from(\"s%1\") }\n"
+    "    }\n"
+    "}\n"
+    "\n";
+
+static const char g_goBlock[] =
+    "// Func%1 sums the values.\n"
+    "func Func%1(values []int, name string) int {\n"
+    "\tsum := %1\n"
+    "\tfor _, v := range values {\n"
+    "\t\tif v > 10 {\n"
+    "\t\t\tsum += v * 2\n"
+    "\t\t}\n"
+    "\t}\n"
+    "\tfmt.Printf(\"%s: %d\\n\", name, sum)\n"
+    "\treturn sum\n"
+    "}\n"
+    "\n"
+    "type Struct%1 struct {\n"
+    "\tvalue int64 /* The value */\n"
+    "\tname  string\n"
+    "}\n"
+    "\n";
+
+static const char g_adaBlock[] =
+    "-- Function %1\n"
+    "function Func%1 (Values : Int_Array; Name : String) return Integer is\n"
+    "   Sum : Integer := %1;\n"
+    "begin\n"
+    "   for I in Values'Range loop\n"
+    "      if Values (I) > 10 then\n"
+    "         Sum := Sum + Values (I) * 2;\n"
+    "      end if;\n"
+    "   end loop;\n"
+    "   Put_Line (Name & \": \" & Integer'Image (Sum));\n"
+    "   return Sum;\n"
+    "end Func%1;\n"
+    "\n"
+    "procedure Proc%1 is\n"
+    "begin\n"
+    "   null;\n"
+    "end Proc%1;\n"
+    "\n";
+
+static const char g_fortranBlock[] =
+    "! Subroutine %1\n"
+    "subroutine sub%1(values, n, total)\n"
+    "    integer, intent(in) :: n\n"
+    "    real, intent(in) :: values(n)\n"
+    "    real, intent(out) :: total\n"
+    "    integer :: i\n"
+    "    total = %1.0\n"
+    "    do i = 1, n\n"
+    "        if (values(i) > 10.0) then\n"
+    "            total = total + values(i) * 2.0\n"
+    "        end if\n"
+    "    end do\n"
+    "    print *, 'sub%1: ', total\n"
+    "end subroutine sub%1\n"
+    "\n";
+
+static const char g_basicBlock[] =
+    "' Sub %1\n"
+    "Sub Sub%1(values() As Integer, name As String)\n"
+    "    Dim sum As Integer = %1\n"
+    "    For i As Integer = 0 To UBound(values)\n"
+    "        If values(i) > 10 Then\n"
+    "            sum += values(i) * 2\n"
+    "        End If\n"
+    "    Next i\n"
+    "    rem Print the result\n"
+    "    Print name; \": \"; sum\n"
+    "End Sub\n"
+    "/' Block\n"
+    "   comment '/\n"
+    "\n";
+
+
+static SyntaxHighlighter *createCxx() { return new SyntaxHighlighterCxx(); }
+static SyntaxHighlighter *createRust() { return new SyntaxHighlighterRust(); }
+static SyntaxHighlighter *createGo() { return new SyntaxHighlighterGo(); }
+static SyntaxHighlighter *createAda() { return new SyntaxHighlighterAda(); }
+static SyntaxHighlighter *createFortran() { return new SyntaxHighlighterFortran(); }
+static SyntaxHighlighter *createBasic() { return new SyntaxHighlighterBasic(); }
+
+
+enum TagScannerType { SCANNER_CTAGS, SCANNER_RUST, SCANNER_ADA };
+
+/**
+ * @brief A language with its highlighter and tag scanner.
+ */
+struct Language
+{
+    const char *m_name;
+    const char *m_extensions; //!< Space separated, the first is used for the synthetic corpus.
+    SyntaxHighlighter *(*m_create)();
+    TagScannerType m_scanner;
+    const char *m_block; //!< Repeated to create the synthetic corpus.
+};
+
+static const Language g_languages[] =
+{
+    {"cxx", ".cpp .c .cc .cxx .h .hpp", createCxx, SCANNER_CTAGS, g_cxxBlock},
+    {"rust", RUST_FILE_EXTENSION, createRust, SCANNER_RUST, g_rustBlock},
+    {"go", GOLANG_FILE_EXTENSION, createGo, SCANNER_CTAGS, g_goBlock},
+    {"ada", ADA_FILE_EXTENSION, createAda, SCANNER_ADA, g_adaBlock},
+    {"fortran", ".f95 .f .for", createFortran, SCANNER_CTAGS, g_fortranBlock},
+    {"basic", ".bas", createBasic, SCANNER_CTAGS, g_basicBlock},
+};
+
+#define LANGUAGE_COUNT  ((int)(sizeof(g_languages)/sizeof(g_languages[0])))
+
+
+/**
+ * @brief Returns the language of a file (or -1 if unknown).
+ */
+static int findLanguage(QString filePath)
+{
+    QString extension = getExtensionPart(filePath).toLower();
+    if(extension.isEmpty())
+        return -1;
+    for(int langIdx = 0;langIdx < LANGUAGE_COUNT;langIdx++)
+    {
+        QStringList extList = QString(g_languages[langIdx].m_extensions).split(' ');
+        if(extList.contains(extension))
+            return langIdx;
+    }
+    return -1;
+}
+
+
+//----------------------------------------------------------------
+//
+//     -- Corpus --
+//
+//----------------------------------------------------------------
+
+/**
+ * @brief A source file read into memory.
+ */
+class SourceText
+{
+public:
+    SourceText() : m_byteCount(0), m_lineCount(0) {};
+
+    QString m_filePath;
+    QString m_text;
+    qint64 m_byteCount;
+    int m_lineCount;
+};
+
+
+/**
+ * @brief Reads a file the same way as CodeViewTab does before colorizing it.
+ * @return 0 on success.
+ */
+static int loadSource(QString filePath, SourceText *src)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+        return 1;
+    QByteArray content = file.readAll();
+
+    src->m_filePath = filePath;
+    src->m_byteCount = content.size();
+    src->m_text = QString::fromUtf8(content);
+    src->m_text.replace("\r", "");
+    src->m_lineCount = src->m_text.count('\n') + 1;
+    return 0;
+}
+
+
+/**
+ * @brief Writes a synthetic source file of at least lineCount lines.
+ * @return 0 on success.
+ */
+static int generateSource(int langIdx, int lineCount, QString filePath)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+        return 1;
+
+    QString block = g_languages[langIdx].m_block;
+    int blockLineCount = block.count('\n');
+    for(int i = 0;i*blockLineCount < lineCount;i++)
+        file.write(block.arg(i).toUtf8());
+    return 0;
+}
+
+
+/**
+ * @brief Finds the source files of known languages in a file or directory.
+ */
+static void findSources(QString path, QVector<QStringList> *filesByLang)
+{
+    QFileInfo info(path);
+    if(info.isFile())
+    {
+        int langIdx = findLanguage(path);
+        if(langIdx == -1)
+            warnMsg("Unknown language of '%s'", stringToCStr(path));
+        else
+            (*filesByLang)[langIdx].append(path);
+        return;
+    }
+
+    QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+    while(it.hasNext())
+    {
+        QString filePath = it.next();
+        int langIdx = findLanguage(filePath);
+        if(langIdx != -1)
+            (*filesByLang)[langIdx].append(filePath);
+    }
+}
+
+
+//----------------------------------------------------------------
+//
+//     -- Benchmark --
+//
+//----------------------------------------------------------------
+
+/**
+ * @brief The measurements of one benchmark.
+ */
+class BenchResult
+{
+public:
+    BenchResult()
+        : m_fileCount(0), m_byteCount(0), m_lineCount(0), m_passes(0),
+        m_totalTimeNs(0), m_bestTimeNs(0), m_allocCount(0), m_allocBytes(0),
+        m_retainedBytes(0), m_tagCount(0), m_peakRssKb(0) {};
+
+    double getMBPerSec(qint64 timeNs) const
+    {
+        return timeNs > 0 ? (m_byteCount/(1024.0*1024.0)) / (timeNs/1e9) : 0;
+    };
+
+    double getAvgMBPerSec() const { return m_passes > 0 ? getMBPerSec(m_totalTimeNs/m_passes) : 0; };
+    double getBestMBPerSec() const { return getMBPerSec(m_bestTimeNs); };
+    double getAllocsPerLine() const
+    {
+        qint64 lines = m_lineCount*(qint64)m_passes;
+        return lines > 0 ? m_allocCount/(double)lines : 0;
+    };
+    double getAllocBytesPerLine() const
+    {
+        qint64 lines = m_lineCount*(qint64)m_passes;
+        return lines > 0 ? m_allocBytes/(double)lines : 0;
+    };
+    double getRetainedBytesPerLine() const { return m_lineCount > 0 ? m_retainedBytes/(double)m_lineCount : 0; };
+
+    QString m_name; //!< Eg: "highlight/cxx".
+    QString m_corpus; //!< "synthetic" or "real".
+    int m_fileCount;
+    qint64 m_byteCount;
+    qint64 m_lineCount;
+    int m_passes;
+    qint64 m_totalTimeNs;
+    qint64 m_bestTimeNs;
+    unsigned long long m_allocCount;
+    unsigned long long m_allocBytes;
+    long long m_retainedBytes; //!< Memory held by the result of the last pass.
+    int m_tagCount;
+    long m_peakRssKb; //!< Peak RSS of the process after the benchmark.
+};
+
+
+static void addCorpusSize(BenchResult *result, const QList<SourceText> &sources)
+{
+    result->m_fileCount = sources.size();
+    for(int i = 0;i < sources.size();i++)
+    {
+        result->m_byteCount += sources[i].m_byteCount;
+        result->m_lineCount += sources[i].m_lineCount;
+    }
+}
+
+
+/**
+ * @brief Colorizes all the sources with a new highlighter for each file.
+ */
+static BenchResult runHighlighterBench(int langIdx, QString corpus, const QList<SourceText> &sources, int passes)
+{
+    const Language &lang = g_languages[langIdx];
+    Settings cfg;
+
+    BenchResult result;
+    result.m_name = QString("highlight/") + lang.m_name;
+    result.m_corpus = corpus;
+    result.m_passes = passes;
+    addCorpusSize(&result, sources);
+
+    QElapsedTimer timer;
+    for(int p = 0;p < passes;p++)
+    {
+        QList<SyntaxHighlighter*> highlighters;
+        long long liveBytes = g_liveBytes;
+        unsigned long long allocCount = g_allocCount;
+        unsigned long long allocBytes = g_allocBytes;
+
+        timer.start();
+        for(int i = 0;i < sources.size();i++)
+        {
+            SyntaxHighlighter *highlighter = lang.m_create();
+            highlighter->setConfig(&cfg);
+            highlighter->colorize(sources[i].m_text);
+            highlighters.append(highlighter);
+        }
+        qint64 timeNs = timer.nsecsElapsed();
+
+        result.m_allocCount += g_allocCount - allocCount;
+        result.m_allocBytes += g_allocBytes - allocBytes;
+        result.m_retainedBytes = g_liveBytes - liveBytes;
+        result.m_totalTimeNs += timeNs;
+        if(p == 0 || timeNs < result.m_bestTimeNs)
+            result.m_bestTimeNs = timeNs;
+
+        for(int i = 0;i < highlighters.size();i++)
+            delete highlighters[i];
+    }
+
+    result.m_peakRssKb = getPeakRssKb();
+    return result;
+}
+
+
+/**
+ * @brief Scans all the sources with the tag scanner of the language.
+ */
+static BenchResult runTagScannerBench(int langIdx, QString corpus, const QList<SourceText> &sources, int passes)
+{
+    const Language &lang = g_languages[langIdx];
+    Settings cfg;
+
+    BenchResult result;
+    if(lang.m_scanner == SCANNER_RUST)
+        result.m_name = "tags/RustTagScanner";
+    else if(lang.m_scanner == SCANNER_ADA)
+        result.m_name = "tags/AdaTagScanner";
+    else
+        result.m_name = QString("tags/TagScanner/") + lang.m_name;
+    result.m_corpus = corpus;
+    result.m_passes = passes;
+    addCorpusSize(&result, sources);
+
+    TagScanner ctagsScanner;
+    ctagsScanner.init(&cfg);
+
+    QElapsedTimer timer;
+    for(int p = 0;p < passes;p++)
+    {
+        QList<QList<Tag> > tagLists;
+        long long liveBytes = g_liveBytes;
+        unsigned long long allocCount = g_allocCount;
+        unsigned long long allocBytes = g_allocBytes;
+
+        timer.start();
+        for(int i = 0;i < sources.size();i++)
+        {
+            QList<Tag> tagList;
+            QString filePath = sources[i].m_filePath;
+            if(lang.m_scanner == SCANNER_RUST)
+            {
+                RustTagScanner scanner;
+                scanner.setConfig(&cfg);
+                scanner.scan(filePath, &tagList);
+            }
+            else if(lang.m_scanner == SCANNER_ADA)
+            {
+                AdaTagScanner scanner;
+                scanner.setConfig(&cfg);
+                scanner.scan(filePath, &tagList);
+            }
+            else
+                ctagsScanner.scan(filePath, &tagList);
+            tagLists.append(tagList);
+        }
+        qint64 timeNs = timer.nsecsElapsed();
+
+        result.m_allocCount += g_allocCount - allocCount;
+        result.m_allocBytes += g_allocBytes - allocBytes;
+        result.m_retainedBytes = g_liveBytes - liveBytes;
+        result.m_totalTimeNs += timeNs;
+        if(p == 0 || timeNs < result.m_bestTimeNs)
+            result.m_bestTimeNs = timeNs;
+
+        result.m_tagCount = 0;
+        for(int i = 0;i < tagLists.size();i++)
+            result.m_tagCount += tagLists[i].size();
+    }
+
+    result.m_peakRssKb = getPeakRssKb();
+    return result;
+}
+
+
+static void printReport(const QList<BenchResult> &results)
+{
+    printf("%-24s %-9s %6s %9s %9s %9s %10s %11s %12s %8s\n",
+            "benchmark", "corpus", "files", "lines", "MB/s", "best MB/s", "allocs/ln", "alloc B/ln", "retained B/ln", "tags");
+    for(int i = 0;i < results.size();i++)
+    {
+        const BenchResult &r = results[i];
+        printf("%-24s %-9s %6d %9lld %9.1f %9.1f %10.2f %11.1f %12.1f %8d\n",
+                stringToCStr(r.m_name), stringToCStr(r.m_corpus), r.m_fileCount, (long long)r.m_lineCount,
+                r.getAvgMBPerSec(), r.getBestMBPerSec(),
+                r.getAllocsPerLine(), r.getAllocBytesPerLine(), r.getRetainedBytesPerLine(),
+                r.m_tagCount);
+    }
+    printf("peak RSS: %ld kB\n", getPeakRssKb());
+}
+
+
+/**
+ * @brief Writes the results as JSON.
+ * @return 0 on success.
+ */
+static int writeJson(QString filename, const QList<BenchResult> &results)
+{
+    FILE *f = fopen(stringToCStr(filename), "w");
+    if(!f)
+        return 1;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"benchmark\": \"hlbench\",\n");
+    fprintf(f, "  \"peakRssKb\": %ld,\n", getPeakRssKb());
+    fprintf(f, "  \"results\": [\n");
+    for(int i = 0;i < results.size();i++)
+    {
+        const BenchResult &r = results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"corpus\": \"%s\", \"files\": %d, \"bytes\": %lld, \"lines\": %lld, \"passes\": %d,"
+                " \"avgMBPerSec\": %.3f, \"bestMBPerSec\": %.3f, \"allocsPerLine\": %.4f, \"allocBytesPerLine\": %.2f,"
+                " \"retainedBytes\": %lld, \"retainedBytesPerLine\": %.2f, \"tags\": %d, \"peakRssKb\": %ld}%s\n",
+                stringToCStr(r.m_name), stringToCStr(r.m_corpus), r.m_fileCount,
+                (long long)r.m_byteCount, (long long)r.m_lineCount, r.m_passes,
+                r.getAvgMBPerSec(), r.getBestMBPerSec(), r.getAllocsPerLine(), r.getAllocBytesPerLine(),
+                r.m_retainedBytes, r.getRetainedBytesPerLine(), r.m_tagCount, r.m_peakRssKb,
+                i+1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+    fclose(f);
+    return 0;
+}
+
+
+/**
+ * @brief Runs the highlighter and the tag scanner of a language over a list of files.
+ * @return 0 on success.
+ */
+static int runLanguage(int langIdx, QString corpus, QStringList fileList, int passes, bool runTags,
+                       QList<BenchResult> *results)
+{
+    if(fileList.isEmpty())
+        return 0;
+
+    QList<SourceText> sources;
+    for(int i = 0;i < fileList.size();i++)
+    {
+        SourceText src;
+        if(loadSource(fileList[i], &src))
+        {
+            errorMsg("Failed to read '%s'", stringToCStr(fileList[i]));
+            return 1;
+        }
+        sources.append(src);
+    }
+
+    results->append(runHighlighterBench(langIdx, corpus, sources, passes));
+    if(runTags)
+        results->append(runTagScannerBench(langIdx, corpus, sources, passes));
+    return 0;
+}
+
+
+static int dumpUsage()
+{
+    printf("Usage: hlbench [OPTIONS]\n");
+    printf("\n");
+    printf("Where OPTIONS are:\n");
+    printf("  --lines N             Number of lines in the synthetic file of each language\n");
+    printf("                        (default 100000, 0 to skip the synthetic corpus).\n");
+    printf("  --corpus PATH         A source file or a directory with source files to add to the\n");
+    printf("                        real corpus. May be given several times.\n");
+    printf("  --passes N            Number of times to process each corpus (default 5).\n");
+    printf("  --no-tags             Only benchmark the highlighters.\n");
+    printf("  --json FILE           Write the results as JSON to FILE.\n");
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList corpusPaths;
+    QString jsonPath;
+    int lineCount = 100000;
+    int passes = 5;
+    bool runTags = true;
+
+    for(int i = 1;i < argc;i++)
+    {
+        const char *curArg = argv[i];
+        if(strcmp(curArg, "--no-tags") == 0)
+            runTags = false;
+        else if(i+1 >= argc)
+            return dumpUsage();
+        else if(strcmp(curArg, "--lines") == 0)
+            lineCount = std::max(0, atoi(argv[++i]));
+        else if(strcmp(curArg, "--corpus") == 0)
+            corpusPaths.append(argv[++i]);
+        else if(strcmp(curArg, "--passes") == 0)
+            passes = std::max(1, atoi(argv[++i]));
+        else if(strcmp(curArg, "--json") == 0)
+            jsonPath = argv[++i];
+        else
+            return dumpUsage();
+    }
+
+    QList<BenchResult> results;
+
+    // Synthetic corpus
+    if(lineCount > 0)
+    {
+        QDir().mkpath(CORPUS_DIRNAME);
+        for(int langIdx = 0;langIdx < LANGUAGE_COUNT;langIdx++)
+        {
+            const Language &lang = g_languages[langIdx];
+            QString extension = QString(lang.m_extensions).split(' ').first();
+            QString filePath = QString(CORPUS_DIRNAME) + "/synthetic" + extension;
+            if(generateSource(langIdx, lineCount, filePath))
+            {
+                errorMsg("Failed to write '%s'", stringToCStr(filePath));
+                return 1;
+            }
+            if(runLanguage(langIdx, "synthetic", QStringList(filePath), passes, runTags, &results))
+                return 1;
+        }
+    }
+
+    // Real corpus
+    QVector<QStringList> filesByLang(LANGUAGE_COUNT);
+    for(int i = 0;i < corpusPaths.size();i++)
+        findSources(corpusPaths[i], &filesByLang);
+    for(int langIdx = 0;langIdx < LANGUAGE_COUNT;langIdx++)
+    {
+        if(runLanguage(langIdx, "real", filesByLang[langIdx], passes, runTags, &results))
+            return 1;
+    }
+
+    printReport(results);
+
+    if(!jsonPath.isEmpty())
+    {
+        if(writeJson(jsonPath, results))
+        {
+            errorMsg("Failed to write '%s'", stringToCStr(jsonPath));
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
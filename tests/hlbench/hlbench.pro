@@ -0,0 +1,38 @@
+
+
+QT +=  core
+
+TEMPLATE = app
+
+SOURCES+=hlbench.cpp
+
+SOURCES+=../../src/syntaxhighlighter.cpp ../../src/syntaxhighlighterbasic.cpp ../../src/syntaxhighlightercxx.cpp
+SOURCES+=../../src/syntaxhighlighterrust.cpp ../../src/syntaxhighlightergolang.cpp ../../src/syntaxhighlighterada.cpp
+HEADERS+=../../src/syntaxhighlighter.h ../../src/syntaxhighlighterbasic.h ../../src/syntaxhighlightercxx.h
+HEADERS+=../../src/syntaxhighlighterrust.h ../../src/syntaxhighlightergolang.h ../../src/syntaxhighlighterada.h
+
+SOURCES+=../../src/syntaxhighlighterfortran.cpp
+HEADERS+=../../src/syntaxhighlighterfortran.h
+
+SOURCES+=../../src/tagscanner.cpp ../../src/rusttagscanner.cpp ../../src/adatagscanner.cpp
+HEADERS+=../../src/tagscanner.h ../../src/rusttagscanner.h ../../src/adatagscanner.h
+
+SOURCES+=../../src/settings.cpp ../../src/ini.cpp
+HEADERS+=../../src/settings.h ../../src/ini.h
+
+SOURCES+=../../src/log.cpp
+HEADERS+=../../src/log.h
+SOURCES+=../../src/util.cpp ../../src/detectdistro.cpp
+HEADERS+=../../src/util.h  ../../src/detectdistro.h
+
+
+
+SOURCES+=../common/alloccount.cpp
+HEADERS+=../common/alloccount.h
+
+QMAKE_CXXFLAGS += -I../../src -I../common  -g
+
+
+TARGET=hlbench
+
+
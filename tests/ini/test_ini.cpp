@@ -64,6 +64,42 @@ void readIni()
     
 }
 
+void readHandWrittenIni()
+{
+    FILE *f = fopen(TEST_INI_FILENAME, "wb");
+    test_verify(f != NULL);
+    fputs("# A comment\r\n"
+          "top=1\r\n"
+          "[group1]\n"
+          "  spaced  =  \"a = b\"  \n"
+          "multi=\"line1\nline2\"\n"
+          "\n"
+          "[group2]\n"
+          "bytes=@ByteArray(\\x01\\x02)\n"
+          "int= 42\n"
+          "noequal\n"
+          "[group1]\n"
+          "last=done", f);
+    fclose(f);
+
+    Ini ini;
+    test_verify(ini.appendLoad(TEST_INI_FILENAME) == 0);
+    test_verify(ini.getInt("top") == 1);
+    test_verify(ini.getString("group1/spaced") == "a = b");
+    test_verify(ini.getString("group1/multi") == "line1\nline2");
+    test_verify(ini.getInt("group2/int") == 42);
+    test_verify(ini.getString("group1/last") == "done");
+
+    QByteArray byteArray;
+    ini.getByteArray("group2/bytes", &byteArray);
+    test_verify(byteArray.size() == 2);
+    test_verify(byteArray[0] == 1 && byteArray[1] == 2);
+
+    // Copies must keep the group names
+    Ini iniCopy(ini);
+    test_verify(iniCopy.getString("group1/spaced", "missing") == "a = b");
+}
+
 int main(int argc,char *argv[])
 {
     Q_UNUSED(argc);
@@ -76,6 +112,8 @@ int main(int argc,char *argv[])
 
     readIni();
 
+    readHandWrittenIni();
+
     unlink(TEST_INI_FILENAME);
     printf("All INI tests done\n");
     
@@ -0,0 +1,620 @@
+/*
+ * Copyright (C) 2026 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+/*
+ * Benchmarks the GdbCom/Core path by running scripted sessions against
+ * fakegdb (see tests/fakegdb).
+ *
+ * Unless a transcript is given, a synthetic one is generated with a
+ * configurable number of source files, stack frames and watch children.
+ *
+ * With '--mode decode', the variable values found in the transcript (or a
+ * built-in sample set) are decoded instead, both with the scalar fast path
+ * and with the general tokenizer.
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDir>
+#include <QVector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "core.h"
+#include "com.h"
+#include "gdbmiparser.h"
+#include "settings.h"
+#include "log.h"
+#include "util.h"
+#include "alloccount.h"
+
+
+#define TRANSCRIPT_FILENAME   "mibench_transcript.txt"
+
+
+//----------------------------------------------------------------
+//
+//     -- Listener --
+//
+//----------------------------------------------------------------
+
+class BenchListener : public ICore
+{
+public:
+    BenchListener() : m_stopCount(0), m_childCount(0) {};
+
+    void ICore_onStopped(StopReason reason, QString path, int lineNo)
+        { Q_UNUSED(reason); Q_UNUSED(path); Q_UNUSED(lineNo); m_stopCount++; };
+    void ICore_onStateChanged(TargetState state) { Q_UNUSED(state); };
+    void ICore_onSignalReceived(QString signalName) { Q_UNUSED(signalName); };
+    void ICore_onLocalVarChanged(QStringList varNames) { Q_UNUSED(varNames); };
+    void ICore_onFrameVarReset() {};
+    void ICore_onFrameVarChanged(QString name, QString value) { Q_UNUSED(name); Q_UNUSED(value); };
+    void ICore_onWatchVarChanged(VarWatch &watch) { Q_UNUSED(watch); };
+    void ICore_onWatchVarDeleted(VarWatch &watch) { Q_UNUSED(watch); };
+    void ICore_onConsoleStream(QString text) { Q_UNUSED(text); };
+    void ICore_onLogPointOutput(QString text) { Q_UNUSED(text); };
+    void ICore_onSampleStopped() {};
+    void ICore_onBreakpointsChanged() {};
+    void ICore_onThreadListChanged() {};
+    void ICore_onThreadCreated(int threadId) { Q_UNUSED(threadId); };
+    void ICore_onThreadExited(int threadId) { Q_UNUSED(threadId); };
+    void ICore_onThreadDetailsChanged(int threadId) { Q_UNUSED(threadId); };
+    void ICore_onThreadDetailsInvalidated() {};
+    void ICore_onCurrentThreadChanged(int threadId) { Q_UNUSED(threadId); };
+    void ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList) { Q_UNUSED(stackFrameList); };
+    void ICore_onStackFramesLoaded(QList<StackFrameEntry> stackFrameList) { Q_UNUSED(stackFrameList); };
+    void ICore_onMessage(QString message) { Q_UNUSED(message); };
+    void ICore_onTargetOutput(QString message) { Q_UNUSED(message); };
+    void ICore_onCurrentFrameChanged(int frameIdx) { Q_UNUSED(frameIdx); };
+    void ICore_onSourceFileListChanged() {};
+    void ICore_onLibrariesChanged() {};
+    void ICore_onReady(int readyTime) { Q_UNUSED(readyTime); };
+    void ICore_onWatchVarChildAdded(VarWatch &watch) { Q_UNUSED(watch); m_childCount++; };
+
+    int m_stopCount;
+    int m_childCount;
+};
+
+
+//----------------------------------------------------------------
+//
+//     -- Transcript generation --
+//
+//----------------------------------------------------------------
+
+class TranscriptWriter
+{
+public:
+    TranscriptWriter(QString filename) : m_file(filename) {};
+
+    bool open() { return m_file.open(QIODevice::Truncate | QIODevice::WriteOnly); };
+    void command(QString text) { m_file.write(("00.000|<< " + text + "\n").toUtf8()); };
+    void output(QString text) { m_file.write(("00.000|>> " + text + "\n").toUtf8()); };
+
+private:
+    QFile m_file;
+};
+
+
+static QString frameString(int level)
+{
+    return QString("{level=\"%1\",addr=\"0x%2\",func=\"func%1\",args=[],file=\"src/file%1.c\",fullname=\"/bench/src/file%1.c\",line=\"%3\"}")
+                .arg(level).arg(0x400000+level*16, 0, 16).arg(10+level);
+}
+
+
+static QString stoppedString(QString reason)
+{
+    return QString("*stopped,reason=\"%1\",disp=\"keep\",bkptno=\"1\",frame=%2,thread-id=\"1\",stopped-threads=\"all\",core=\"0\"")
+                .arg(reason).arg(frameString(0));
+}
+
+
+/**
+ * @brief Writes a transcript with the responses needed by the benchmark operations.
+ * @return 0 on success.
+ */
+static int generateTranscript(QString filename, int fileCount, int frameCount, int childCount)
+{
+    TranscriptWriter w(filename);
+    if(!w.open())
+        return 1;
+
+    w.output("=thread-group-added,id=\"i1\"");
+    w.output("(gdb) ");
+
+    w.command("-inferior-tty-set /dev/pts/0");
+    w.output("^done");
+    w.output("(gdb) ");
+
+    w.command("-file-exec-and-symbols benchapp");
+    w.output("^done");
+    w.output("(gdb) ");
+
+    w.command("-data-evaluate-expression \"sizeof(void *)\"");
+    w.output("^done,value=\"8\"");
+    w.output("(gdb) ");
+
+    w.command("-break-insert -f main");
+    w.output("^done,bkpt={number=\"1\",type=\"breakpoint\",disp=\"keep\",enabled=\"y\",addr=\"0x400000\",func=\"main\",file=\"src/file0.c\",fullname=\"/bench/src/file0.c\",line=\"10\",thread-groups=[\"i1\"],times=\"0\"}");
+    w.output("(gdb) ");
+
+    // A big source file list
+    QString files = "^done,files=[";
+    for(int i = 0;i < fileCount;i++)
+    {
+        if(i > 0)
+            files += ",";
+        files += QString("{file=\"src/file%1.c\",fullname=\"/bench/src/file%1.c\"}").arg(i);
+    }
+    files += "]";
+    w.command("-file-list-exec-source-files");
+    w.output(files);
+    w.output("(gdb) ");
+
+    // Run to a breakpoint
+    w.command("-exec-run");
+    w.output("=thread-group-started,id=\"i1\",pid=\"4242\"");
+    w.output("=thread-created,id=\"1\",group-id=\"i1\"");
+    w.output("^running");
+    w.output("*running,thread-id=\"all\"");
+    w.output("(gdb) ");
+    w.output(stoppedString("breakpoint-hit"));
+    w.output("(gdb) ");
+
+    w.command("-exec-next");
+    w.output("^running");
+    w.output("*running,thread-id=\"all\"");
+    w.output("(gdb) ");
+    w.output(stoppedString("end-stepping-range"));
+    w.output("(gdb) ");
+
+    w.command("-list-thread-groups");
+    w.output("^done,groups=[{id=\"i1\",type=\"process\",pid=\"4242\",executable=\"/bench/benchapp\"}]");
+    w.output("(gdb) ");
+
+    w.command("-thread-info");
+    w.output("^done,threads=[{id=\"1\",target-id=\"process 4242\",name=\"benchapp\",frame=" + frameString(0) + ",state=\"stopped\",core=\"0\"}],current-thread-id=\"1\"");
+    w.output("(gdb) ");
+
+    w.command("-var-update --all-values *");
+    w.output("^done,changelist=[]");
+    w.output("(gdb) ");
+
+    w.command("-stack-list-variables --no-values");
+    w.output("^done,variables=[{name=\"argc\"},{name=\"argv\"},{name=\"bigArray\"}]");
+    w.output("(gdb) ");
+
+    // The stack
+    w.command(QString("-stack-info-depth %1").arg(STACK_MAX_DEPTH));
+    w.output(QString("^done,depth=\"%1\"").arg(frameCount));
+    w.output("(gdb) ");
+
+    QString stack = "^done,stack=[";
+    for(int i = 0;i < std::min(frameCount, STACK_PAGE_SIZE);i++)
+    {
+        if(i > 0)
+            stack += ",";
+        stack += "frame=" + frameString(i);
+    }
+    stack += "]";
+    w.command(QString("-stack-list-frames 0 %1").arg(std::min(frameCount, STACK_PAGE_SIZE)-1));
+    w.output(stack);
+    w.output("(gdb) ");
+
+    // A watch with many children
+    w.command("-var-create w10 @ bigArray");
+    w.output(QString("^done,name=\"w10\",numchild=\"%1\",value=\"[%1]\",type=\"int [%1]\",has_more=\"0\"").arg(childCount));
+    w.output("(gdb) ");
+
+    QString children = QString("^done,numchild=\"%1\",children=[").arg(childCount);
+    for(int i = 0;i < childCount;i++)
+    {
+        if(i > 0)
+            children += ",";
+        children += QString("child={name=\"w10.%1\",exp=\"%1\",numchild=\"0\",value=\"%2\",type=\"int\"}").arg(i).arg(i*3);
+    }
+    children += "],has_more=\"0\"";
+    w.command("-var-list-children --simple-values w10");
+    w.output(children);
+    w.output("(gdb) ");
+
+    w.command("-var-delete w10");
+    w.output("^done,ndeleted=\"1\"");
+    w.output("(gdb) ");
+
+    return 0;
+}
+
+
+//----------------------------------------------------------------
+//
+//     -- Benchmark --
+//
+//----------------------------------------------------------------
+
+/**
+ * @brief The measurements of one operation.
+ */
+class OpStats
+{
+public:
+    OpStats(QString name) : m_name(name), m_allocCount(0), m_allocBytes(0) {};
+
+    QString m_name;
+    QVector<qint64> m_timesNs;
+    unsigned long long m_allocCount;
+    unsigned long long m_allocBytes;
+};
+
+
+static BenchListener g_listener;
+
+
+/**
+ * @brief Processes events until the target has stopped.
+ */
+static void waitForStop(int stopCountBefore)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(g_listener.m_stopCount == stopCountBefore && timer.elapsed() < 5000)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    if(g_listener.m_stopCount == stopCountBefore)
+        errorMsg("Timeout waiting for the target to stop");
+}
+
+
+enum OpType { OP_RUN, OP_STEP, OP_STACK, OP_FILES, OP_ADD_WATCH, OP_EXPAND_WATCH, OP_REMOVE_WATCH, OP_COUNT };
+
+static const char *g_opNames[OP_COUNT] = {"run+stop", "step", "stack", "source-files", "add-watch", "expand-watch", "remove-watch"};
+
+
+static void runOp(OpType op, VarWatch **watch)
+{
+    Core &core = Core::getInstance();
+    int stopCount = g_listener.m_stopCount;
+
+    switch(op)
+    {
+        case OP_RUN:
+            core.gdbRun();
+            waitForStop(stopCount);
+            break;
+        case OP_STEP:
+            core.gdbNext();
+            waitForStop(stopCount);
+            break;
+        case OP_STACK:
+            core.getStackFrames();
+            break;
+        case OP_FILES:
+            core.gdbGetFiles();
+            break;
+        case OP_ADD_WATCH:
+            core.gdbAddVarWatch("bigArray", watch);
+            break;
+        case OP_EXPAND_WATCH:
+            if(*watch)
+                core.gdbExpandVarWatchChildren((*watch)->getWatchId());
+            break;
+        case OP_REMOVE_WATCH:
+            if(*watch)
+                core.gdbRemoveVarWatch((*watch)->getWatchId());
+            *watch = NULL;
+            break;
+        default:
+            break;
+    };
+}
+
+
+static void printReport(QList<OpStats> &statsList)
+{
+    printf("%-14s %8s %10s %10s %10s %10s %12s %12s\n",
+            "operation", "count", "avg[us]", "min[us]", "p95[us]", "max[us]", "allocs/op", "bytes/op");
+    for(int i = 0;i < statsList.size();i++)
+    {
+        OpStats &stats = statsList[i];
+        QVector<qint64> times = stats.m_timesNs;
+        if(times.isEmpty())
+            continue;
+        std::sort(times.begin(), times.end());
+        qint64 total = 0;
+        for(int j = 0;j < times.size();j++)
+            total += times[j];
+        int count = times.size();
+        printf("%-14s %8d %10.1f %10.1f %10.1f %10.1f %12llu %12llu\n",
+                stringToCStr(stats.m_name), count,
+                total/1000.0/count,
+                times.first()/1000.0,
+                times[(count*95)/100 < count ? (count*95)/100 : count-1]/1000.0,
+                times.last()/1000.0,
+                stats.m_allocCount/count,
+                stats.m_allocBytes/count);
+    }
+}
+
+
+//----------------------------------------------------------------
+//
+//     -- Value decoding --
+//
+//----------------------------------------------------------------
+
+// Typical values from -var-update changelists
+static const char *g_sampleValues[] =
+{
+    "0", "1", "42", "-17", "1024", "4294967295", "0x0", "0x7ffe3b2c",
+    "0x601040 <global_var>", "0x400526 <main+4>", "97 'a'", "0 '\\000'",
+    "3.1400000000000001", "-2.5e-07", "RED", "true", "false",
+    "0x4006f4 \"hello\"", "{x = 1, y = 2}", "{...}", "[3]",
+    NULL
+};
+
+
+/**
+ * @brief Finds the value="..." fields in the GDB output lines of a transcript.
+ */
+static int extractValues(QString filename, QStringList *values)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly))
+        return 1;
+
+    while(!file.atEnd())
+    {
+        QByteArray line = file.readLine();
+        if(line.indexOf(">> ") == -1)
+            continue;
+
+        int pos = 0;
+        while((pos = line.indexOf("value=\"", pos)) != -1)
+        {
+            QByteArray value;
+            for(pos += 7;pos < line.size() && line[pos] != '"';pos++)
+            {
+                char c = line[pos];
+                if(c == '\\' && pos+1 < line.size())
+                {
+                    c = line[++pos];
+                    if(c == 'n')
+                        c = '\n';
+                    else if(c == 't')
+                        c = '\t';
+                }
+                value += c;
+            }
+            values->append(QString::fromUtf8(value));
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Decodes a value the way it was done before the scalar fast path.
+ */
+static void decodeWithTokenizer(CoreVar *var, QString data)
+{
+    QList<Token*> tokenList = GdbMiParser::tokenizeVarString(data);
+    QList<Token*> orgList = tokenList;
+
+    GdbMiParser::parseVariableData(var, &tokenList);
+
+    for(int i = 0;i < orgList.size();i++)
+        delete orgList[i];
+}
+
+
+static void printDecodeStats(const char *name, int valueCount, int passes, qint64 timeNs,
+                             unsigned long long allocCount, unsigned long long allocBytes)
+{
+    double total = (double)valueCount*passes;
+    printf("%-14s %12.1f %14.2f %14.1f\n", name, timeNs/total, allocCount/total, allocBytes/total);
+}
+
+
+/**
+ * @brief Benchmarks CoreVar::valueFromGdbString() against the general tokenizer.
+ * @return 0 if both decoded all values the same way.
+ */
+static int runDecodeBench(QStringList values, int passes)
+{
+    int rc = 0;
+    int scalarCount = 0;
+
+    // Check that the fast path gives the same result
+    for(int i = 0;i < values.size();i++)
+    {
+        CoreVar fast;
+        CoreVar slow;
+        if(GdbMiParser::parseScalarValue(&fast, values[i]))
+            scalarCount++;
+        else
+            fast.valueFromGdbString(values[i]);
+        decodeWithTokenizer(&slow, values[i]);
+
+        if(fast.getData(CoreVar::FMT_NATIVE) != slow.getData(CoreVar::FMT_NATIVE) ||
+            fast.hasPointerAddress() != slow.hasPointerAddress() ||
+            fast.getPointerAddress() != slow.getPointerAddress())
+        {
+            errorMsg("Value '%s' decoded as '%s' instead of '%s'", stringToCStr(values[i]),
+                    stringToCStr(fast.getData(CoreVar::FMT_NATIVE)),
+                    stringToCStr(slow.getData(CoreVar::FMT_NATIVE)));
+            rc = 1;
+        }
+    }
+
+    printf("values: %d (%.1f%% scalars)\n", values.size(),
+            values.isEmpty() ? 0.0 : scalarCount*100.0/values.size());
+    printf("%-14s %12s %14s %14s\n", "decoder", "ns/value", "allocs/value", "bytes/value");
+
+    CoreVar var;
+    QElapsedTimer timer;
+
+    unsigned long long allocCount = g_allocCount;
+    unsigned long long allocBytes = g_allocBytes;
+    timer.start();
+    for(int p = 0;p < passes;p++)
+    {
+        for(int i = 0;i < values.size();i++)
+            var.valueFromGdbString(values[i]);
+    }
+    printDecodeStats("fast path", values.size(), passes, timer.nsecsElapsed(),
+                     g_allocCount - allocCount, g_allocBytes - allocBytes);
+
+    allocCount = g_allocCount;
+    allocBytes = g_allocBytes;
+    timer.restart();
+    for(int p = 0;p < passes;p++)
+    {
+        for(int i = 0;i < values.size();i++)
+            decodeWithTokenizer(&var, values[i]);
+    }
+    printDecodeStats("tokenizer", values.size(), passes, timer.nsecsElapsed(),
+                     g_allocCount - allocCount, g_allocBytes - allocBytes);
+
+    return rc;
+}
+
+
+static int dumpUsage()
+{
+    printf("Usage: mibench [OPTIONS]\n");
+    printf("\n");
+    printf("Where OPTIONS are:\n");
+    printf("  --mode mi|decode      Run MI operations against fakegdb (default) or decode the\n");
+    printf("                        variable values in the transcript.\n");
+    printf("  --fakegdb PATH        Path to the fakegdb executable (default ../fakegdb/fakegdb).\n");
+    printf("  --transcript FILE     Replay a recorded gede_gdb_log.txt instead of a generated one.\n");
+    printf("  --iterations N        Number of times to run each operation (default 100).\n");
+    printf("                        In decode mode, the number of passes over the values.\n");
+    printf("  --files N             Number of source files in the generated transcript (default 5000).\n");
+    printf("  --frames N            Depth of the stack in the generated transcript (default 50).\n");
+    printf("  --children N          Number of watch children in the generated transcript (default 200).\n");
+    printf("  --latency-us N        Delay for each response from fakegdb.\n");
+    printf("  --bytes-per-sec N     Output rate of fakegdb.\n");
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QString fakeGdbPath = "../fakegdb/fakegdb";
+    QString transcriptPath;
+    QString mode = "mi";
+    int iterations = 100;
+    int fileCount = 5000;
+    int frameCount = 50;
+    int childCount = 200;
+
+    for(int i = 1;i < argc;i++)
+    {
+        const char *curArg = argv[i];
+        if(i+1 >= argc)
+            return dumpUsage();
+        else if(strcmp(curArg, "--mode") == 0)
+            mode = argv[++i];
+        else if(strcmp(curArg, "--fakegdb") == 0)
+            fakeGdbPath = argv[++i];
+        else if(strcmp(curArg, "--transcript") == 0)
+            transcriptPath = argv[++i];
+        else if(strcmp(curArg, "--iterations") == 0)
+            iterations = std::max(1, atoi(argv[++i]));
+        else if(strcmp(curArg, "--files") == 0)
+            fileCount = atoi(argv[++i]);
+        else if(strcmp(curArg, "--frames") == 0)
+            frameCount = std::max(1, atoi(argv[++i]));
+        else if(strcmp(curArg, "--children") == 0)
+            childCount = atoi(argv[++i]);
+        else if(strcmp(curArg, "--latency-us") == 0)
+            setenv("FAKEGDB_LATENCY_US", argv[++i], 1);
+        else if(strcmp(curArg, "--bytes-per-sec") == 0)
+            setenv("FAKEGDB_BYTES_PER_SEC", argv[++i], 1);
+        else
+            return dumpUsage();
+    }
+
+    if(mode == "decode")
+    {
+        QStringList values;
+        if(transcriptPath.isEmpty())
+        {
+            for(int i = 0;g_sampleValues[i] != NULL;i++)
+                values.append(g_sampleValues[i]);
+        }
+        else if(extractValues(transcriptPath, &values))
+        {
+            errorMsg("Failed to read '%s'", stringToCStr(transcriptPath));
+            return 1;
+        }
+        return runDecodeBench(values, iterations);
+    }
+    else if(mode != "mi")
+        return dumpUsage();
+
+    if(transcriptPath.isEmpty())
+    {
+        transcriptPath = TRANSCRIPT_FILENAME;
+        if(generateTranscript(transcriptPath, fileCount, frameCount, childCount))
+        {
+            errorMsg("Failed to write '%s'", stringToCStr(transcriptPath));
+            return 1;
+        }
+    }
+    setenv("FAKEGDB_TRANSCRIPT", stringToCStr(QDir(transcriptPath).absolutePath()), 1);
+
+    Settings cfg;
+    cfg.m_initialBreakpoint = "main";
+    Core &core = Core::getInstance();
+    core.setListener(&g_listener);
+
+    QElapsedTimer timer;
+    timer.start();
+    if(core.initLocal(&cfg, fakeGdbPath, "benchapp", QStringList()))
+    {
+        errorMsg("Failed to start '%s'", stringToCStr(fakeGdbPath));
+        return 1;
+    }
+    printf("init: %.1f ms\n", timer.nsecsElapsed()/1000000.0);
+
+    QList<OpStats> statsList;
+    for(int op = 0;op < OP_COUNT;op++)
+        statsList.append(OpStats(g_opNames[op]));
+
+    VarWatch *watch = NULL;
+    for(int it = 0;it < iterations;it++)
+    {
+        for(int op = 0;op < OP_COUNT;op++)
+        {
+            OpStats &stats = statsList[op];
+            unsigned long long allocCount = g_allocCount;
+            unsigned long long allocBytes = g_allocBytes;
+
+            timer.restart();
+            runOp((OpType)op, &watch);
+            stats.m_timesNs.append(timer.nsecsElapsed());
+
+            stats.m_allocCount += g_allocCount - allocCount;
+            stats.m_allocBytes += g_allocBytes - allocBytes;
+        }
+    }
+
+    printReport(statsList);
+
+    GdbCom::getInstance().disconnectGdb();
+    
+    return 0;
+}
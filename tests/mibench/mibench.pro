@@ -0,0 +1,34 @@
+
+
+QT +=  core
+QT -= gui
+
+TEMPLATE = app
+
+SOURCES+=mibench.cpp
+
+SOURCES+=../../src/core.cpp ../../src/com.cpp ../../src/tree.cpp ../../src/mirecords.cpp ../../src/gdbmiparser.cpp
+HEADERS+=../../src/core.h ../../src/com.h ../../src/tree.h ../../src/mirecords.h ../../src/gdbmiparser.h
+
+SOURCES+=../../src/tracelog.cpp ../../src/gdblogwriter.cpp
+HEADERS+=../../src/tracelog.h ../../src/gdblogwriter.h
+
+SOURCES+=../../src/log.cpp
+HEADERS+=../../src/log.h
+SOURCES+=../../src/util.cpp ../../src/detectdistro.cpp
+HEADERS+=../../src/util.h  ../../src/detectdistro.h
+SOURCES+=../../src/dwarflinetable.cpp
+HEADERS+=../../src/dwarflinetable.h
+
+SOURCES += ../../src/ini.cpp ../../src/settings.cpp
+HEADERS += ../../src/ini.h ../../src/settings.h
+
+SOURCES+=../common/alloccount.cpp
+HEADERS+=../common/alloccount.h
+
+QMAKE_CXXFLAGS += -I../../src -I../common  -g
+
+
+TARGET=mibench
+
+